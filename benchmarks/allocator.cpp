@@ -0,0 +1,103 @@
+/**
+ * @brief Benchmark of buffers suballocated by a MemoryAllocator against buffers that allocate their own memory.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "benchmark.h"
+#include <random>
+
+namespace
+{
+    constexpr uint32_t MAX_BUFFER_COUNT = 4000;
+    constexpr uint32_t REPETITIONS = 5;
+
+    struct Result
+    {
+        double create_ms;
+        double destroy_ms;
+        uint32_t memory_count;
+    };
+
+    /**
+     * Creates and destroys buffers of the given sizes.
+     * @param allocator Allocator of the buffers. If it is nullptr, every buffer allocates its own memory.
+     * @return Returns the fastest creation and destruction and the number of device memory objects while the buffers
+     * were alive.
+     */
+    Result run(const vka::benchmark::Context& context, vka::MemoryAllocator* allocator, const std::vector<VkDeviceSize>& sizes)
+    {
+        using clock = std::chrono::steady_clock;
+        Result result = { std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), 0 };
+        std::vector<vka::Buffer> buffers;
+        buffers.reserve(sizes.size());
+
+        for (uint32_t i = 0; i < REPETITIONS; i++)
+        {
+            const clock::time_point begin = clock::now();
+            for (const VkDeviceSize size : sizes)
+            {
+                const vka::BufferCreateInfo create_info = {
+                    .pBufferNext = nullptr,
+                    .bufferFlags = 0,
+                    .bufferSize = size,
+                    .bufferUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                    .bufferSharingMode = VK_SHARING_MODE_EXCLUSIVE,
+                    .bufferQueueFamilyIndexCount = 0,
+                    .bufferQueueFamilyIndices = nullptr,
+                    .pMemoryNext = nullptr,
+                    .memoryType = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                    .memoryTypePreferred = 0,
+                    .memoryTypeForbidden = 0,
+                    .memoryAllocator = allocator,
+                    .memoryNonCoherentAtomSize = 0,
+                    .memoryPersistentMap = false,
+                    .memoryTracker = nullptr,
+                    .memoryDebugName = nullptr
+                };
+                buffers.emplace_back(context.device, context.memory_properties, create_info);
+            }
+            const clock::time_point created = clock::now();
+            result.memory_count = allocator != nullptr ? allocator->memory_count() : (uint32_t)buffers.size();
+            buffers.clear();
+            const clock::time_point destroyed = clock::now();
+
+            result.create_ms = std::min(result.create_ms, std::chrono::duration<double, std::milli>(created - begin).count());
+            result.destroy_ms = std::min(result.destroy_ms, std::chrono::duration<double, std::milli>(destroyed - created).count());
+        }
+        return result;
+    }
+}
+
+int main()
+{
+    const vka::benchmark::Context context;
+
+    // Half of the allocation limit is left to the driver and other processes.
+    const uint32_t buffer_count = std::min(MAX_BUFFER_COUNT, context.properties.limits.maxMemoryAllocationCount / 2);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<VkDeviceSize> size(256, 64 * 1024);
+    std::vector<VkDeviceSize> sizes(buffer_count);
+    for (VkDeviceSize& s : sizes)
+        s = size(rng);
+
+    const vka::MemoryAllocatorCreateInfo allocator_create_info = {
+        .physicalDevice = context.physical_device,
+        .device = context.device,
+        .blockSize = 0,
+        .useMemoryBudget = false,
+        .dedicatedThreshold = 0
+    };
+    vka::MemoryAllocator allocator(allocator_create_info);
+
+    std::printf("%u buffers of 256 B to 64 KiB, fastest of %u runs\n\n", buffer_count, REPETITIONS);
+    std::printf("%-18s %14s %14s %14s %14s\n", "path", "create [ms]", "destroy [ms]", "buffers / ms", "memory count");
+    const auto print = [buffer_count](const char* name, const Result& result) {
+        std::printf("%-18s %14.3f %14.3f %14.1f %14u\n", name, result.create_ms, result.destroy_ms, buffer_count / result.create_ms, result.memory_count);
+    };
+    print("vkAllocateMemory", run(context, nullptr, sizes));
+    print("MemoryAllocator", run(context, &allocator, sizes));
+    return 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * @brief Helpers shared by the benchmarks.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+#include <vka/vka.h>
+#include <chrono>
+#include <cstdio>
+
+namespace vka::benchmark
+{
+    /**
+     * Headless vulkan context of a benchmark. It uses the first physical device, a single queue of a family that
+     * supports transfers and a command pool of that family. No layer, extension or feature is enabled.
+     */
+    class Context final
+    {
+    public:
+        VkInstance instance;
+        VkPhysicalDevice physical_device;
+        VkPhysicalDeviceProperties properties;
+        VkPhysicalDeviceMemoryProperties memory_properties;
+        VkDevice device;
+        uint32_t queue_family;
+        VkCommandPool command_pool;
+
+        /**
+         * Creates the instance, the device and the command pool.
+         * @throw std::runtime_error Is thrown, if there is no physical device or creating an object failed.
+         */
+        inline Context();
+
+        /// Destroys the command pool, the device and the instance.
+        inline ~Context();
+
+        // Deleted:
+        Context(const Context&) = delete;
+        Context& operator= (const Context&) = delete;
+
+    private:
+        /// Destroys all objects that have been created.
+        inline void destroy() noexcept;
+    };
+
+    /**
+     * Runs a function multiple times.
+     * @param repetitions Number of runs.
+     * @param func Function to measure.
+     * @return Returns the duration of the fastest run in milliseconds.
+     */
+    template<typename Func>
+    double measure(uint32_t repetitions, Func&& func);
+}
+
+inline vka::benchmark::Context::Context() :
+    instance(VK_NULL_HANDLE),
+    physical_device(VK_NULL_HANDLE),
+    properties{},
+    memory_properties{},
+    device(VK_NULL_HANDLE),
+    queue_family(0),
+    command_pool(VK_NULL_HANDLE)
+{
+    const VkApplicationInfo app_info = {
+        .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+        .pNext = nullptr,
+        .pApplicationName = "vka benchmark",
+        .applicationVersion = 0,
+        .pEngineName = nullptr,
+        .engineVersion = 0,
+        .apiVersion = VK_API_VERSION_1_2
+    };
+    const VkInstanceCreateInfo instance_create_info = {
+        .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .pApplicationInfo = &app_info,
+        .enabledLayerCount = 0,
+        .ppEnabledLayerNames = nullptr,
+        .enabledExtensionCount = 0,
+        .ppEnabledExtensionNames = nullptr
+    };
+    check_result(vkCreateInstance(&instance_create_info, nullptr, &this->instance), "vkCreateInstance");
+
+    // The destructor is not called, if the constructor throws.
+    try
+    {
+        const std::vector<VkPhysicalDevice> physical_devices = vka::device::get(this->instance);
+        if (physical_devices.empty())
+            throw std::runtime_error("No physical device found.");
+        this->physical_device = physical_devices.front();
+        vkGetPhysicalDeviceProperties(this->physical_device, &this->properties);
+        vkGetPhysicalDeviceMemoryProperties(this->physical_device, &this->memory_properties);
+
+        const QueueFamilyRequirements queue_requirements = {
+            .queueFlags = VK_QUEUE_TRANSFER_BIT,
+            .queueCount = 1
+        };
+        this->queue_family = vka::queue::find(vka::queue::properties(this->physical_device), queue_requirements, QueueFamilyPriority::OPTIMAL);
+        if (this->queue_family == NPOS)
+            throw std::runtime_error("No queue family that supports transfers found.");
+
+        constexpr float priority = 1.0f;
+        const VkDeviceQueueCreateInfo queue_create_info = {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .queueFamilyIndex = this->queue_family,
+            .queueCount = 1,
+            .pQueuePriorities = &priority
+        };
+        const VkDeviceCreateInfo device_create_info = {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .queueCreateInfoCount = 1,
+            .pQueueCreateInfos = &queue_create_info,
+            .enabledLayerCount = 0,
+            .ppEnabledLayerNames = nullptr,
+            .enabledExtensionCount = 0,
+            .ppEnabledExtensionNames = nullptr,
+            .pEnabledFeatures = nullptr
+        };
+        check_result(vkCreateDevice(this->physical_device, &device_create_info, nullptr, &this->device), "vkCreateDevice");
+
+        const VkCommandPoolCreateInfo pool_create_info = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .queueFamilyIndex = this->queue_family
+        };
+        check_result(vkCreateCommandPool(this->device, &pool_create_info, nullptr, &this->command_pool), "vkCreateCommandPool");
+    }
+    catch (...)
+    {
+        this->destroy();
+        throw;
+    }
+
+    std::printf("Device: %s\n\n", this->properties.deviceName);
+}
+
+inline vka::benchmark::Context::~Context()
+{
+    this->destroy();
+}
+
+inline void vka::benchmark::Context::destroy() noexcept
+{
+    if (this->device != VK_NULL_HANDLE)
+    {
+        vkDestroyCommandPool(this->device, this->command_pool, nullptr);
+        vkDestroyDevice(this->device, nullptr);
+    }
+    vkDestroyInstance(this->instance, nullptr);
+}
+
+template<typename Func>
+double vka::benchmark::measure(uint32_t repetitions, Func&& func)
+{
+    using clock = std::chrono::steady_clock;
+    double best = std::numeric_limits<double>::max();
+    for (uint32_t i = 0; i < repetitions; i++)
+    {
+        const clock::time_point begin = clock::now();
+        func();
+        const std::chrono::duration<double, std::milli> duration = clock::now() - begin;
+        best = std::min(best, duration.count());
+    }
+    return best;
+}
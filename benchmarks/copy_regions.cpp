@@ -0,0 +1,123 @@
+/**
+ * @brief Benchmark of Buffer::copy_regions() against one Buffer::copy_region() per update.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "benchmark.h"
+#include <random>
+
+namespace
+{
+    constexpr uint32_t UPDATE_COUNT = 10000;
+    constexpr uint32_t ELEMENT_COUNT = 65536;
+    constexpr VkDeviceSize ELEMENT_SIZE = 256;
+    constexpr uint32_t REPETITIONS = 20;
+
+    /**
+     * Creates updates of whole elements, which are staged one after another in the source buffer.
+     * @param run_length Number of neighbouring elements that are updated in a row.
+     */
+    std::vector<VkBufferCopy> make_updates(uint32_t run_length)
+    {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<uint32_t> element(0, ELEMENT_COUNT - run_length);
+        std::vector<VkBufferCopy> updates;
+        updates.reserve(UPDATE_COUNT);
+        while (updates.size() < UPDATE_COUNT)
+        {
+            const uint32_t first = element(rng);
+            for (uint32_t i = 0; i < run_length && updates.size() < UPDATE_COUNT; i++)
+            {
+                const VkDeviceSize src_offset = updates.size() * ELEMENT_SIZE;
+                updates.push_back({ src_offset, (first + i) * ELEMENT_SIZE, ELEMENT_SIZE });
+            }
+        }
+        return updates;
+    }
+
+    vka::Buffer create_buffer(const vka::benchmark::Context& context, VkDeviceSize size)
+    {
+        const vka::BufferCreateInfo create_info = {
+            .pBufferNext = nullptr,
+            .bufferFlags = 0,
+            .bufferSize = size,
+            .bufferUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            .bufferSharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .bufferQueueFamilyIndexCount = 0,
+            .bufferQueueFamilyIndices = nullptr,
+            .pMemoryNext = nullptr,
+            .memoryType = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            .memoryTypePreferred = 0,
+            .memoryTypeForbidden = 0,
+            .memoryAllocator = nullptr,
+            .memoryNonCoherentAtomSize = 0,
+            .memoryPersistentMap = false,
+            .memoryTracker = nullptr,
+            .memoryDebugName = nullptr
+        };
+        return vka::Buffer(context.device, context.memory_properties, create_info);
+    }
+
+    /// Measures the recording of a command buffer, which is reset before every run.
+    template<typename Func>
+    double measure_recording(const vka::benchmark::Context& context, VkCommandBuffer cbo, Func&& record)
+    {
+        constexpr VkCommandBufferBeginInfo begin_info = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .pNext = nullptr,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            .pInheritanceInfo = nullptr
+        };
+        return vka::benchmark::measure(REPETITIONS, [&]() {
+            vka::check_result(vkResetCommandPool(context.device, context.command_pool, 0), "vkResetCommandPool");
+            vka::check_result(vkBeginCommandBuffer(cbo, &begin_info), "vkBeginCommandBuffer");
+            record();
+            vka::check_result(vkEndCommandBuffer(cbo), "vkEndCommandBuffer");
+        });
+    }
+}
+
+int main()
+{
+    const vka::benchmark::Context context;
+    const vka::Buffer src = create_buffer(context, UPDATE_COUNT * ELEMENT_SIZE);
+    vka::Buffer dst = create_buffer(context, ELEMENT_COUNT * ELEMENT_SIZE);
+
+    const VkCommandBufferAllocateInfo cbo_allocate_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .commandPool = context.command_pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+    VkCommandBuffer cbo;
+    vka::check_result(vkAllocateCommandBuffers(context.device, &cbo_allocate_info, &cbo), "vkAllocateCommandBuffers");
+
+    std::printf("%u updates of %llu bytes into %u elements, fastest of %u runs\n\n", UPDATE_COUNT, (unsigned long long)ELEMENT_SIZE, ELEMENT_COUNT, REPETITIONS);
+    std::printf("%-8s %-14s %10s %10s %12s\n", "run", "path", "commands", "regions", "record [ms]");
+
+    // A run length of 1 scatters every update, longer runs update neighbouring elements.
+    for (const uint32_t run_length : { 1u, 4u, 16u })
+    {
+        const std::vector<VkBufferCopy> updates = make_updates(run_length);
+        std::vector<VkBufferCopy> merged = updates;
+        vka::detail::buffer::merge_copies(merged);
+
+        const double single_ms = measure_recording(context, cbo, [&]() {
+            for (const VkBufferCopy& region : updates)
+                dst.copy_region(cbo, src, region);
+        });
+        const double batched_ms = measure_recording(context, cbo, [&]() {
+            dst.copy_regions(cbo, src, (uint32_t)updates.size(), updates.data());
+        });
+
+        std::printf("%-8u %-14s %10u %10u %12.3f\n", run_length, "copy_region", (uint32_t)updates.size(), (uint32_t)updates.size(), single_ms);
+        std::printf("%-8u %-14s %10u %10u %12.3f\n", run_length, "copy_regions", merged.empty() ? 0u : 1u, (uint32_t)merged.size(), batched_ms);
+    }
+
+    vkFreeCommandBuffers(context.device, context.command_pool, 1, &cbo);
+    return 0;
+}
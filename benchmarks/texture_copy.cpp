@@ -0,0 +1,101 @@
+/**
+ * @brief Benchmark of the SIMD component copy and fill kernels against a scalar loop.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "benchmark.h"
+
+namespace
+{
+    constexpr uint64_t PIXEL_COUNT = 3840 * 2160;
+    constexpr uint32_t REPETITIONS = 10;
+
+    /// Scalar loop with a runtime component count, which copies the image like the kernels did before.
+    template<typename T>
+    void copy_scalar(T* dst, const T* src, uint64_t px_count, uint32_t dst_comp, uint32_t img_comp, uint32_t comp_offset) noexcept
+    {
+        const uint32_t rem_comp = dst_comp - comp_offset;
+        for (uint64_t i = 0; i < px_count; i++)
+        {
+            for (uint32_t c = 0; c < img_comp && c < rem_comp; c++)
+                dst[i * dst_comp + comp_offset + c] = src[i * img_comp + c];
+        }
+    }
+
+    template<typename T>
+    void fill_scalar(T* dst, const T* color, uint64_t px_count, uint32_t dst_comp, uint32_t img_comp, uint32_t comp_offset) noexcept
+    {
+        const uint32_t rem_comp = dst_comp - comp_offset;
+        for (uint64_t i = 0; i < px_count; i++)
+        {
+            for (uint32_t c = 0; c < img_comp && c < rem_comp; c++)
+                dst[i * dst_comp + comp_offset + c] = color[c];
+        }
+    }
+
+    /**
+     * Copies or fills the components of a 4K image with the kernel and with the scalar loop, checks that both produce
+     * the same image and prints the throughput of read and written bytes.
+     */
+    template<VkFormat F>
+    void run(const char* name, bool fill, uint32_t img_comp, uint32_t comp_offset)
+    {
+        using T = vka::detail::texture::loader_format_t<F>;
+        constexpr uint32_t dst_comp = vka::format_countof(F);
+        const uint32_t written_comp = std::min(img_comp, dst_comp - comp_offset);
+
+        std::vector<T> src(fill ? 4 : PIXEL_COUNT * img_comp);
+        for (size_t i = 0; i < src.size(); i++)
+            src[i] = static_cast<T>(i * 7 % 251);
+        std::vector<T> dst_kernel(PIXEL_COUNT * dst_comp, T(1));
+        std::vector<T> dst_scalar(PIXEL_COUNT * dst_comp, T(1));
+
+        const double kernel_ms = vka::benchmark::measure(REPETITIONS, [&]() {
+            if (fill)
+                vka::detail::texture::fill_image<F>(dst_kernel.data(), src.data(), PIXEL_COUNT, img_comp, comp_offset);
+            else
+                vka::detail::texture::copy_image<F>(dst_kernel.data(), src.data(), PIXEL_COUNT, img_comp, comp_offset);
+        });
+        const double scalar_ms = vka::benchmark::measure(REPETITIONS, [&]() {
+            if (fill)
+                fill_scalar(dst_scalar.data(), src.data(), PIXEL_COUNT, dst_comp, img_comp, comp_offset);
+            else
+                copy_scalar(dst_scalar.data(), src.data(), PIXEL_COUNT, dst_comp, img_comp, comp_offset);
+        });
+
+        // A fill only reads the color once.
+        const double read_bytes = fill ? 0.0 : (double)PIXEL_COUNT * img_comp * sizeof(T);
+        const double written_bytes = (double)PIXEL_COUNT * written_comp * sizeof(T);
+        const double gigabytes = (read_bytes + written_bytes) * 1e-9;
+        const bool equal = memcmp(dst_kernel.data(), dst_scalar.data(), dst_kernel.size() * sizeof(T)) == 0;
+        std::printf("%-28s %14.2f %14.2f %8s\n", name, gigabytes / (scalar_ms * 1e-3), gigabytes / (kernel_ms * 1e-3), equal ? "yes" : "NO");
+    }
+}
+
+int main()
+{
+#if defined(VKA_AVX2)
+    constexpr const char* isa = "AVX2";
+#elif defined(VKA_SSE4_1)
+    constexpr const char* isa = "SSE4.1";
+#elif defined(VKA_NEON)
+    constexpr const char* isa = "NEON";
+#else
+    constexpr const char* isa = "none";
+#endif
+    std::printf("3840x2160 pixels, SIMD: %s, fastest of %u runs\n\n", isa, REPETITIONS);
+    std::printf("%-28s %14s %14s %8s\n", "case", "loop [GB/s]", "kernel [GB/s]", "equal");
+
+    run<VK_FORMAT_R8G8B8A8_UINT>("u8  copy RGB -> RGBA", false, 3, 0);
+    run<VK_FORMAT_R8G8B8A8_UINT>("u8  copy R -> RGBA.a", false, 1, 3);
+    run<VK_FORMAT_R8G8B8A8_UINT>("u8  fill RGBA.a", true, 1, 3);
+    run<VK_FORMAT_R8G8B8_UINT>("u8  copy RG -> RGB", false, 2, 0);
+    run<VK_FORMAT_R16G16B16A16_UINT>("u16 copy RGB -> RGBA", false, 3, 0);
+    run<VK_FORMAT_R16G16B16A16_UINT>("u16 fill RGBA.a", true, 1, 3);
+    run<VK_FORMAT_R32G32B32A32_SFLOAT>("f32 copy RGB -> RGBA", false, 3, 0);
+    run<VK_FORMAT_R32G32B32A32_SFLOAT>("f32 fill RGBA.a", true, 1, 3);
+    return 0;
+}
@@ -9,11 +9,13 @@
 #include <vka/vka.h>
 
 vka::AttachmentImage::AttachmentImage(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const AttachmentImageCreateInfo& create_info) :
-    m_image(create_attachment(device, properties, create_info)),
-    m_extent(create_info.imageExtent)
-{}
+    m_extent(create_info.imageExtent),
+    m_aliasable(false)
+{
+    this->m_image = create_attachment(device, properties, create_info, this->m_aliasable);
+}
 
-vka::unique_handle<vka::AttachmentImage::Handle> vka::AttachmentImage::create_attachment(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const AttachmentImageCreateInfo& create_info)
+vka::unique_handle<vka::AttachmentImage::Handle> vka::AttachmentImage::create_attachment(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const AttachmentImageCreateInfo& create_info, bool& aliasable)
 {
     // create image
     const VkImageCreateInfo image_ci = {
@@ -27,7 +29,7 @@ vka::unique_handle<vka::AttachmentImage::Handle> vka::AttachmentImage::create_at
         .arrayLayers = 1,
         .samples = create_info.imageSamples,
         .tiling = VK_IMAGE_TILING_OPTIMAL,
-        .usage = create_info.imageUsage,
+        .usage = create_info.imageUsage | (create_info.memoryTransient ? VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT : 0),
         .sharingMode = create_info.imageSharingMode,
         .queueFamilyIndexCount = create_info.imageQueueFamilyIndexCount,
         .pQueueFamilyIndices = create_info.imageQueueFamilyIndices,
@@ -39,19 +41,47 @@ vka::unique_handle<vka::AttachmentImage::Handle> vka::AttachmentImage::create_at
 
     // query memory requirements
     VkMemoryRequirements requirements;
-    vkGetImageMemoryRequirements(device, image, &requirements);
+    VkMemoryDedicatedRequirements dedicated_requirements;
+    memory::get_requirements(device, image, requirements, dedicated_requirements);
 
-    // allocate memory for the image
-    const VkMemoryAllocateInfo memory_ai = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+    // Memory of a dedicated allocation cannot be bound to any other image, therefore transient attachment images
+    // ignore the preference of the driver in order to be aliasable.
+    const bool dedicated = create_info.memoryTransient ?
+        dedicated_requirements.requiresDedicatedAllocation == VK_TRUE :
+        memory::use_dedicated(create_info.memoryAllocator, dedicated_requirements, requirements.size);
+    const VkMemoryDedicatedAllocateInfo dedicated_ai = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
         .pNext = nullptr,
-        .allocationSize = requirements.size,
-        .memoryTypeIndex = memory::find_type_index(properties, requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        .image = image,
+        .buffer = VK_NULL_HANDLE
     };
-    VkDeviceMemory memory;
-    check_result(vkAllocateMemory(device, &memory_ai, nullptr, &memory), ALLOC_MEMORY_FAILED);
-    unique_handle memory_guard(device, memory);
-    check_result(vkBindImageMemory(device, image, memory, 0), BIND_MEMORY_FAILED);
+
+    // Either share the memory of the alias or allocate memory for the image. Shared memory is not owned by the image.
+    unique_handle<detail::memory::Allocation> memory_guard;
+    if (create_info.memoryAlias != nullptr)
+    {
+        const detail::memory::Allocation& alias = create_info.memoryAlias->m_image.get().memory;
+        const bool compatible = create_info.memoryAlias->m_aliasable &&
+            !dedicated &&
+            requirements.size <= alias.size &&
+            alias.offset % requirements.alignment == 0 &&
+            (requirements.memoryTypeBits & (1u << alias.type_index)) != 0;
+        if (!compatible) [[unlikely]]
+            detail::error::throw_invalid_argument(ALIAS_INCOMPATIBLE);
+        check_result(vkBindImageMemory(device, image, alias.memory, alias.offset), BIND_MEMORY_FAILED);
+        aliasable = false;
+    }
+    else
+    {
+        const VkMemoryPropertyFlags pref_flags = create_info.memoryTransient ? VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT : 0;
+        detail::memory::Allocation allocation;
+        check_result(memory::allocate(device, properties, create_info.memoryAllocator, requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, pref_flags, 0, true, dedicated ? &dedicated_ai : nullptr, allocation), ALLOC_MEMORY_FAILED);
+        if (create_info.memoryTracker != nullptr)
+            create_info.memoryTracker->track(MemoryObjectType::ATTACHMENT, create_info.memoryDebugName, dedicated, allocation);
+        memory_guard = unique_handle(device, allocation);
+        check_result(vkBindImageMemory(device, image, allocation.memory, allocation.offset), BIND_MEMORY_FAILED);
+        aliasable = create_info.memoryTransient && !dedicated;
+    }
 
     // create image view from image
     const VkImageViewCreateInfo view_ci = {
@@ -10,6 +10,8 @@
 
 namespace vka
 {
+    class AttachmentImage;
+
     /**
      * Structure specifying the parameters of a newly created attachment image object. Parameters prefixed with
      * <c>image</c> correspond to the parameters of a
@@ -17,6 +19,22 @@ namespace vka
      * Parameters prefixed with <c>view</c> correspond to the parameters of a
      * <a href="https://docs.vulkan.org/refpages/latest/refpages/source/VkImageViewCreateInfo.html">
      * VkImageViewCreateInfo</a>.
+     * - <c>memoryAllocator</c> specifies the allocator from which the memory is suballocated. If it is <c>nullptr</c>,
+     * the attachment image gets its own memory. If the driver prefers a dedicated allocation or the attachment image
+     * exceeds the dedicated threshold of the allocator, the attachment image gets a dedicated allocation.
+     * - <c>memoryTransient</c> specifies whether the attachment image is transient, i.e. its content never leaves
+     * the render pass (e.g. depth or multisampled color attachments). <c>VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT</c>
+     * is added to the usage and lazily allocated memory is preferred. If no lazily allocated memory type is
+     * available, ordinary device-local memory is used. The usage must only contain attachment usages. A transient
+     * attachment image only gets a dedicated allocation, if the driver requires it.
+     * - <c>memoryAlias</c> specifies a transient attachment image whose memory is shared by this attachment image,
+     * can be <c>nullptr</c>. Both attachment images must not be used at the same time and the content is undefined
+     * after switching between them, i.e. they must be transitioned from <c>VK_IMAGE_LAYOUT_UNDEFINED</c>. The alias
+     * must own its memory, must be at least as large as this attachment image and must outlive it.
+     * - <c>memoryTracker</c> specifies the tracker which accounts the memory of the attachment image, can be
+     * <c>nullptr</c>. Attachment images that alias the memory of another one are not tracked.
+     * - <c>memoryDebugName</c> specifies the name of the attachment image in the registry of the tracker, can be
+     * <c>nullptr</c>.
      */
     struct AttachmentImageCreateInfo
     {
@@ -30,6 +48,11 @@ namespace vka
         VkFormat                viewFormat;
         VkComponentMapping      viewComponentMapping;
         VkImageAspectFlags      viewAspectMask;
+        MemoryAllocator*        memoryAllocator;
+        bool                    memoryTransient;
+        const AttachmentImage*  memoryAlias;
+        MemoryTracker*          memoryTracker;
+        const char*             memoryDebugName;
     };
 
     /**
@@ -77,6 +100,8 @@ namespace vka
          * @param device Device with which the attachment image is created.
          * @param properties Memory properties of the physical device.
          * @param create_info Create-info for the attachment image.
+         * @throw std::invalid_argument Is thrown, if the memory of <c>memoryAlias</c> cannot be shared by the
+         * attachment image.
          * @throw std::runtime_error Is thrown, if creating the image, allocating memory for the image, binding the
          * memory to the image or creating the corresponding image view failed.
          */
@@ -97,6 +122,9 @@ namespace vka
         /// @return Returns the vulkan <c>VkImageView</c> handle.
         constexpr VkImageView view() const noexcept;
 
+        /// @return Returns whether the attachment image shares the memory of another attachment image.
+        constexpr bool aliased() const noexcept;
+
         /// Destroys the attachment image. After destroying the attachment image is empty and therefore invalid.
         constexpr void destroy() noexcept;
 
@@ -110,11 +138,13 @@ namespace vka
         static constexpr char ALLOC_MEMORY_FAILED[] = "[vka::AttachmentImage]: Failed to allocate memory.";
         static constexpr char BIND_MEMORY_FAILED[] = "[vka::AttachmentImage]: Failed to bind memory to image.";
         static constexpr char VIEW_CREATE_FAILED[] = "[vka::AttachmentImage]: Failed to create image view.";
+        static constexpr char ALIAS_INCOMPATIBLE[] = "[vka::AttachmentImage]: Memory of the alias cannot be shared.";
 
         unique_handle<Handle> m_image;
         VkExtent2D m_extent;
+        bool m_aliasable;
 
         /// Creates the attachment image.
-        static unique_handle<Handle> create_attachment(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const AttachmentImageCreateInfo& create_info);
+        static unique_handle<Handle> create_attachment(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const AttachmentImageCreateInfo& create_info, bool& aliasable);
     };
 }
@@ -11,7 +11,8 @@
 #include "attachment.h"
 
 constexpr vka::AttachmentImage::AttachmentImage() noexcept :
-    m_extent{ 0, 0 }
+    m_extent{ 0, 0 },
+    m_aliasable(false)
 {}
 
 constexpr vka::AttachmentImage::operator bool() const noexcept
@@ -39,8 +40,14 @@ constexpr VkImageView vka::AttachmentImage::view() const noexcept
     return this->m_image.get().view;
 }
 
+constexpr bool vka::AttachmentImage::aliased() const noexcept
+{
+    return (bool)this->m_image && !this->m_image.get().memory;
+}
+
 constexpr void vka::AttachmentImage::destroy() noexcept
 {
     this->m_image = VK_NULL_HANDLE;
     this->m_extent = { 0, 0 };
+    this->m_aliasable = false;
 }
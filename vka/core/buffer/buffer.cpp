@@ -11,8 +11,93 @@
 vka::Buffer::Buffer(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const BufferCreateInfo& create_info) :
     m_buffer(create_buffer(device, properties, create_info)),
     m_size(create_info.bufferSize),
-    m_map(nullptr)
-{}
+    m_atom_size(create_info.memoryNonCoherentAtomSize),
+    m_map(nullptr),
+    m_memory_flags(0),
+    m_persistent(false)
+{
+    // The allocator might use a different memory type than the one found in the properties, but both have the same
+    // physical device.
+    this->m_memory_flags = properties.memoryTypes[this->m_buffer.get().memory.type_index].propertyFlags;
+    if (this->m_atom_size == 0 && create_info.memoryAllocator != nullptr)
+        this->m_atom_size = create_info.memoryAllocator->non_coherent_atom_size();
+
+    if (create_info.memoryPersistentMap)
+    {
+        this->map();
+        this->m_persistent = true;
+    }
+}
+
+void vka::Buffer::flush(VkDeviceSize offset, VkDeviceSize size)
+{
+    const BufferRange range = { offset, size };
+    this->flush_ranges(1, &range);
+}
+
+void vka::Buffer::flush_ranges(uint32_t range_count, const BufferRange* ranges)
+{
+    if (this->coherent() || range_count == 0)
+        return;
+
+    std::vector<VkMappedMemoryRange> memory_ranges;
+    this->make_ranges(range_count, ranges, memory_ranges);
+    check_result(vkFlushMappedMemoryRanges(this->m_buffer.parent(), static_cast<uint32_t>(memory_ranges.size()), memory_ranges.data()), FLUSH_MEMORY_FAILED);
+}
+
+void vka::Buffer::invalidate(VkDeviceSize offset, VkDeviceSize size)
+{
+    const BufferRange range = { offset, size };
+    this->invalidate_ranges(1, &range);
+}
+
+void vka::Buffer::invalidate_ranges(uint32_t range_count, const BufferRange* ranges)
+{
+    if (this->coherent() || range_count == 0)
+        return;
+
+    std::vector<VkMappedMemoryRange> memory_ranges;
+    this->make_ranges(range_count, ranges, memory_ranges);
+    check_result(vkInvalidateMappedMemoryRanges(this->m_buffer.parent(), static_cast<uint32_t>(memory_ranges.size()), memory_ranges.data()), INVALIDATE_MEMORY_FAILED);
+}
+
+// ReSharper disable once CppMemberFunctionMayBeConst
+void vka::Buffer::copy_regions(VkCommandBuffer cbo, const Buffer& src, uint32_t region_count, const VkBufferCopy* regions)
+{
+    std::vector<VkBufferCopy> merged(regions, regions + region_count);
+    detail::buffer::merge_copies(merged);
+    if (!merged.empty())
+        vkCmdCopyBuffer(cbo, src.m_buffer.get().buffer, this->m_buffer.get().buffer, static_cast<uint32_t>(merged.size()), merged.data());
+}
+
+void vka::Buffer::make_ranges(uint32_t range_count, const BufferRange* ranges, std::vector<VkMappedMemoryRange>& memory_ranges) const
+{
+    const detail::memory::Allocation& allocation = this->m_buffer.get().memory;
+    memory_ranges.reserve(range_count);
+    for (uint32_t i = 0; i < range_count; i++)
+    {
+        const VkDeviceSize size = ranges[i].size == VK_WHOLE_SIZE ? this->m_size - ranges[i].offset : ranges[i].size;
+        memory_ranges.push_back(detail::memory::make_range(allocation, ranges[i].offset, size, this->m_atom_size));
+    }
+
+    // Rounding to the atom size lets neighbouring ranges overlap. Merging them keeps the number of ranges, which the
+    // driver has to process, as small as possible.
+    std::sort(memory_ranges.begin(), memory_ranges.end(), [](const VkMappedMemoryRange& a, const VkMappedMemoryRange& b) { return a.offset < b.offset; });
+    size_t n = 0;
+    for (size_t i = 1; i < memory_ranges.size(); i++)
+    {
+        VkMappedMemoryRange& last = memory_ranges[n];
+        const VkMappedMemoryRange& cur = memory_ranges[i];
+        if (last.size == VK_WHOLE_SIZE || cur.offset <= last.offset + last.size)
+        {
+            if (last.size != VK_WHOLE_SIZE)
+                last.size = cur.size == VK_WHOLE_SIZE ? VK_WHOLE_SIZE : std::max(last.offset + last.size, cur.offset + cur.size) - last.offset;
+        }
+        else
+            memory_ranges[++n] = cur;
+    }
+    memory_ranges.resize(n + 1);
+}
 
 vka::unique_handle<vka::Buffer::Handle> vka::Buffer::create_buffer(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const BufferCreateInfo& create_info)
 {
@@ -34,19 +119,23 @@ vka::unique_handle<vka::Buffer::Handle> vka::Buffer::create_buffer(VkDevice devi
 
     // query memory requirements
     VkMemoryRequirements requirements;
-    vkGetBufferMemoryRequirements(device, buffer, &requirements);
-
-    // allocate memory
-    const VkMemoryAllocateInfo memory_ai = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+    VkMemoryDedicatedRequirements dedicated_requirements;
+    memory::get_requirements(device, buffer, requirements, dedicated_requirements);
+    const bool dedicated = memory::use_dedicated(create_info.memoryAllocator, dedicated_requirements, requirements.size);
+    const VkMemoryDedicatedAllocateInfo dedicated_ai = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
         .pNext = create_info.pMemoryNext,
-        .allocationSize = requirements.size,
-        .memoryTypeIndex = memory::find_type_index(properties, requirements.memoryTypeBits, create_info.memoryType)
+        .image = VK_NULL_HANDLE,
+        .buffer = buffer
     };
-    VkDeviceMemory memory;
-    check_result(vkAllocateMemory(device, &memory_ai, nullptr, &memory), ALLOC_MEMORY_FAILED);
-    unique_handle memory_guard(device, memory);
-    check_result(vkBindBufferMemory(device, buffer, memory, 0), BIND_MEMORY_FAILED);
+
+    // allocate memory
+    detail::memory::Allocation allocation;
+    check_result(memory::allocate(device, properties, create_info.memoryAllocator, requirements, create_info.memoryType, create_info.memoryTypePreferred, create_info.memoryTypeForbidden, false, dedicated ? &dedicated_ai : create_info.pMemoryNext, allocation), ALLOC_MEMORY_FAILED);
+    if (create_info.memoryTracker != nullptr)
+        create_info.memoryTracker->track(MemoryObjectType::BUFFER, create_info.memoryDebugName, dedicated, allocation);
+    unique_handle memory_guard(device, allocation);
+    check_result(vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset), BIND_MEMORY_FAILED);
 
     const Handle handle = { buffer_guard.release(), memory_guard.release() };
     return unique_handle(device, handle);
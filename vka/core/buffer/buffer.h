@@ -17,7 +17,22 @@ namespace vka
      * - <c>pMemoryNext</c> specifies the <c>pNext</c> parameter of a
      * <a href="https://docs.vulkan.org/refpages/latest/refpages/source/VkMemoryAllocateInfo.html">
      * VkMemoryAllocateInfo</a>.
-     * - <c>memoryType</c> specifies the type of memory where the buffer is allocated.
+     * - <c>memoryType</c> specifies the property flags which the memory of the buffer must have.
+     * - <c>memoryTypePreferred</c> specifies property flags which the memory should have, e.g.
+     * <c>VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT</c> for a host-visible buffer which should be placed in device-local memory
+     * where available. Use <c>memory_flags()</c> to query which flags the memory actually has.
+     * - <c>memoryTypeForbidden</c> specifies property flags which the memory must not have.
+     * - <c>memoryAllocator</c> specifies the allocator from which the memory is suballocated. If it is <c>nullptr</c>
+     * or <c>pMemoryNext</c> is not <c>nullptr</c>, the buffer gets its own memory. If the driver prefers a dedicated
+     * allocation or the buffer exceeds the dedicated threshold of the allocator, the buffer gets a dedicated
+     * allocation.
+     * - <c>memoryNonCoherentAtomSize</c> specifies <c>VkPhysicalDeviceLimits::nonCoherentAtomSize</c>, to which flushed
+     * and invalidated ranges are rounded. If it is <c>0</c>, the atom size of <c>memoryAllocator</c> is used. Without
+     * an allocator, the whole memory is flushed or invalidated. It is ignored for host-coherent memory.
+     * - <c>memoryPersistentMap</c> specifies whether the buffer is mapped at creation and stays mapped until it is
+     * destroyed. The memory type must contain <c>VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT</c>.
+     * - <c>memoryTracker</c> specifies the tracker which accounts the memory of the buffer, can be <c>nullptr</c>.
+     * - <c>memoryDebugName</c> specifies the name of the buffer in the registry of the tracker, can be <c>nullptr</c>.
      */
     struct BufferCreateInfo
     {
@@ -30,11 +45,30 @@ namespace vka
         const uint32_t*         bufferQueueFamilyIndices;
         const void*             pMemoryNext;
         VkMemoryPropertyFlags   memoryType;
+        VkMemoryPropertyFlags   memoryTypePreferred;
+        VkMemoryPropertyFlags   memoryTypeForbidden;
+        MemoryAllocator*        memoryAllocator;
+        VkDeviceSize            memoryNonCoherentAtomSize;
+        bool                    memoryPersistentMap;
+        MemoryTracker*          memoryTracker;
+        const char*             memoryDebugName;
+    };
+
+    /**
+     * Region of a buffer that is flushed or invalidated.
+     * - <c>offset</c> -- Offset of the region in bytes.
+     * - <c>size</c> -- Size of the region in bytes or <c>VK_WHOLE_SIZE</c> for the remaining buffer.
+     */
+    struct BufferRange
+    {
+        VkDeviceSize            offset;
+        VkDeviceSize            size;
     };
 
     /**
      * Abstraction to simplify the creation of buffers. Contains the vulkan <c>VkBuffer</c> and the corresponding
-     * <c>VkDeviceMemory</c> handle.
+     * <c>VkDeviceMemory</c> handle. The memory is either owned by the buffer or suballocated from a
+     * <c>MemoryAllocator</c>.
      *
      * <b>Default initialization:</b>\n
      * The default constructor creates an <b>empty</b> buffer. This empty object is invalid and cannot perform any
@@ -46,9 +80,9 @@ namespace vka
      * The initialization constructor creates a valid buffer that can perform any action, if no exception was thrown.
      *
      * <b>Copy behaviour:</b>\n
-     * The copy constructor and operator are deleted. In order to copy a buffer you have to call <c>copy()</c> or
-     * <c>copy_region()</c> which records a copy command for the buffer. This command must then be submitted via a
-     * command buffer to a queue that supports <c>VK_QUEUE_TRANSFER_BIT</c>.
+     * The copy constructor and operator are deleted. In order to copy a buffer you have to call <c>copy()</c>,
+     * <c>copy_region()</c> or <c>copy_regions()</c> which records a copy command for the buffer. This command must then
+     * be submitted via a command buffer to a queue that supports <c>VK_QUEUE_TRANSFER_BIT</c>.
      *
      * <b>Moving behaviour:</b>\n
      * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
@@ -68,8 +102,10 @@ namespace vka
      *
      * <b>Actions:</b>
      * - <b>mapping</b> -- Invoked by <c>map()</c> maps the buffer to a memory region into which the host can write.
-     * Calling <c>unmap()</c> unmaps the buffer again.
-     * - <b>copy</b> -- Invoked by <c>copy()</c> or <c>copy_region()</c> copies a buffer.
+     * Calling <c>unmap()</c> unmaps the buffer again. Persistently mapped buffers stay mapped until they are
+     * destroyed. For memory which is not host-coherent, writes of the host must be made visible by <c>flush()</c> and
+     * writes of the device by <c>invalidate()</c>.
+     * - <b>copy</b> -- Invoked by <c>copy()</c>, <c>copy_region()</c> or <c>copy_regions()</c> copies a buffer.
      * - <b>update</b> -- Invoked by <c>update()</c> or <c>update_region()</c> directly copies memory into a buffer.
      * - <b>fill</b> -- Invoked by <c>fill()</c> or <c>fill_region()</c> fills the buffer with a single value.
      */
@@ -121,6 +157,18 @@ namespace vka
         /// Destroys the buffer. After destroying the buffer is empty and therefore invalid.
         constexpr void destroy() noexcept;
 
+        /**
+         * @return Returns the property flags of the memory type in which the buffer was allocated. They contain at
+         * least the required flags and, if available, the preferred flags.
+         */
+        constexpr VkMemoryPropertyFlags memory_flags() const noexcept;
+
+        /// @return Returns whether the memory of the buffer is host-coherent.
+        constexpr bool coherent() const noexcept;
+
+        /// @return Returns whether the buffer is currently mapped.
+        constexpr bool mapped() const noexcept;
+
         /**
          * Maps the whole buffer.
          * @return Returns a pointer to the memory of the mapped buffer. If the buffer is invalid, the returned pointer
@@ -130,18 +178,60 @@ namespace vka
         constexpr void* map();
 
         /**
-         * Maps a specific region of the buffer.
+         * Maps a specific region of the buffer. The buffer is always mapped as a whole, therefore mapping several
+         * regions one after another returns pointers into the same mapping.
          * @param offset Offset of the region to map.
-         * @param size Size of the region to map.
+         * @param size Size of the region to map or <c>VK_WHOLE_SIZE</c>.
          * @return Returns a pointer to the memory of the mapped buffer region. If the buffer is invalid, the returned
          * pointer is <c>nullptr</c>.
+         * @throw std::out_of_range Is thrown if the region exceeds the buffer.
          * @throw std::runtime_error Is thrown if mapping the buffer failed.
          */
         constexpr void* map(VkDeviceSize offset, VkDeviceSize size);
 
-        /// Unmaps the buffer. If the buffer is invalid, this function does nothing.
+        /// Unmaps the buffer. If the buffer is invalid or persistently mapped, this function does nothing.
         constexpr void unmap() noexcept;
 
+        /**
+         * Makes host writes to a region of the mapped buffer visible to the device. The region is extended to
+         * multiples of the non-coherent atom size. For host-coherent memory, this function does nothing.
+         * @param offset Offset of the region in bytes.
+         * @param size Size of the region in bytes or <c>VK_WHOLE_SIZE</c>.
+         * @throw std::runtime_error Is thrown if flushing failed.
+         * @pre The buffer is mapped.
+         */
+        void flush(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+        /**
+         * Makes host writes to multiple regions of the mapped buffer visible to the device with a single call of
+         * <c>vkFlushMappedMemoryRanges</c>. Overlapping regions are merged after rounding.
+         * @param range_count Number of regions.
+         * @param ranges Regions to flush.
+         * @throw std::runtime_error Is thrown if flushing failed.
+         * @pre The buffer is mapped.
+         */
+        void flush_ranges(uint32_t range_count, const BufferRange* ranges);
+
+        /**
+         * Makes device writes to a region of the mapped buffer visible to the host. The region is extended to
+         * multiples of the non-coherent atom size. For host-coherent memory, this function does nothing.
+         * @param offset Offset of the region in bytes.
+         * @param size Size of the region in bytes or <c>VK_WHOLE_SIZE</c>.
+         * @throw std::runtime_error Is thrown if invalidating failed.
+         * @pre The buffer is mapped.
+         */
+        void invalidate(VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
+        /**
+         * Makes device writes to multiple regions of the mapped buffer visible to the host with a single call of
+         * <c>vkInvalidateMappedMemoryRanges</c>. Overlapping regions are merged after rounding.
+         * @param range_count Number of regions.
+         * @param ranges Regions to invalidate.
+         * @throw std::runtime_error Is thrown if invalidating failed.
+         * @pre The buffer is mapped.
+         */
+        void invalidate_ranges(uint32_t range_count, const BufferRange* ranges);
+
         /**
          * Records the command to copy the whole buffer. For correct usage see the vulkan documentation of
          * <a href="https://docs.vulkan.org/refpages/latest/refpages/source/vkCmdCopyBuffer.html">vkCmdCopyBuffer</a>.
@@ -160,6 +250,20 @@ namespace vka
          */
         inline void copy_region(VkCommandBuffer cbo, const Buffer& src, const VkBufferCopy& region) noexcept;
 
+        /**
+         * Records the command to copy multiple regions of the buffer. Regions which are adjacent or overlapping in both
+         * buffers are merged and all remaining regions are copied by a single command. For correct usage see the
+         * vulkan documentation of
+         * <a href="https://docs.vulkan.org/refpages/latest/refpages/source/vkCmdCopyBuffer.html">vkCmdCopyBuffer</a>.
+         * @param cbo Command buffer in which the copy command is recorded.
+         * @param src Buffer to copy.
+         * @param region_count Number of regions.
+         * @param regions Regions of the buffer to copy. Destination ranges of regions with different source data must
+         * not overlap, because the order in which the regions are copied is not defined.
+         * @throw std::bad_alloc Is thrown, if merging the regions failed.
+         */
+        void copy_regions(VkCommandBuffer cbo, const Buffer& src, uint32_t region_count, const VkBufferCopy* regions);
+
         /**
          * Records the command to update the whole buffer. For correct usage see the vulkan documentation of
          * <a href="https://docs.vulkan.org/refpages/latest/refpages/source/vkCmdUpdateBuffer.html">
@@ -210,18 +314,29 @@ namespace vka
         Buffer& operator= (const Buffer&) = delete;
 
     private:
+        friend class MemoryDefragmenter;
+
         static constexpr const char* BUFFER_CREATE_FAILED = "[vka::Buffer]: Failed to create buffer handle.";
         static constexpr const char* ALLOC_MEMORY_FAILED = "[vka::Buffer]: Failed to allocate memory.";
         static constexpr const char* BIND_MEMORY_FAILED = "[vka::Buffer]: Failed to bind memory to buffer.";
         static constexpr const char* MAP_MEMORY_FAILED = "[vka::Buffer]: Failed to map memory of buffer";
+        static constexpr const char* MAP_OUT_OF_RANGE = "[vka::Buffer]: Mapped region exceeds the buffer.";
+        static constexpr const char* FLUSH_MEMORY_FAILED = "[vka::Buffer]: Failed to flush memory of buffer.";
+        static constexpr const char* INVALIDATE_MEMORY_FAILED = "[vka::Buffer]: Failed to invalidate memory of buffer.";
 
         unique_handle<Handle> m_buffer;
         VkDeviceSize m_size;
+        VkDeviceSize m_atom_size;
         void* m_map;
+        VkMemoryPropertyFlags m_memory_flags;
+        bool m_persistent;
 
         /// Unmaps the memory without resetting the status.
         constexpr void unmap_memory() const noexcept;
 
+        /// Converts regions of the buffer into rounded and merged memory ranges.
+        void make_ranges(uint32_t range_count, const BufferRange* ranges, std::vector<VkMappedMemoryRange>& memory_ranges) const;
+
         /// Creates the buffer and its associated memory.
         static unique_handle<Handle> create_buffer(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const BufferCreateInfo& create_info);
     };
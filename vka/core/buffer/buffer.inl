@@ -12,13 +12,19 @@
 
 constexpr vka::Buffer::Buffer() noexcept :
     m_size(0),
-    m_map(nullptr)
+    m_atom_size(0),
+    m_map(nullptr),
+    m_memory_flags(0),
+    m_persistent(false)
 {}
 
 constexpr vka::Buffer::Buffer(Buffer&& src) noexcept :
     m_buffer(std::move(src.m_buffer)),
     m_size(src.m_size),
-    m_map(src.m_map)
+    m_atom_size(src.m_atom_size),
+    m_map(src.m_map),
+    m_memory_flags(src.m_memory_flags),
+    m_persistent(src.m_persistent)
 {
     src.m_map = nullptr;
 }
@@ -33,7 +39,10 @@ constexpr vka::Buffer& vka::Buffer::operator= (Buffer&& src) noexcept
     this->unmap_memory();
     this->m_buffer = std::move(src.m_buffer);
     this->m_size = src.m_size;
+    this->m_atom_size = src.m_atom_size;
     this->m_map = src.m_map;
+    this->m_memory_flags = src.m_memory_flags;
+    this->m_persistent = src.m_persistent;
     src.m_map = nullptr;
     return *this;
 }
@@ -70,10 +79,27 @@ inline VkDeviceAddress vka::Buffer::device_ptr() const noexcept
 
 constexpr void vka::Buffer::destroy() noexcept
 {
-    this->unmap();
+    this->unmap_memory();
+    this->m_map = nullptr;
+    this->m_persistent = false;
     this->m_buffer = VK_NULL_HANDLE;
 }
 
+constexpr VkMemoryPropertyFlags vka::Buffer::memory_flags() const noexcept
+{
+    return this->m_memory_flags;
+}
+
+constexpr bool vka::Buffer::coherent() const noexcept
+{
+    return (this->m_memory_flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+}
+
+constexpr bool vka::Buffer::mapped() const noexcept
+{
+    return this->m_map != nullptr;
+}
+
 constexpr void* vka::Buffer::map()
 {
     return this->map(0, this->m_size);
@@ -81,21 +107,27 @@ constexpr void* vka::Buffer::map()
 
 constexpr void* vka::Buffer::map(VkDeviceSize offset, VkDeviceSize size)
 {
-    if (!this->m_buffer || this->m_map != nullptr)
-        return this->m_map;
+    if (!this->m_buffer)
+        return nullptr;
+    if (offset > this->m_size || (size != VK_WHOLE_SIZE && size > this->m_size - offset)) [[unlikely]]
+        detail::error::throw_out_of_range(MAP_OUT_OF_RANGE);
 
-    check_result(vkMapMemory(this->m_buffer.parent(), this->m_buffer.get().memory, offset, size, 0, &this->m_map), MAP_MEMORY_FAILED);
-    return this->m_map;
+    // The whole buffer is mapped, so that regions can be mapped in any order.
+    if (this->m_map == nullptr)
+        check_result(detail::memory::map(this->m_buffer.parent(), this->m_buffer.get().memory, 0, VK_WHOLE_SIZE, &this->m_map), MAP_MEMORY_FAILED);
+    return detail::common::add_vp(this->m_map, offset);
 }
 
 constexpr void vka::Buffer::unmap_memory() const noexcept
 {
     if (this->m_map != nullptr)
-        vkUnmapMemory(this->m_buffer.parent(), this->m_buffer.get().memory);
+        detail::memory::unmap(this->m_buffer.parent(), this->m_buffer.get().memory);
 }
 
 constexpr void vka::Buffer::unmap() noexcept
 {
+    if (this->m_persistent)
+        return;
     this->unmap_memory();
     this->m_map = nullptr;
 }
@@ -11,8 +11,11 @@
 #include "error/error.inl"
 #include "handle/handle.h"
 #include "memory/memory.h"
+#include "memory/allocator.inl"
+#include "memory/tracker.inl"
 #include "attachment/attachment.inl"
 #include "buffer/buffer.inl"
+#include "ring_buffer/ring_buffer.inl"
 #include "common/common.inl"
 #include "device/device.h"
 #include "format/format.inl"
@@ -21,7 +24,14 @@
 #include "queue/queue.h"
 #include "shader/shader.inl"
 #include "surface/surface.h"
+#include "sampler_cache/sampler_cache.h"
 #include "texture/texture.h"
+#include "memory/defragmenter.inl"
+#include "upload/upload.inl"
+#include "texture_cache/texture_cache.inl"
+#include "readback/readback.inl"
+#include "streaming/streaming.inl"
+#include "mipmap/mipmap.h"
 #include "descriptor/descriptor.h"
 #ifdef VKA_GLFW_ENABLE
     #include "window/window.inl"
@@ -0,0 +1,160 @@
+#include <vka/vka.h>
+
+vka::DescriptorAllocator::DescriptorAllocator() noexcept :
+    m_device(VK_NULL_HANDLE),
+    m_create_info{},
+    m_current(0),
+    m_observed_sets(0)
+{}
+
+vka::DescriptorAllocator::DescriptorAllocator(VkDevice device, const DescriptorAllocatorCreateInfo& create_info) :
+    m_device(device),
+    m_create_info(create_info),
+    m_current(0),
+    m_observed_sets(0)
+{
+    this->m_create_info.initialSetCount = std::max(create_info.initialSetCount, 1u);
+    this->m_create_info.maxSetCount = std::max(create_info.maxSetCount, this->m_create_info.initialSetCount);
+}
+
+vka::DescriptorAllocator::operator bool() const noexcept
+{
+    return this->m_device != VK_NULL_HANDLE;
+}
+
+VkDevice vka::DescriptorAllocator::parent() const noexcept
+{
+    return this->m_device;
+}
+
+uint32_t vka::DescriptorAllocator::pool_count() const noexcept
+{
+    return (uint32_t)this->m_pools.size();
+}
+
+vka::DescriptorSets vka::DescriptorAllocator::allocate(const DescriptorLayouts& layouts)
+{
+    this->observe(layouts);
+    std::unique_ptr<VkDescriptorSet[]> sets(new VkDescriptorSet[layouts.count()]);
+
+    // Pools before the current one are only revisited in FREE mode, where freed sets return their descriptors.
+    const uint32_t pool_count = (uint32_t)this->m_pools.size();
+    const uint32_t tries = this->m_create_info.mode == DescriptorAllocatorMode::FREE ? pool_count : pool_count - this->m_current;
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    for (uint32_t i = 0; i < tries && pool == VK_NULL_HANDLE; i++)
+    {
+        const uint32_t index = (this->m_current + i) % pool_count;
+        if (this->try_allocate(this->m_pools[index].get(), layouts, sets.get()))
+        {
+            pool = this->m_pools[index].get();
+            this->m_current = index;
+        }
+    }
+
+    // All pools are exhausted, so the allocation continues in a new pool.
+    if (pool == VK_NULL_HANDLE)
+    {
+        this->m_pools.push_back(this->create_pool(layouts));
+        this->m_current = pool_count;
+        pool = this->m_pools.back().get();
+        if (!this->try_allocate(pool, layouts, sets.get())) [[unlikely]]
+            detail::error::throw_runtime_error(MSG_ALLOCATE_FAILED);
+    }
+
+    const detail::descriptor::Parent parent = { this->m_device, pool, this->m_create_info.mode == DescriptorAllocatorMode::FREE };
+    const detail::descriptor::Handle handle = { sets.release(), layouts.count() };
+    return DescriptorSets(unique_handle(parent, handle));
+}
+
+void vka::DescriptorAllocator::reset() noexcept
+{
+    if (this->m_create_info.mode != DescriptorAllocatorMode::RESET)
+        return;
+
+    for (const unique_handle<VkDescriptorPool>& pool : this->m_pools)
+        vkResetDescriptorPool(this->m_device, pool.get(), 0);
+    this->m_current = 0;
+}
+
+void vka::DescriptorAllocator::destroy() noexcept
+{
+    this->m_pools.clear();
+    this->m_observed.clear();
+    this->m_device = VK_NULL_HANDLE;
+    this->m_create_info = {};
+    this->m_current = 0;
+    this->m_observed_sets = 0;
+}
+
+void vka::DescriptorAllocator::observe(const DescriptorLayouts& layouts)
+{
+    if (this->m_observed_sets >= OBSERVED_SET_LIMIT)
+    {
+        for (Observed& observed : this->m_observed)
+            observed.count = (observed.count + 1) / 2;
+        this->m_observed_sets /= 2;
+    }
+
+    for (const VkDescriptorPoolSize& size : layouts.pool_sizes())
+    {
+        const auto it = std::ranges::find(this->m_observed, size.type, &Observed::type);
+        if (it != this->m_observed.end())
+            it->count += size.descriptorCount;
+        else
+            this->m_observed.push_back({ size.type, size.descriptorCount });
+    }
+    this->m_observed_sets += layouts.count();
+}
+
+vka::unique_handle<VkDescriptorPool> vka::DescriptorAllocator::create_pool(const DescriptorLayouts& layouts) const
+{
+    const uint32_t growth = (uint32_t)std::min<size_t>(this->m_pools.size(), 31);
+    const uint64_t grown_count = std::min((uint64_t)this->m_create_info.initialSetCount << growth, (uint64_t)this->m_create_info.maxSetCount);
+    const uint32_t set_count = std::max((uint32_t)grown_count, layouts.count());
+
+    // Every type gets its observed share of descriptors per set, but at least the descriptors of the layouts.
+    const uint64_t observed_sets = std::max<uint64_t>(this->m_observed_sets, 1);
+    std::vector<VkDescriptorPoolSize> sizes;
+    sizes.reserve(this->m_observed.size());
+    for (const Observed& observed : this->m_observed)
+    {
+        const uint64_t count = (observed.count * set_count + observed_sets - 1) / observed_sets;
+        sizes.push_back({ observed.type, (uint32_t)std::min<uint64_t>(count, UINT32_MAX) });
+    }
+    for (const VkDescriptorPoolSize& required : layouts.pool_sizes())
+    {
+        const auto it = std::ranges::find(sizes, required.type, &VkDescriptorPoolSize::type);
+        it->descriptorCount = std::max(it->descriptorCount, required.descriptorCount);
+    }
+
+    VkDescriptorPoolCreateFlags flags = this->m_create_info.poolFlags;
+    if (this->m_create_info.mode == DescriptorAllocatorMode::FREE)
+        flags |= VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    const VkDescriptorPoolCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = flags,
+        .maxSets = set_count,
+        .poolSizeCount = (uint32_t)sizes.size(),
+        .pPoolSizes = sizes.data()
+    };
+    VkDescriptorPool pool;
+    check_result(vkCreateDescriptorPool(this->m_device, &create_info, nullptr, &pool), MSG_POOL_CREATE_FAILED);
+    return unique_handle(this->m_device, pool);
+}
+
+bool vka::DescriptorAllocator::try_allocate(VkDescriptorPool pool, const DescriptorLayouts& layouts, VkDescriptorSet* sets) const
+{
+    const VkDescriptorSetAllocateInfo allocate_info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .descriptorPool = pool,
+        .descriptorSetCount = layouts.count(),
+        .pSetLayouts = layouts.handles()
+    };
+    const VkResult result = vkAllocateDescriptorSets(this->m_device, &allocate_info, sets);
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+        return false;
+    check_result(result, MSG_ALLOCATE_FAILED);
+    return true;
+}
\ No newline at end of file
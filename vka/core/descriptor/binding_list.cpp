@@ -12,6 +12,11 @@ void vka::DescriptorBindingList::push(VkDescriptorType type, VkShaderStageFlags
     this->m_bindings.back().push_back(binding);
 }
 
+void vka::DescriptorBindingList::push(VkDescriptorType type, VkShaderStageFlags stages, const SharedSampler& immutable_sampler)
+{
+    this->push(type, stages, 1, immutable_sampler.data());
+}
+
 void vka::DescriptorBindingList::next_set()
 {
     this->m_bindings.emplace_back();
@@ -1,7 +1,8 @@
 #include <vka/vka.h>
 
 vka::DescriptorLayouts::DescriptorLayouts(VkDevice device, const DescriptorBindingList& bindings, VkDescriptorSetLayoutCreateFlags flags) :
-    m_layouts(create_layouts(device, bindings, flags))
+    m_layouts(create_layouts(device, bindings, flags)),
+    m_pool_sizes(count_descriptors(bindings))
 {}
 
 vka::unique_handle<VkDescriptorSetLayout[]> vka::DescriptorLayouts::create_layouts(VkDevice device, const DescriptorBindingList& bindings, VkDescriptorSetLayoutCreateFlags flags)
@@ -19,4 +20,25 @@ vka::unique_handle<VkDescriptorSetLayout[]> vka::DescriptorLayouts::create_layou
         check_result(vkCreateDescriptorSetLayout(device, &create_info, nullptr, layouts.get() + i), MSG_CREATE_FAILED);
     }
     return layouts;
+}
+
+std::vector<VkDescriptorPoolSize> vka::DescriptorLayouts::count_descriptors(const DescriptorBindingList& bindings)
+{
+    std::vector<VkDescriptorPoolSize> sizes;
+    for (uint32_t i = 0; i < bindings.count(); ++i)
+    {
+        for (uint32_t j = 0; j < bindings.binding_count(i); ++j)
+        {
+            // Pool sizes must not be empty, so bindings without descriptors are skipped.
+            const VkDescriptorSetLayoutBinding& binding = bindings.bindings(i)[j];
+            if (binding.descriptorCount == 0)
+                continue;
+            const auto it = std::ranges::find(sizes, binding.descriptorType, &VkDescriptorPoolSize::type);
+            if (it != sizes.end())
+                it->descriptorCount += binding.descriptorCount;
+            else
+                sizes.push_back({ binding.descriptorType, binding.descriptorCount });
+        }
+    }
+    return sizes;
 }
\ No newline at end of file
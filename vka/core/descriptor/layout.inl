@@ -27,9 +27,15 @@ constexpr const VkDescriptorSetLayout* vka::DescriptorLayouts::handles() const n
     return this->m_layouts.get();
 }
 
+constexpr const std::vector<VkDescriptorPoolSize>& vka::DescriptorLayouts::pool_sizes() const noexcept
+{
+    return this->m_pool_sizes;
+}
+
 constexpr void vka::DescriptorLayouts::destroy() noexcept
 {
     this->m_layouts.destroy();
+    this->m_pool_sizes.clear();
 }
 
 inline vka::DescriptorSets vka::DescriptorLayouts::create_sets(VkDescriptorPool pool) const
@@ -4,6 +4,10 @@ vka::DescriptorSets::DescriptorSets(VkDescriptorPool pool, const DescriptorLayou
     m_sets(create_sets(pool, layouts))
 {}
 
+vka::DescriptorSets::DescriptorSets(unique_handle<Handle>&& sets) noexcept :
+    m_sets(std::move(sets))
+{}
+
 vka::unique_handle<vka::DescriptorSets::Handle> vka::DescriptorSets::create_sets(VkDescriptorPool pool, const DescriptorLayouts& layouts)
 {
     const VkDescriptorSetAllocateInfo allocate_info = {
@@ -16,7 +20,7 @@ vka::unique_handle<vka::DescriptorSets::Handle> vka::DescriptorSets::create_sets
 
     VkDescriptorSet* sets = new VkDescriptorSet[layouts.count()];
     check_result(vkAllocateDescriptorSets(layouts.parent(), &allocate_info, sets), MSG_CREATE_FAILED);
-    const Parent parent = { layouts.parent(), pool };
+    const Parent parent = { layouts.parent(), pool, true };
     const Handle handle = { sets, layouts.count() };
     return unique_handle(parent, handle);
 }
\ No newline at end of file
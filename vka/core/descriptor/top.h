@@ -54,6 +54,16 @@ namespace vka
          */
         void push(VkDescriptorType type, VkShaderStageFlags stages, uint32_t count = 1, const VkSampler* immutable_samplers = nullptr);
 
+        /**
+         * Adds a binding with an immutable sampler of a <c>SamplerCache</c> to the current descriptor set. The binding
+         * index is incremented like for the other overload.
+         * @param type Descriptor type, either <c>VK_DESCRIPTOR_TYPE_SAMPLER</c> or
+         * <c>VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER</c>.
+         * @param stages Shader stages where the current binding is used.
+         * @param immutable_sampler Reference to the sampler, which must be kept alive until the layouts are created.
+         */
+        void push(VkDescriptorType type, VkShaderStageFlags stages, const SharedSampler& immutable_sampler);
+
         /// Increments the descriptor set index by <c>1</c> starting at <c>0</c>.
         void next_set();
 
@@ -156,6 +166,13 @@ namespace vka
         /// @return Returns the vulkan <c>VkDescriptorSetLayout</c> handles.
         constexpr const VkDescriptorSetLayout* handles() const noexcept;
 
+        /**
+         * Contains one entry per descriptor type, whose count is the number of descriptors of that type in one set of
+         * every layout. For inline uniform blocks the count is the size in bytes.
+         * @return Returns the pool sizes required to allocate one set of every layout.
+         */
+        constexpr const std::vector<VkDescriptorPoolSize>& pool_sizes() const noexcept;
+
         /// Destroys the descriptor layouts. After destroying the descriptor layouts are empty and therefore invalid.
         constexpr void destroy() noexcept;
 
@@ -176,9 +193,13 @@ namespace vka
         static constexpr const char* MSG_CREATE_FAILED = "[vka::DescriptorLayouts]: Failed to create descriptor set layout.";
 
         unique_handle<VkDescriptorSetLayout[]> m_layouts;
+        std::vector<VkDescriptorPoolSize> m_pool_sizes;
 
         /// Creates the descriptor set layouts.
         static unique_handle<VkDescriptorSetLayout[]> create_layouts(VkDevice device, const DescriptorBindingList& bindings, VkDescriptorSetLayoutCreateFlags flags);
+
+        /// Sums up the descriptors of all bindings per descriptor type.
+        static std::vector<VkDescriptorPoolSize> count_descriptors(const DescriptorBindingList& bindings);
     };
 
     /**
@@ -231,7 +252,8 @@ namespace vka
         /**
          * For each descriptor layout in <c>layouts</c> one descriptor set is created. The descriptor sets are valid if
          * no exception was thrown.
-         * @param pool Pool from which the descriptor sets are allocated.
+         * @param pool Pool from which the descriptor sets are allocated, created with <c>POOL_FLAGS</c>. A
+         * <c>DescriptorAllocator</c> manages the pools instead.
          * @param layouts Layouts from which the descriptor sets are created.
          */
         explicit DescriptorSets(VkDescriptorPool pool, const DescriptorLayouts& layouts);
@@ -278,14 +300,170 @@ namespace vka
         DescriptorSets& operator= (DescriptorSets&&) = default;
 
     private:
+        friend class DescriptorAllocator;
+
         static constexpr const char* MSG_CREATE_FAILED = "[vka::DescriptorManager]: Failed to allocate descriptor sets.";
 
         unique_handle<Handle> m_sets;
 
+        /// Takes the ownership of descriptor sets allocated by a <c>DescriptorAllocator</c>.
+        explicit DescriptorSets(unique_handle<Handle>&& sets) noexcept;
+
         /// Creates the descriptor sets.
         static unique_handle<Handle> create_sets(VkDescriptorPool pool, const DescriptorLayouts& layouts);
     };
 
+    /**
+     * Specifies how the descriptor sets of a <c>DescriptorAllocator</c> are released.
+     * - <c>FREE</c> -- The pools are created with <c>VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT</c> and every
+     * <c>DescriptorSets</c> object frees its sets, when it is destroyed. For sets with a long or unknown lifetime.
+     * - <c>RESET</c> -- The sets are not freed individually. Instead, all pools are reset at once with
+     * <c>DescriptorAllocator::reset()</c>, which is cheaper and cannot fragment the pools. For sets that live for one
+     * frame, e.g. with one allocator per frame in flight.
+     */
+    enum class DescriptorAllocatorMode
+    {
+        FREE,
+        RESET
+    };
+
+    /**
+     * Structure specifying the parameters of a newly created descriptor allocator.
+     * - <c>mode</c> -- Specifies how the descriptor sets are released.
+     * - <c>poolFlags</c> -- Additional create flags of the pools, e.g.
+     * <c>VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT</c>.
+     * - <c>initialSetCount</c> -- Maximum number of sets of the first pool. A value of <c>0</c> is treated as
+     * <c>1</c>.
+     * - <c>maxSetCount</c> -- Limit of the maximum number of sets of a pool. Every further pool can contain twice as
+     * many sets as the previous one, until this limit is reached. A value less than <c>initialSetCount</c> is treated
+     * as <c>initialSetCount</c>.
+     */
+    struct DescriptorAllocatorCreateInfo
+    {
+        DescriptorAllocatorMode     mode;
+        VkDescriptorPoolCreateFlags poolFlags;
+        uint32_t                    initialSetCount;
+        uint32_t                    maxSetCount;
+    };
+
+    /**
+     * Allocates descriptor sets from a growing list of descriptor pools, instead of a single pool that must be created
+     * large enough for all sets. If a pool is exhausted, the allocation continues in the next pool. If there is none,
+     * a new pool is created. The descriptors of a new pool are distributed by the ratios of the descriptor types that
+     * have been allocated so far, so that the pools fit the layouts which are actually used.
+     * Inline uniform blocks are not supported, as their pools need a separate limit of bindings.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates an <b>empty</b> descriptor allocator. This empty object is invalid and cannot
+     * perform any actions. Calling <c>parent()</c> returns <c>VK_NULL_HANDLE</c>. Calling <c>destroy()</c> does
+     * nothing.
+     *
+     * <b>Initialization:</b>\n
+     * The initialization constructor creates a valid descriptor allocator. The pools are created on demand.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Destroys all pools, which also releases all descriptor sets allocated from them. In <c>FREE</c> mode, all
+     * <c>DescriptorSets</c> allocated from the allocator must have been destroyed before. After destroying the object
+     * is an <b>empty</b> descriptor allocator.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class can be created and used from any thread. However, like descriptor pools, actions must be externally
+     * synchronized. In <c>FREE</c> mode, this also applies to destroying <c>DescriptorSets</c> allocated from it.
+     *
+     * <b>Actions:</b>
+     * - <b>allocating</b> -- Invoked by <c>allocate()</c> allocates descriptor sets and creates a pool, if required.
+     * - <b>resetting</b> -- Invoked by <c>reset()</c> releases all sets of <c>RESET</c> mode allocators.
+     */
+    class DescriptorAllocator final
+    {
+    public:
+        /// Creates an empty descriptor allocator. This descriptor allocator is invalid.
+        DescriptorAllocator() noexcept;
+
+        /**
+         * Creates the descriptor allocator. The descriptor allocator is valid if no exception was thrown.
+         * @param device Device with which the pools are created.
+         * @param create_info Create-info for the descriptor allocator.
+         */
+        explicit DescriptorAllocator(VkDevice device, const DescriptorAllocatorCreateInfo& create_info);
+
+        /// @return Returns whether the descriptor allocator is valid.
+        explicit operator bool() const noexcept;
+
+        /// @return Returns the parent handle.
+        VkDevice parent() const noexcept;
+
+        /// @return Returns the number of pools.
+        uint32_t pool_count() const noexcept;
+
+        /**
+         * For each descriptor layout in <c>layouts</c> one descriptor set is allocated.
+         * @param layouts Layouts from which the descriptor sets are created.
+         * @return Returns the descriptor sets. In <c>RESET</c> mode, they are invalidated by <c>reset()</c> and do
+         * not free their sets, when they are destroyed.
+         * @throw std::runtime_error Is thrown, if creating a pool or allocating the sets failed.
+         */
+        DescriptorSets allocate(const DescriptorLayouts& layouts);
+
+        /**
+         * Resets all pools, which releases all descriptor sets allocated from them. The pools are kept and reused by the
+         * following allocations. Does nothing in <c>FREE</c> mode.
+         * @pre The device does not use any descriptor set of the allocator anymore.
+         */
+        void reset() noexcept;
+
+        /// Destroys the descriptor allocator. After destroying the descriptor allocator is empty and therefore invalid.
+        void destroy() noexcept;
+
+        // default:
+        DescriptorAllocator(DescriptorAllocator&&) = default;
+        ~DescriptorAllocator() = default;
+        DescriptorAllocator& operator= (DescriptorAllocator&&) = default;
+
+    private:
+        static constexpr const char* MSG_POOL_CREATE_FAILED = "[vka::DescriptorAllocator]: Failed to create descriptor pool.";
+        static constexpr const char* MSG_ALLOCATE_FAILED = "[vka::DescriptorAllocator]: Failed to allocate descriptor sets.";
+
+        /// Number of observed sets, after which the observed descriptors are halved to follow changing layouts.
+        static constexpr uint64_t OBSERVED_SET_LIMIT = 1 << 20;
+
+        struct Observed
+        {
+            VkDescriptorType type;
+            uint64_t count;
+        };
+
+        VkDevice m_device;
+        DescriptorAllocatorCreateInfo m_create_info;
+        std::vector<unique_handle<VkDescriptorPool>> m_pools;
+        uint32_t m_current;
+        std::vector<Observed> m_observed;
+        uint64_t m_observed_sets;
+
+        /// Adds the descriptors of the layouts to the observed descriptors. Old observations fade out over time.
+        void observe(const DescriptorLayouts& layouts);
+
+        /// Creates a pool whose descriptors are distributed by the observed ratios and which fits the layouts.
+        unique_handle<VkDescriptorPool> create_pool(const DescriptorLayouts& layouts) const;
+
+        /**
+         * Tries to allocate the descriptor sets from a pool.
+         * @return Returns <c>false</c>, if the pool is exhausted or fragmented.
+         */
+        bool try_allocate(VkDescriptorPool pool, const DescriptorLayouts& layouts, VkDescriptorSet* sets) const;
+    };
+
     /**
      * Operation object used to update descriptor sets.
      *
@@ -0,0 +1,240 @@
+/**
+ * @brief Implementation for the memory allocator.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+vka::MemoryAllocator::MemoryAllocator(const MemoryAllocatorCreateInfo& create_info) :
+    MemoryAllocator()
+{
+    if (create_info.physicalDevice == VK_NULL_HANDLE || create_info.device == VK_NULL_HANDLE) [[unlikely]]
+        detail::error::throw_invalid_argument(MSG_INVALID_DEVICE);
+
+    VkPhysicalDeviceProperties device_properties;
+    vkGetPhysicalDeviceProperties(create_info.physicalDevice, &device_properties);
+    vkGetPhysicalDeviceMemoryProperties(create_info.physicalDevice, &this->m_properties);
+    this->m_granularity = device_properties.limits.bufferImageGranularity;
+    this->m_atom_size = device_properties.limits.nonCoherentAtomSize;
+
+    // Every memory type has a pool for linear and one for optimal resources.
+    const VkDeviceSize block_size = create_info.blockSize == 0 ? DEFAULT_BLOCK_SIZE : create_info.blockSize;
+    this->m_pools = std::make_unique<detail::memory::Pool[]>(2 * this->m_properties.memoryTypeCount);
+    for (uint32_t i = 0; i < 2 * this->m_properties.memoryTypeCount; i++)
+    {
+        const uint32_t type_index = i / 2;
+        const VkDeviceSize heap_size = this->m_properties.memoryHeaps[this->m_properties.memoryTypes[type_index].heapIndex].size;
+        detail::memory::Pool& pool = this->m_pools[i];
+        pool.device = create_info.device;
+        pool.block_size = heap_size / 8 < block_size ? heap_size / 8 : block_size;
+        pool.type_index = type_index;
+        pool.dedicated_count = 0;
+    }
+    this->m_physical_device = create_info.physicalDevice;
+    this->m_device = create_info.device;
+    this->m_use_budget = create_info.useMemoryBudget;
+    this->m_dedicated_threshold = create_info.dedicatedThreshold;
+}
+
+vka::MemoryAllocator::MemoryAllocator(MemoryAllocator&& src) noexcept :
+    m_physical_device(src.m_physical_device),
+    m_device(src.m_device),
+    m_granularity(src.m_granularity),
+    m_atom_size(src.m_atom_size),
+    m_properties(src.m_properties),
+    m_pools(std::move(src.m_pools)),
+    m_use_budget(src.m_use_budget),
+    m_dedicated_threshold(src.m_dedicated_threshold)
+{
+    src.m_device = VK_NULL_HANDLE;
+}
+
+vka::MemoryAllocator::~MemoryAllocator()
+{
+    this->destroy();
+}
+
+vka::MemoryAllocator& vka::MemoryAllocator::operator= (MemoryAllocator&& src) noexcept
+{
+    this->destroy();
+    this->m_physical_device = src.m_physical_device;
+    this->m_device = src.m_device;
+    this->m_granularity = src.m_granularity;
+    this->m_atom_size = src.m_atom_size;
+    this->m_properties = src.m_properties;
+    this->m_pools = std::move(src.m_pools);
+    this->m_use_budget = src.m_use_budget;
+    this->m_dedicated_threshold = src.m_dedicated_threshold;
+    src.m_device = VK_NULL_HANDLE;
+    return *this;
+}
+
+uint32_t vka::MemoryAllocator::memory_count() const noexcept
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; this->m_pools != nullptr && i < 2 * this->m_properties.memoryTypeCount; i++)
+    {
+        std::lock_guard lock(this->m_pools[i].mutex);
+        count += static_cast<uint32_t>(this->m_pools[i].blocks.size()) + this->m_pools[i].dedicated_count;
+    }
+    return count;
+}
+
+uint32_t vka::MemoryAllocator::allocation_count() const noexcept
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; this->m_pools != nullptr && i < 2 * this->m_properties.memoryTypeCount; i++)
+    {
+        std::lock_guard lock(this->m_pools[i].mutex);
+        count += this->m_pools[i].dedicated_count;
+        for (const std::unique_ptr<detail::memory::Block>& block : this->m_pools[i].blocks)
+            count += block->allocation_count();
+    }
+    return count;
+}
+
+void vka::MemoryAllocator::destroy() noexcept
+{
+    if (this->m_pools == nullptr)
+        return;
+
+    for (uint32_t i = 0; i < 2 * this->m_properties.memoryTypeCount; i++)
+    {
+        for (const std::unique_ptr<detail::memory::Block>& block : this->m_pools[i].blocks)
+            vkFreeMemory(this->m_device, block->memory(), nullptr);
+    }
+    this->m_pools.reset();
+    this->m_device = VK_NULL_HANDLE;
+}
+
+void vka::MemoryAllocator::trim() noexcept
+{
+    for (uint32_t i = 0; this->m_pools != nullptr && i < 2 * this->m_properties.memoryTypeCount; i++)
+    {
+        detail::memory::Pool& pool = this->m_pools[i];
+        std::lock_guard lock(pool.mutex);
+        std::erase_if(pool.blocks, [&pool](const std::unique_ptr<detail::memory::Block>& block) {
+            if (!block->empty())
+                return false;
+            vkFreeMemory(pool.device, block->memory(), nullptr);
+            return true;
+        });
+    }
+}
+
+VkResult vka::MemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags req_flags, bool optimal, Allocation& allocation) noexcept
+{
+    return this->allocate(requirements, req_flags, 0, 0, optimal, allocation);
+}
+
+VkResult vka::MemoryAllocator::allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags req_flags, VkMemoryPropertyFlags pref_flags, VkMemoryPropertyFlags forb_flags, bool optimal, Allocation& allocation) noexcept
+{
+    return this->allocate_ranked(requirements, req_flags, pref_flags, forb_flags, optimal, nullptr, allocation);
+}
+
+VkResult vka::MemoryAllocator::allocate_dedicated(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags req_flags, VkMemoryPropertyFlags pref_flags, VkMemoryPropertyFlags forb_flags, bool optimal, const void* next, Allocation& allocation) noexcept
+{
+    return this->allocate_ranked(requirements, req_flags, pref_flags, forb_flags, optimal, next, allocation);
+}
+
+vka::detail::memory::Pool& vka::MemoryAllocator::pool(uint32_t type_index, bool optimal) const noexcept
+{
+    // Linear and optimal resources only need to be separated, if the granularity could place them on the same page.
+    return this->m_pools[2 * type_index + (optimal && this->m_granularity > 1 ? 1 : 0)];
+}
+
+VkResult vka::MemoryAllocator::allocate_ranked(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags req_flags, VkMemoryPropertyFlags pref_flags, VkMemoryPropertyFlags forb_flags, bool optimal, const void* next, Allocation& allocation) noexcept
+{
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget;
+    if (this->m_use_budget)
+        memory::query_budget(this->m_physical_device, budget);
+
+    uint32_t indices[VK_MAX_MEMORY_TYPES];
+    const uint32_t count = memory::rank_type_indices(this->m_properties, requirements.memoryTypeBits, req_flags, pref_flags, forb_flags, this->m_use_budget ? &budget : nullptr, requirements.size, indices);
+
+    // If the heap of a memory type is exhausted, the next memory type in the ranking is tried.
+    VkResult result = VK_ERROR_FEATURE_NOT_PRESENT;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        result = allocate_from(this->pool(indices[i], optimal), requirements, next, allocation);
+        if (result != VK_ERROR_OUT_OF_DEVICE_MEMORY && result != VK_ERROR_OUT_OF_HOST_MEMORY)
+            return result;
+    }
+    return result;
+}
+
+VkResult vka::MemoryAllocator::allocate_from(detail::memory::Pool& pool, const VkMemoryRequirements& requirements, const void* next, Allocation& allocation) noexcept
+{
+    std::lock_guard lock(pool.mutex);
+
+    VkMemoryAllocateInfo memory_ai = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .allocationSize = requirements.size,
+        .memoryTypeIndex = pool.type_index
+    };
+    VkDeviceMemory memory;
+
+    // Large resources would waste most of a block, they get their own memory.
+    if (next != nullptr || requirements.size > pool.block_size / 2)
+    {
+        memory_ai.pNext = next;
+        const VkResult result = vkAllocateMemory(pool.device, &memory_ai, nullptr, &memory);
+        if (result != VK_SUCCESS) [[unlikely]]
+            return result;
+        allocation = { memory, 0, requirements.size, &pool, nullptr, NPOS, pool.type_index, nullptr };
+        pool.dedicated_count++;
+        return VK_SUCCESS;
+    }
+
+    try
+    {
+        for (const std::unique_ptr<detail::memory::Block>& block : pool.blocks)
+        {
+            VkDeviceSize offset;
+            const uint32_t node = block->allocate(requirements.size, requirements.alignment, offset);
+            if (node != NPOS)
+            {
+                allocation = { block->memory(), offset, requirements.size, &pool, block.get(), node, pool.type_index, nullptr };
+                return VK_SUCCESS;
+            }
+        }
+
+        // No block has enough space left. If the preferred block size cannot be allocated, smaller blocks are tried.
+        memory_ai.allocationSize = pool.block_size;
+        VkResult result = vkAllocateMemory(pool.device, &memory_ai, nullptr, &memory);
+        while (result != VK_SUCCESS && memory_ai.allocationSize / 2 >= requirements.size)
+        {
+            memory_ai.allocationSize /= 2;
+            result = vkAllocateMemory(pool.device, &memory_ai, nullptr, &memory);
+        }
+        if (result != VK_SUCCESS) [[unlikely]]
+            return result;
+
+        std::unique_ptr<detail::memory::Block> block;
+        try
+        {
+            block = std::make_unique<detail::memory::Block>(&pool, memory, memory_ai.allocationSize);
+            pool.blocks.push_back(nullptr);
+        }
+        catch (const std::bad_alloc&)
+        {
+            vkFreeMemory(pool.device, memory, nullptr);
+            throw;
+        }
+
+        // The block is empty and its memory is aligned for any resource, so this always succeeds.
+        VkDeviceSize offset;
+        const uint32_t node = block->allocate(requirements.size, requirements.alignment, offset);
+        allocation = { memory, offset, requirements.size, &pool, block.get(), node, pool.type_index, nullptr };
+        pool.blocks.back() = std::move(block);
+        return VK_SUCCESS;
+    }
+    catch (const std::bad_alloc&)
+    {
+        return VK_ERROR_OUT_OF_HOST_MEMORY;
+    }
+}
@@ -0,0 +1,202 @@
+/**
+ * @brief Memory allocator that suballocates device memory.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+namespace vka
+{
+    /**
+     * Structure specifying the parameters of a newly created memory allocator.
+     * - <c>physicalDevice</c> -- Physical device from which the memory properties and limits are queried.
+     * - <c>device</c> -- Device with which the memory is allocated.
+     * - <c>blockSize</c> -- Preferred size of a single memory block. If it is <c>0</c>,
+     * <c>MemoryAllocator::DEFAULT_BLOCK_SIZE</c> is used. Heaps that are smaller than 8 times the block size use an
+     * eighth of their size instead.
+     * - <c>useMemoryBudget</c> -- Specifies whether the budget of the memory heaps is queried before allocating new
+     * device memory. Memory types whose heap would exceed its budget are only used, if there is no other choice. The
+     * device must be created with the <c>VK_EXT_memory_budget</c> extension enabled.
+     * - <c>dedicatedThreshold</c> -- Resources which are at least as large as the threshold get a dedicated allocation
+     * (see <c>VkMemoryDedicatedAllocateInfo</c>) instead of being suballocated. If it is <c>0</c>, only resources for
+     * which the driver prefers or requires a dedicated allocation get one.
+     */
+    struct MemoryAllocatorCreateInfo
+    {
+        VkPhysicalDevice    physicalDevice;
+        VkDevice            device;
+        VkDeviceSize        blockSize;
+        bool                useMemoryBudget;
+        VkDeviceSize        dedicatedThreshold;
+    };
+
+    /**
+     * Suballocates buffers and images from large blocks of device memory instead of allocating memory for every single
+     * resource. Each memory type has its own blocks. Resources are placed with a two-level segregated-fit (TLSF)
+     * strategy which honors the alignment of the resource. Linear resources (buffers) and optimal resources (images)
+     * are placed in separate blocks, if the device has a <c>bufferImageGranularity</c> larger than 1. Resources larger
+     * than half a block get their own memory.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates an <b>empty</b> allocator. This empty object is invalid and cannot allocate
+     * memory. Calling <c>parent()</c> returns <c>VK_NULL_HANDLE</c>. Calling <c>destroy()</c> does nothing.
+     *
+     * <b>Initialization:</b>\n
+     * The initialization constructor creates a valid allocator. Device memory is allocated lazily, when the first
+     * resource of a memory type is allocated.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed. Resources allocated from the moved allocator stay valid.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Frees all memory blocks and sets everything back to default values. After destroying the object is an
+     * <b>empty</b> allocator. All resources allocated from the allocator must be destroyed before.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * Allocating and freeing memory is internally synchronized per memory type. Therefore, resources that use the
+     * allocator can be created and destroyed from any thread. Destroying the allocator must be externally synchronized.
+     *
+     * <b>Actions:</b>
+     * - <b>allocation</b> -- Invoked by <c>allocate()</c>. Usually, this is done by the resources themselves (see
+     * <c>BufferCreateInfo</c>, <c>TextureCreateInfo</c> and <c>AttachmentImageCreateInfo</c>).
+     */
+    class MemoryAllocator final
+    {
+    public:
+        using Allocation = detail::memory::Allocation;
+
+        /// Default size of a memory block.
+        static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 256ull * 1024 * 1024;
+
+        /// Creates an empty allocator. This allocator is invalid.
+        constexpr MemoryAllocator() noexcept;
+
+        /**
+         * Creates the allocator. The allocator is valid if no exception was thrown.
+         * @param create_info Create-info for the allocator.
+         * @throw std::invalid_argument Is thrown, if the physical device or the device is <c>VK_NULL_HANDLE</c>.
+         */
+        explicit MemoryAllocator(const MemoryAllocatorCreateInfo& create_info);
+
+        /// Moves an allocator. The source allocator becomes invalidated and using to results in undefined behaviour.
+        MemoryAllocator(MemoryAllocator&& src) noexcept;
+
+        /// Frees all memory blocks.
+        ~MemoryAllocator();
+
+        /**
+         * Moves an allocator. The source allocator becomes invalidated and using to results in undefined behaviour. An
+         * already created allocator is destroyed.
+         */
+        MemoryAllocator& operator= (MemoryAllocator&& src) noexcept;
+
+        /// @return Returns whether the allocator is valid.
+        explicit constexpr operator bool() const noexcept;
+
+        /// @return Returns the parent handle.
+        constexpr VkDevice parent() const noexcept;
+
+        /// @return Returns the memory properties of the physical device.
+        constexpr const VkPhysicalDeviceMemoryProperties& properties() const noexcept;
+
+        /// @return Returns <c>VkPhysicalDeviceLimits::nonCoherentAtomSize</c> of the physical device.
+        constexpr VkDeviceSize non_coherent_atom_size() const noexcept;
+
+        /// @return Returns the size from which resources get a dedicated allocation, <c>0</c> if there is no threshold.
+        constexpr VkDeviceSize dedicated_threshold() const noexcept;
+
+        /// @return Returns the number of <c>VkDeviceMemory</c> objects owned by the allocator (blocks and dedicated).
+        uint32_t memory_count() const noexcept;
+
+        /// @return Returns the number of allocations that are currently alive.
+        uint32_t allocation_count() const noexcept;
+
+        /// Frees all memory blocks. After destroying the allocator is empty and therefore invalid.
+        void destroy() noexcept;
+
+        /**
+         * Frees all empty memory blocks. Usually, one empty block per memory type is kept, so that allocating and
+         * releasing in a loop does not allocate and free device memory every time.
+         */
+        void trim() noexcept;
+
+        /**
+         * Allocates memory. The best memory type that supports the required flags and has enough memory left is used.
+         * @param requirements Memory requirements of the resource.
+         * @param req_flags Required memory property flags.
+         * @param optimal Specifies whether the memory is used by an image with optimal tiling.
+         * @param allocation Returns the allocated memory, which is freed with <c>vka::detail::memory::free()</c>.
+         * @return Returns <c>VK_SUCCESS</c> on success, <c>VK_ERROR_FEATURE_NOT_PRESENT</c> if no memory type supports
+         * the required flags or the result of the failed <c>vkAllocateMemory</c> call.
+         */
+        VkResult allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags req_flags, bool optimal, Allocation& allocation) noexcept;
+
+        /**
+         * Allocates memory. The memory types are tried in the order of <c>vka::memory::rank_type_indices()</c> until
+         * the allocation succeeds. If the allocator uses the memory budget, the budget is queried first.
+         * @param requirements Memory requirements of the resource.
+         * @param req_flags Required memory property flags.
+         * @param pref_flags Preferred memory property flags.
+         * @param forb_flags Forbidden memory property flags.
+         * @param optimal Specifies whether the memory is used by an image with optimal tiling.
+         * @param allocation Returns the allocated memory, which is freed with <c>vka::detail::memory::free()</c>.
+         * @return Returns <c>VK_SUCCESS</c> on success, <c>VK_ERROR_FEATURE_NOT_PRESENT</c> if no memory type is
+         * suitable or the result of the failed <c>vkAllocateMemory</c> call.
+         */
+        VkResult allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags req_flags, VkMemoryPropertyFlags pref_flags, VkMemoryPropertyFlags forb_flags, bool optimal, Allocation& allocation) noexcept;
+
+        /**
+         * Allocates memory that is not suballocated, e.g. for a <c>VkMemoryDedicatedAllocateInfo</c> or for memory
+         * that is imported or exported. The memory types are ranked like in <c>allocate()</c> and the memory is
+         * counted by <c>memory_count()</c> and <c>allocation_count()</c>.
+         * @param requirements Memory requirements of the resource.
+         * @param req_flags Required memory property flags.
+         * @param pref_flags Preferred memory property flags.
+         * @param forb_flags Forbidden memory property flags.
+         * @param optimal Specifies whether the memory is used by an image with optimal tiling.
+         * @param next Specifies the <c>pNext</c> parameter of the <c>VkMemoryAllocateInfo</c>.
+         * @param allocation Returns the allocated memory, which is freed with <c>vka::detail::memory::free()</c>.
+         * @return Returns <c>VK_SUCCESS</c> on success, <c>VK_ERROR_FEATURE_NOT_PRESENT</c> if no memory type is
+         * suitable or the result of the failed <c>vkAllocateMemory</c> call.
+         */
+        VkResult allocate_dedicated(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags req_flags, VkMemoryPropertyFlags pref_flags, VkMemoryPropertyFlags forb_flags, bool optimal, const void* next, Allocation& allocation) noexcept;
+
+        // deleted
+        MemoryAllocator(const MemoryAllocator&) = delete;
+        MemoryAllocator& operator= (const MemoryAllocator&) = delete;
+
+    private:
+        friend class MemoryDefragmenter;
+
+        static constexpr const char* MSG_INVALID_DEVICE = "[vka::MemoryAllocator]: Physical device and device must not be VK_NULL_HANDLE.";
+
+        VkPhysicalDevice m_physical_device;
+        VkDevice m_device;
+        VkDeviceSize m_granularity;
+        VkDeviceSize m_atom_size;
+        VkPhysicalDeviceMemoryProperties m_properties;
+        std::unique_ptr<detail::memory::Pool[]> m_pools;
+        bool m_use_budget;
+        VkDeviceSize m_dedicated_threshold;
+
+        /// @return Returns the pool for a memory type.
+        detail::memory::Pool& pool(uint32_t type_index, bool optimal) const noexcept;
+
+        /// Ranks the memory types and tries to allocate from their pools, until the allocation succeeds.
+        VkResult allocate_ranked(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags req_flags, VkMemoryPropertyFlags pref_flags, VkMemoryPropertyFlags forb_flags, bool optimal, const void* next, Allocation& allocation) noexcept;
+
+        /// Allocates memory from a pool. Memory with a <c>pNext</c>-chain is always a dedicated allocation.
+        static VkResult allocate_from(detail::memory::Pool& pool, const VkMemoryRequirements& requirements, const void* next, Allocation& allocation) noexcept;
+    };
+}
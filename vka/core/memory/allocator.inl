@@ -0,0 +1,46 @@
+/**
+ * @brief Inline implementation for the memory allocator.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+#include "allocator.h"
+
+constexpr vka::MemoryAllocator::MemoryAllocator() noexcept :
+    m_physical_device(VK_NULL_HANDLE),
+    m_device(VK_NULL_HANDLE),
+    m_granularity(1),
+    m_atom_size(0),
+    m_properties{},
+    m_use_budget(false),
+    m_dedicated_threshold(0)
+{}
+
+constexpr vka::MemoryAllocator::operator bool() const noexcept
+{
+    return this->m_device != VK_NULL_HANDLE;
+}
+
+constexpr VkDevice vka::MemoryAllocator::parent() const noexcept
+{
+    return this->m_device;
+}
+
+constexpr const VkPhysicalDeviceMemoryProperties& vka::MemoryAllocator::properties() const noexcept
+{
+    return this->m_properties;
+}
+
+constexpr VkDeviceSize vka::MemoryAllocator::non_coherent_atom_size() const noexcept
+{
+    return this->m_atom_size;
+}
+
+constexpr VkDeviceSize vka::MemoryAllocator::dedicated_threshold() const noexcept
+{
+    return this->m_dedicated_threshold;
+}
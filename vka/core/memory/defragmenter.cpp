@@ -0,0 +1,431 @@
+/**
+ * @brief Implementation for the memory defragmenter.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+void vka::MemoryDefragmenter::add(Buffer& buffer, const BufferCreateInfo& create_info)
+{
+    this->m_buffers.push_back({
+        .buffer = &buffer,
+        .flags = create_info.bufferFlags,
+        .usage = create_info.bufferUsage,
+        .sharing_mode = create_info.bufferSharingMode,
+        .queue_families = std::vector<uint32_t>(create_info.bufferQueueFamilyIndices, create_info.bufferQueueFamilyIndices + create_info.bufferQueueFamilyIndexCount),
+        .name = create_info.memoryDebugName != nullptr ? create_info.memoryDebugName : ""
+    });
+}
+
+void vka::MemoryDefragmenter::add(Texture& texture, const TextureCreateInfo& create_info)
+{
+    this->m_textures.push_back({
+        .texture = &texture,
+        .flags = Texture::image_flags(create_info.imageFlags, create_info.imageFormat, create_info.imageUsage),
+        .type = create_info.imageType,
+        .format = create_info.imageFormat,
+        .queue_families = std::vector<uint32_t>(create_info.imageQueueFamilyIndices, create_info.imageQueueFamilyIndices + create_info.imageQueueFamilyIndexCount),
+        .views = std::vector<TextureViewCreateInfo>(create_info.views, create_info.views + create_info.viewCount),
+        .name = create_info.memoryDebugName != nullptr ? create_info.memoryDebugName : ""
+    });
+}
+
+void vka::MemoryDefragmenter::remove(const Buffer& buffer) noexcept
+{
+    std::erase_if(this->m_buffers, [&buffer](const BufferEntry& entry) { return entry.buffer == &buffer; });
+}
+
+void vka::MemoryDefragmenter::remove(const Texture& texture) noexcept
+{
+    std::erase_if(this->m_textures, [&texture](const TextureEntry& entry) { return entry.texture == &texture; });
+}
+
+VkDeviceSize vka::MemoryDefragmenter::step(VkCommandBuffer cbo, VkDeviceSize max_bytes)
+{
+    this->m_moved_buffers.clear();
+    this->m_moved_textures.clear();
+    if (this->m_allocator == nullptr || this->m_allocator->m_pools == nullptr)
+        return 0;
+
+    // Every object is moved at most once per step, so that reserving the lists in advance ensures that neither
+    // collecting nor committing the moves can fail after the first handle has been created. The moves are declared
+    // before the pools are locked, because discarding them on failure returns their memory to the pools.
+    Moves moves;
+    moves.buffers.reserve(this->m_buffers.size());
+    moves.buffer_handles.reserve(this->m_buffers.size());
+    moves.textures.reserve(this->m_textures.size());
+    moves.texture_handles.reserve(this->m_textures.size());
+    this->m_retired_buffers.reserve(this->m_retired_buffers.size() + this->m_buffers.size());
+    this->m_retired_textures.reserve(this->m_retired_textures.size() + this->m_textures.size());
+    this->m_moved_buffers.reserve(this->m_buffers.size());
+    this->m_moved_textures.reserve(this->m_textures.size());
+
+    VkDeviceSize moved = 0;
+    for (uint32_t i = 0; i < 2 * this->m_allocator->m_properties.memoryTypeCount && moved < max_bytes; i++)
+    {
+        detail::memory::Pool& pool = this->m_allocator->m_pools[i];
+        std::lock_guard lock(pool.mutex);
+        const detail::memory::Block* source = find_source(pool);
+        if (source == nullptr)
+            continue;
+
+        // Every object is moved at most once per step, because it never moves back into the source block.
+        for (BufferEntry& entry : this->m_buffers)
+        {
+            const detail::memory::Allocation& allocation = entry.buffer->m_buffer.get().memory;
+            if (allocation.block != source || !movable(entry))
+                continue;
+            if (moved > 0 && moved + allocation.size > max_bytes)
+                break;
+
+            const VkDeviceSize size = allocation.size;
+            if (!this->move_buffer(entry, pool, source, moves))
+                break;
+            moved += size;
+        }
+        for (TextureEntry& entry : this->m_textures)
+        {
+            const detail::memory::Allocation& allocation = entry.texture->m_texture.get().memory;
+            if (allocation.block != source)
+                continue;
+            if (moved > 0 && moved + allocation.size > max_bytes)
+                break;
+
+            const VkDeviceSize size = allocation.size;
+            if (!this->move_texture(entry, pool, source, moves))
+                break;
+            moved += size;
+        }
+    }
+
+    if (moved > 0)
+    {
+        record(cbo, moves);
+        this->commit(moves);
+        this->m_step++;
+    }
+    return moved;
+}
+
+void vka::MemoryDefragmenter::release(uint32_t keep) noexcept
+{
+    if (this->m_allocator == nullptr)
+        return;
+
+    // Handles are retired in the order of the steps, so that the released handles are always at the front.
+    const uint64_t last = this->m_step > keep ? this->m_step - keep : 0;
+    std::erase_if(this->m_retired_buffers, [last](const Retired<detail::buffer::Handle>& retired) { return retired.step < last; });
+    std::erase_if(this->m_retired_textures, [last](const Retired<detail::texture::Handle>& retired) { return retired.step < last; });
+    this->m_allocator->trim();
+}
+
+vka::detail::memory::Block* vka::MemoryDefragmenter::find_source(const detail::memory::Pool& pool) noexcept
+{
+    // Empty blocks are neither sources nor targets. Moving into them would only swap the blocks.
+    VkDeviceSize total_free = 0;
+    for (const std::unique_ptr<detail::memory::Block>& block : pool.blocks)
+        total_free += block->empty() ? 0 : block->size() - block->used();
+
+    // The source is the least used block whose allocations fit into the free space of the other blocks. Otherwise,
+    // the block would never become empty and moving its objects would be wasted work.
+    detail::memory::Block* source = nullptr;
+    for (const std::unique_ptr<detail::memory::Block>& block : pool.blocks)
+    {
+        if (block->empty() || total_free - (block->size() - block->used()) < block->used())
+            continue;
+        if (source == nullptr || block->used() < source->used())
+            source = block.get();
+    }
+    return source;
+}
+
+bool vka::MemoryDefragmenter::allocate_target(detail::memory::Pool& pool, const detail::memory::Block* source, const VkMemoryRequirements& requirements, detail::memory::Allocation& allocation)
+{
+    if ((requirements.memoryTypeBits & 1u << pool.type_index) == 0)
+        return false;
+
+    // Filling the most used blocks first leaves the sparsely used blocks for the next steps.
+    std::vector<detail::memory::Block*> targets;
+    targets.reserve(pool.blocks.size());
+    for (const std::unique_ptr<detail::memory::Block>& block : pool.blocks)
+    {
+        if (block.get() != source && !block->empty())
+            targets.push_back(block.get());
+    }
+    std::sort(targets.begin(), targets.end(), [](const detail::memory::Block* a, const detail::memory::Block* b) { return a->used() > b->used(); });
+
+    for (detail::memory::Block* block : targets)
+    {
+        VkDeviceSize offset;
+        const uint32_t node = block->allocate(requirements.size, requirements.alignment, offset);
+        if (node != NPOS)
+        {
+            allocation = { block->memory(), offset, requirements.size, &pool, block, node, pool.type_index, nullptr };
+            return true;
+        }
+    }
+    return false;
+}
+
+bool vka::MemoryDefragmenter::movable(const BufferEntry& entry) noexcept
+{
+    return !entry.buffer->mapped()
+        && (entry.usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT) != 0
+        && (entry.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) == 0;
+}
+
+bool vka::MemoryDefragmenter::move_buffer(BufferEntry& entry, detail::memory::Pool& pool, const detail::memory::Block* source, Moves& moves)
+{
+    const VkDevice device = this->m_allocator->parent();
+    const detail::buffer::Handle old_handle = entry.buffer->m_buffer.get();
+
+    const VkBufferCreateInfo buffer_ci = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = entry.flags,
+        .size = entry.buffer->size(),
+        .usage = entry.usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .sharingMode = entry.sharing_mode,
+        .queueFamilyIndexCount = static_cast<uint32_t>(entry.queue_families.size()),
+        .pQueueFamilyIndices = entry.queue_families.data()
+    };
+    VkBuffer buffer;
+    check_result(vkCreateBuffer(device, &buffer_ci, nullptr, &buffer), BUFFER_CREATE_FAILED);
+    unique_handle buffer_guard(device, buffer);
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(device, buffer, &requirements);
+    detail::memory::Allocation allocation;
+    if (!allocate_target(pool, source, requirements, allocation))
+        return false;
+
+    // The pool is already locked, so the allocation is released directly to its block on failure.
+    const VkResult result = vkBindBufferMemory(device, buffer, allocation.memory, allocation.offset);
+    if (result != VK_SUCCESS) [[unlikely]]
+    {
+        allocation.block->free(allocation.node);
+        check_result(result, BIND_MEMORY_FAILED);
+    }
+    if (old_handle.memory.tracker != nullptr)
+        old_handle.memory.tracker->track(MemoryObjectType::BUFFER, entry.name.c_str(), false, allocation);
+
+    moves.buffers.push_back(entry.buffer);
+    moves.buffer_handles.push_back(unique_handle(device, detail::buffer::Handle{ buffer_guard.release(), allocation }));
+    return true;
+}
+
+bool vka::MemoryDefragmenter::move_texture(TextureEntry& entry, detail::memory::Pool& pool, const detail::memory::Block* source, Moves& moves)
+{
+    const VkDevice device = this->m_allocator->parent();
+    const Texture& texture = *entry.texture;
+    const detail::texture::Handle old_handle = texture.m_texture.get();
+
+    const VkImageCreateInfo image_ci = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = entry.flags,
+        .imageType = entry.type,
+        .format = entry.format,
+        .extent = texture.size(),
+        .mipLevels = texture.level_count(),
+        .arrayLayers = texture.layer_count(),
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = texture.usage(),
+        .sharingMode = entry.queue_families.size() > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = static_cast<uint32_t>(entry.queue_families.size()),
+        .pQueueFamilyIndices = entry.queue_families.data(),
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+    VkImage image;
+    check_result(vkCreateImage(device, &image_ci, nullptr, &image), IMAGE_CREATE_FAILED);
+    unique_handle image_guard(device, image);
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(device, image, &requirements);
+    detail::memory::Allocation allocation;
+    if (!allocate_target(pool, source, requirements, allocation))
+        return false;
+
+    const VkResult result = vkBindImageMemory(device, image, allocation.memory, allocation.offset);
+    if (result != VK_SUCCESS) [[unlikely]]
+    {
+        allocation.block->free(allocation.node);
+        check_result(result, BIND_MEMORY_FAILED);
+    }
+
+    // The views refer to the image, so they are created again. On failure, the memory is released to its block.
+    unique_handle<VkImageView[]> views(device, new VkImageView[entry.views.size()]{ VK_NULL_HANDLE }, static_cast<uint32_t>(entry.views.size()));
+    for (size_t i = 0; i < entry.views.size(); i++)
+    {
+        const VkImageViewUsageCreateInfo view_usage = Texture::view_usage(texture.usage(), entry.views[i].format);
+        const VkImageViewCreateInfo view_ci = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .pNext = &view_usage,
+            .flags = entry.views[i].flags,
+            .image = image,
+            .viewType = entry.views[i].viewType,
+            .format = entry.views[i].format,
+            .components = entry.views[i].components,
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = texture.level_count(),
+                .baseArrayLayer = entry.views[i].baseArrayLayer,
+                .layerCount = entry.views[i].layerCount
+            }
+        };
+        const VkResult view_result = vkCreateImageView(device, &view_ci, nullptr, views.get() + i);
+        if (view_result != VK_SUCCESS) [[unlikely]]
+        {
+            allocation.block->free(allocation.node);
+            check_result(view_result, VIEW_CREATE_FAILED);
+        }
+    }
+    if (old_handle.memory.tracker != nullptr)
+        old_handle.memory.tracker->track(MemoryObjectType::TEXTURE, entry.name.c_str(), false, allocation);
+
+    // The sampler is taken over when the handles are swapped.
+    const uint32_t view_count = views.count();
+    const detail::texture::Handle handle = {
+        .image = image_guard.release(),
+        .memory = allocation,
+        .sampler = VK_NULL_HANDLE,
+        .sampler_cache = nullptr,
+        .views = views.release(),
+        .view_count = view_count
+    };
+    moves.textures.push_back(entry.texture);
+    moves.texture_handles.push_back(unique_handle(device, handle));
+    return true;
+}
+
+void vka::MemoryDefragmenter::record(VkCommandBuffer cbo, const Moves& moves)
+{
+    // All moves of a step share one barrier in front of and one barrier behind the copies. Everything is allocated
+    // before the first command is recorded.
+    std::vector<VkImageMemoryBarrier> barriers;
+    std::vector<VkImageCopy> regions;
+    barriers.reserve(2 * moves.textures.size());
+    uint32_t max_level_count = 0;
+    for (const Texture* texture : moves.textures)
+        max_level_count = std::max(max_level_count, texture->level_count());
+    regions.reserve(max_level_count);
+
+    for (size_t i = 0; i < moves.textures.size(); i++)
+    {
+        const VkImageSubresourceRange range = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = moves.textures[i]->level_count(),
+            .baseArrayLayer = 0,
+            .layerCount = moves.textures[i]->layer_count()
+        };
+        barriers.push_back({
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .pNext = nullptr,
+            .srcAccessMask = 0,
+            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = moves.textures[i]->m_texture.get().image,
+            .subresourceRange = range
+        });
+        barriers.push_back({
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .pNext = nullptr,
+            .srcAccessMask = 0,
+            .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = moves.texture_handles[i].get().image,
+            .subresourceRange = range
+        });
+    }
+    VkMemoryBarrier memory_barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT
+    };
+    vkCmdPipelineBarrier(cbo, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &memory_barrier, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+
+    for (size_t i = 0; i < moves.buffers.size(); i++)
+    {
+        const VkBufferCopy region = { 0, 0, moves.buffers[i]->size() };
+        vkCmdCopyBuffer(cbo, moves.buffers[i]->m_buffer.get().buffer, moves.buffer_handles[i].get().buffer, 1, &region);
+    }
+
+    for (size_t i = 0; i < moves.textures.size(); i++)
+    {
+        const Texture& texture = *moves.textures[i];
+        const VkExtent3D extent = texture.size();
+        regions.clear();
+        for (uint32_t level = 0; level < texture.level_count(); level++)
+        {
+            const VkImageSubresourceLayers subresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, texture.layer_count() };
+            regions.push_back({
+                .srcSubresource = subresource,
+                .srcOffset = { 0, 0, 0 },
+                .dstSubresource = subresource,
+                .dstOffset = { 0, 0, 0 },
+                .extent = { std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u), std::max(extent.depth >> level, 1u) }
+            });
+        }
+        vkCmdCopyImage(cbo, texture.m_texture.get().image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, moves.texture_handles[i].get().image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
+    }
+
+    // Only the new images are transitioned back, the old images are destroyed.
+    size_t n = 0;
+    for (size_t i = 1; i < barriers.size(); i += 2)
+    {
+        VkImageMemoryBarrier& barrier = barriers[n++];
+        barrier = barriers[i];
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    }
+    memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    memory_barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+    vkCmdPipelineBarrier(cbo, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memory_barrier, 0, nullptr, static_cast<uint32_t>(n), barriers.data());
+}
+
+void vka::MemoryDefragmenter::commit(Moves& moves) noexcept
+{
+    // The lists have been reserved by step(), so that pushing the handles never reallocates.
+    const VkDevice device = this->m_allocator->parent();
+    for (size_t i = 0; i < moves.buffers.size(); i++)
+    {
+        Buffer* const buffer = moves.buffers[i];
+        const detail::buffer::Handle old_handle = buffer->m_buffer.release_reset(moves.buffer_handles[i].release());
+        this->m_retired_buffers.push_back({ this->m_step, unique_handle(device, old_handle) });
+        this->m_moved_buffers.push_back(buffer);
+    }
+
+    // The sampler does not depend on the image and is taken over by the new handle.
+    for (size_t i = 0; i < moves.textures.size(); i++)
+    {
+        Texture* const texture = moves.textures[i];
+        detail::texture::Handle handle = moves.texture_handles[i].release();
+        detail::texture::Handle old_handle = texture->m_texture.get();
+        handle.sampler = old_handle.sampler;
+        handle.sampler_cache = old_handle.sampler_cache;
+        old_handle.sampler = VK_NULL_HANDLE;
+        old_handle.sampler_cache = nullptr;
+        texture->m_texture.release_reset(handle);
+        this->m_retired_textures.push_back({ this->m_step, unique_handle(device, old_handle) });
+        this->m_moved_textures.push_back(texture);
+    }
+    moves.buffers.clear();
+    moves.buffer_handles.clear();
+    moves.textures.clear();
+    moves.texture_handles.clear();
+}
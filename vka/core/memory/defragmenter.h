@@ -0,0 +1,216 @@
+/**
+ * @brief Incremental defragmentation of the memory of a memory allocator.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+namespace vka
+{
+    /**
+     * Moves buffers and textures out of sparsely used memory blocks of a <c>MemoryAllocator</c>, so that these blocks
+     * become empty and can be freed. Only registered objects are moved. Because vulkan resources cannot be bound to
+     * other memory, a moved object gets a new vulkan handle which is bound to the new memory. Its content is copied on
+     * the GPU and the old handle is kept alive until it is released. The work is split into steps with a byte budget,
+     * so that a step can be recorded every frame without causing a hitch.
+     *
+     * Every step picks the least used block of every pool whose allocations fit into the free space of the other
+     * non-empty blocks of that pool. The registered objects of this block are moved into the most used blocks first.
+     * The following objects are never moved:
+     * - Objects that are not suballocated, e.g. objects with dedicated memory.
+     * - Buffers that are mapped.
+     * - Buffers without <c>VK_BUFFER_USAGE_TRANSFER_SRC_BIT</c>.
+     * - Buffers with <c>VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT</c>, because their address would change.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates an <b>empty</b> defragmenter. This empty object is invalid and cannot perform
+     * any actions. Calling <c>parent()</c> returns <c>VK_NULL_HANDLE</c>.
+     *
+     * <b>Initialization:</b>\n
+     * The initialization constructor creates a valid defragmenter without any registered objects.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the retired handles of the current object are destroyed.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Destroys all retired handles. The GPU must have finished all steps before.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class can be created and used from any thread. However, if you use this class across multiple threads,
+     * actions must be externally synchronized. Registered objects must not be used by other threads during a step.
+     * Other objects can still be created and destroyed with the allocator.
+     *
+     * <b>Actions:</b>
+     * - <b>registration</b> -- Invoked by <c>add()</c> and <c>remove()</c>.
+     * - <b>step</b> -- Invoked by <c>step()</c> moves objects and records the copies.
+     * - <b>release</b> -- Invoked by <c>release()</c> destroys the handles of moved objects and frees empty blocks.
+     */
+    class MemoryDefragmenter final
+    {
+    public:
+        /// Creates an empty defragmenter. This defragmenter is invalid.
+        constexpr MemoryDefragmenter() noexcept;
+
+        /**
+         * Creates the defragmenter.
+         * @param allocator Allocator whose memory is defragmented. It must outlive the defragmenter.
+         */
+        explicit constexpr MemoryDefragmenter(MemoryAllocator& allocator) noexcept;
+
+        /// @return Returns the parent handle.
+        constexpr VkDevice parent() const noexcept;
+
+        /// @return Returns the number of registered buffers and textures.
+        constexpr size_t object_count() const noexcept;
+
+        /// @return Returns the number of steps which have been recorded.
+        constexpr uint64_t step_count() const noexcept;
+
+        /// @return Returns the buffers which have been moved by the last step.
+        constexpr const std::vector<Buffer*>& moved_buffers() const noexcept;
+
+        /// @return Returns the textures which have been moved by the last step.
+        constexpr const std::vector<Texture*>& moved_textures() const noexcept;
+
+        /**
+         * Registers a buffer. The buffer must not be moved or destroyed, until it is removed.
+         * @param buffer Buffer which can be moved.
+         * @param create_info Create-info with which the buffer was created. It is copied.
+         * @throw std::bad_alloc Is thrown, if registering the buffer failed.
+         */
+        void add(Buffer& buffer, const BufferCreateInfo& create_info);
+
+        /**
+         * Registers a texture. The texture must not be moved or destroyed, until it is removed. The texture must have
+         * been finished, because its content is copied in the <c>VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL</c> layout.
+         * @param texture Texture which can be moved.
+         * @param create_info Create-info with which the texture was created. It is copied.
+         * @throw std::bad_alloc Is thrown, if registering the texture failed.
+         */
+        void add(Texture& texture, const TextureCreateInfo& create_info);
+
+        /// Unregisters a buffer.
+        void remove(const Buffer& buffer) noexcept;
+
+        /// Unregisters a texture.
+        void remove(const Texture& texture) noexcept;
+
+        /**
+         * Moves registered objects and records the copies of their content. The moved objects get new handles, which
+         * must be written into descriptor sets before they are used again (see <c>moved_buffers()</c> and
+         * <c>moved_textures()</c>). The old handles stay valid until they are released.
+         * @param cbo Command buffer in which the copies and barriers are recorded. The command buffer is recorded
+         * before any command that uses the moved objects.
+         * @param max_bytes Maximum number of bytes moved by this step. An object larger than the budget is only moved,
+         * if it is the first object of the step.
+         * @return Returns the number of bytes moved. If it is <c>0</c>, the memory cannot be defragmented any further.
+         * @throw std::runtime_error Is thrown, if creating a handle failed. In that case, no object is moved and
+         * nothing is recorded.
+         */
+        VkDeviceSize step(VkCommandBuffer cbo, VkDeviceSize max_bytes);
+
+        /**
+         * Destroys the old handles of moved objects. Their memory is returned to the allocator and all empty blocks are
+         * freed.
+         * @param keep Number of the latest steps whose handles are kept, e.g. the number of frames in flight minus 1.
+         * @pre The GPU has finished all steps except the latest <c>keep</c> steps.
+         */
+        void release(uint32_t keep = 0) noexcept;
+
+        // deleted
+        MemoryDefragmenter(const MemoryDefragmenter&) = delete;
+        MemoryDefragmenter& operator= (const MemoryDefragmenter&) = delete;
+
+        // default
+        MemoryDefragmenter(MemoryDefragmenter&&) = default;
+        ~MemoryDefragmenter() = default;
+        MemoryDefragmenter& operator= (MemoryDefragmenter&&) = default;
+
+    private:
+        static constexpr const char* BUFFER_CREATE_FAILED = "[vka::MemoryDefragmenter]: Failed to create buffer handle.";
+        static constexpr const char* IMAGE_CREATE_FAILED = "[vka::MemoryDefragmenter]: Failed to create image handle.";
+        static constexpr const char* VIEW_CREATE_FAILED = "[vka::MemoryDefragmenter]: Failed to create image view.";
+        static constexpr const char* BIND_MEMORY_FAILED = "[vka::MemoryDefragmenter]: Failed to bind memory.";
+
+        struct BufferEntry
+        {
+            Buffer* buffer;
+            VkBufferCreateFlags flags;
+            VkBufferUsageFlags usage;
+            VkSharingMode sharing_mode;
+            std::vector<uint32_t> queue_families;
+            std::string name;
+        };
+
+        struct TextureEntry
+        {
+            Texture* texture;
+            VkImageCreateFlags flags;
+            VkImageType type;
+            VkFormat format;
+            std::vector<uint32_t> queue_families;
+            std::vector<TextureViewCreateInfo> views;
+            std::string name;
+        };
+
+        template<typename Handle>
+        struct Retired
+        {
+            uint64_t step;
+            unique_handle<Handle> handle;
+        };
+
+        /**
+         * Moves of the current step with the new handles of the objects. The handles are only swapped after all moves
+         * have been recorded, so that a failure leaves every object in its old memory.
+         */
+        struct Moves
+        {
+            std::vector<Buffer*> buffers;
+            std::vector<unique_handle<detail::buffer::Handle>> buffer_handles;
+            std::vector<Texture*> textures;
+            std::vector<unique_handle<detail::texture::Handle>> texture_handles;
+        };
+
+        MemoryAllocator* m_allocator;
+        std::vector<BufferEntry> m_buffers;
+        std::vector<TextureEntry> m_textures;
+        std::vector<Retired<detail::buffer::Handle>> m_retired_buffers;
+        std::vector<Retired<detail::texture::Handle>> m_retired_textures;
+        std::vector<Buffer*> m_moved_buffers;
+        std::vector<Texture*> m_moved_textures;
+        uint64_t m_step;
+
+        /// @return Returns the block of a pool from which objects are moved or <c>nullptr</c>, if there is none.
+        static detail::memory::Block* find_source(const detail::memory::Pool& pool) noexcept;
+
+        /// Suballocates memory from the most used non-empty block of a pool, except the source block.
+        static bool allocate_target(detail::memory::Pool& pool, const detail::memory::Block* source, const VkMemoryRequirements& requirements, detail::memory::Allocation& allocation);
+
+        /// @return Returns whether a buffer can be moved.
+        static bool movable(const BufferEntry& entry) noexcept;
+
+        /// Creates the new handle of a buffer in a target block. Returns false, if there is no space left.
+        bool move_buffer(BufferEntry& entry, detail::memory::Pool& pool, const detail::memory::Block* source, Moves& moves);
+
+        /// Creates the new handle of a texture in a target block. Returns false, if there is no space left.
+        bool move_texture(TextureEntry& entry, detail::memory::Pool& pool, const detail::memory::Block* source, Moves& moves);
+
+        /// Records the barriers and copies of all moves of a step. Nothing is recorded, if an exception is thrown.
+        static void record(VkCommandBuffer cbo, const Moves& moves);
+
+        /// Swaps the handles of the moved objects and retires their old handles.
+        void commit(Moves& moves) noexcept;
+    };
+}
@@ -0,0 +1,46 @@
+/**
+ * @brief Inline implementation for the memory defragmenter.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+#include "defragmenter.h"
+
+constexpr vka::MemoryDefragmenter::MemoryDefragmenter() noexcept :
+    m_allocator(nullptr),
+    m_step(0)
+{}
+
+constexpr vka::MemoryDefragmenter::MemoryDefragmenter(MemoryAllocator& allocator) noexcept :
+    m_allocator(&allocator),
+    m_step(0)
+{}
+
+constexpr VkDevice vka::MemoryDefragmenter::parent() const noexcept
+{
+    return this->m_allocator != nullptr ? this->m_allocator->parent() : VK_NULL_HANDLE;
+}
+
+constexpr size_t vka::MemoryDefragmenter::object_count() const noexcept
+{
+    return this->m_buffers.size() + this->m_textures.size();
+}
+
+constexpr uint64_t vka::MemoryDefragmenter::step_count() const noexcept
+{
+    return this->m_step;
+}
+
+constexpr const std::vector<vka::Buffer*>& vka::MemoryDefragmenter::moved_buffers() const noexcept
+{
+    return this->m_moved_buffers;
+}
+
+constexpr const std::vector<vka::Texture*>& vka::MemoryDefragmenter::moved_textures() const noexcept
+{
+    return this->m_moved_textures;
+}
@@ -21,3 +21,157 @@ uint32_t vka::memory::find_type_index(const VkPhysicalDeviceMemoryProperties& pr
     }
     return NPOS;
 }
+
+uint32_t vka::memory::find_type_index(const VkPhysicalDeviceMemoryProperties& properties, uint32_t bits, VkMemoryPropertyFlags req_flags, VkMemoryPropertyFlags pref_flags, VkMemoryPropertyFlags forb_flags) noexcept
+{
+    uint32_t type_index = NPOS;
+    int32_t best_score = -1;
+    for (uint32_t i = 0; i < properties.memoryTypeCount; i++)
+    {
+        const int32_t score = detail::memory::score_type(properties.memoryTypes[i].propertyFlags, req_flags, pref_flags, forb_flags);
+        if (bits & 0b1 << i && score > best_score)
+        {
+            type_index = i;
+            best_score = score;
+        }
+    }
+    return type_index;
+}
+
+uint32_t vka::memory::rank_type_indices(
+    const VkPhysicalDeviceMemoryProperties& properties,
+    uint32_t bits,
+    VkMemoryPropertyFlags req_flags,
+    VkMemoryPropertyFlags pref_flags,
+    VkMemoryPropertyFlags forb_flags,
+    const VkPhysicalDeviceMemoryBudgetPropertiesEXT* budget,
+    VkDeviceSize size,
+    uint32_t* indices
+) noexcept
+{
+    int32_t scores[VK_MAX_MEMORY_TYPES];
+    bool over_budget[VK_MAX_MEMORY_TYPES];
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < properties.memoryTypeCount; i++)
+    {
+        scores[i] = detail::memory::score_type(properties.memoryTypes[i].propertyFlags, req_flags, pref_flags, forb_flags);
+        if ((bits & 0b1 << i) == 0 || scores[i] < 0)
+            continue;
+
+        const uint32_t heap = properties.memoryTypes[i].heapIndex;
+        over_budget[i] = budget != nullptr && budget->heapUsage[heap] + size > budget->heapBudget[heap];
+        indices[count++] = i;
+    }
+
+    // A heap which is near its budget is only used, if there is no other choice. Exceeding the budget does not
+    // necessarily fail, but the driver might start to evict memory or the allocation fails under load.
+    // The sort is stable, so that memory types with the same rank stay ordered by their index.
+    std::stable_sort(indices, indices + count, [&](uint32_t a, uint32_t b) {
+        if (over_budget[a] != over_budget[b])
+            return over_budget[b];
+        return scores[a] > scores[b];
+    });
+    return count;
+}
+
+void vka::memory::query_budget(VkPhysicalDevice physical_device, VkPhysicalDeviceMemoryBudgetPropertiesEXT& budget) noexcept
+{
+    budget.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+    budget.pNext = nullptr;
+    VkPhysicalDeviceMemoryProperties2 properties = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+        .pNext = &budget,
+        .memoryProperties = {}
+    };
+    vkGetPhysicalDeviceMemoryProperties2(physical_device, &properties);
+}
+
+void vka::memory::get_requirements(VkDevice device, VkBuffer buffer, VkMemoryRequirements& requirements, VkMemoryDedicatedRequirements& dedicated) noexcept
+{
+    dedicated.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    dedicated.pNext = nullptr;
+    const VkBufferMemoryRequirementsInfo2 info = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2,
+        .pNext = nullptr,
+        .buffer = buffer
+    };
+    VkMemoryRequirements2 requirements2 = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &dedicated,
+        .memoryRequirements = {}
+    };
+    vkGetBufferMemoryRequirements2(device, &info, &requirements2);
+    requirements = requirements2.memoryRequirements;
+}
+
+void vka::memory::get_requirements(VkDevice device, VkImage image, VkMemoryRequirements& requirements, VkMemoryDedicatedRequirements& dedicated) noexcept
+{
+    dedicated.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS;
+    dedicated.pNext = nullptr;
+    const VkImageMemoryRequirementsInfo2 info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2,
+        .pNext = nullptr,
+        .image = image
+    };
+    VkMemoryRequirements2 requirements2 = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = &dedicated,
+        .memoryRequirements = {}
+    };
+    vkGetImageMemoryRequirements2(device, &info, &requirements2);
+    requirements = requirements2.memoryRequirements;
+}
+
+bool vka::memory::use_dedicated(const MemoryAllocator* allocator, const VkMemoryDedicatedRequirements& dedicated, VkDeviceSize size) noexcept
+{
+    if (dedicated.requiresDedicatedAllocation || dedicated.prefersDedicatedAllocation)
+        return true;
+    return allocator != nullptr && allocator->dedicated_threshold() > 0 && size >= allocator->dedicated_threshold();
+}
+
+VkResult vka::memory::allocate(
+    VkDevice device,
+    const VkPhysicalDeviceMemoryProperties& properties,
+    MemoryAllocator* allocator,
+    const VkMemoryRequirements& requirements,
+    VkMemoryPropertyFlags req_flags,
+    VkMemoryPropertyFlags pref_flags,
+    VkMemoryPropertyFlags forb_flags,
+    bool optimal,
+    const void* next,
+    detail::memory::Allocation& allocation
+) noexcept
+{
+    // Memory with a pNext-chain can contain information that only applies to a single resource, e.g. import or export
+    // information. Therefore, such memory cannot be shared and is never suballocated, but it is still counted by the
+    // allocator and takes the budget into account.
+    if (allocator != nullptr && next == nullptr)
+        return allocator->allocate(requirements, req_flags, pref_flags, forb_flags, optimal, allocation);
+    if (allocator != nullptr)
+        return allocator->allocate_dedicated(requirements, req_flags, pref_flags, forb_flags, optimal, next, allocation);
+
+    uint32_t indices[VK_MAX_MEMORY_TYPES];
+    const uint32_t count = rank_type_indices(properties, requirements.memoryTypeBits, req_flags, pref_flags, forb_flags, nullptr, requirements.size, indices);
+
+    // If the heap of a memory type is exhausted, the next memory type in the ranking is tried.
+    VkResult result = VK_ERROR_FEATURE_NOT_PRESENT;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const VkMemoryAllocateInfo memory_ai = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+            .pNext = next,
+            .allocationSize = requirements.size,
+            .memoryTypeIndex = indices[i]
+        };
+        VkDeviceMemory memory;
+        result = vkAllocateMemory(device, &memory_ai, nullptr, &memory);
+        if (result == VK_SUCCESS) [[likely]]
+        {
+            allocation = { memory, 0, requirements.size, nullptr, nullptr, NPOS, indices[i], nullptr };
+            return result;
+        }
+        if (result != VK_ERROR_OUT_OF_DEVICE_MEMORY && result != VK_ERROR_OUT_OF_HOST_MEMORY)
+            return result;
+    }
+    return result;
+}
@@ -8,6 +8,11 @@
 
 #pragma once
 
+namespace vka
+{
+    class MemoryAllocator;
+}
+
 namespace vka::memory
 {
     /**
@@ -19,4 +24,112 @@ namespace vka::memory
      * returned.
      */
     uint32_t find_type_index(const VkPhysicalDeviceMemoryProperties& properties, uint32_t bits, VkMemoryPropertyFlags req_flags) noexcept;
+
+    /**
+     * Searches for the memory type that matches the requested flags best. Memory types with more preferred flags are
+     * ranked higher, memory types with flags which are neither required nor preferred (e.g.
+     * <c>VK_MEMORY_PROPERTY_HOST_CACHED_BIT</c>) are ranked lower. Protected memory is only used, if it is required or
+     * preferred. If multiple memory types have the same rank, the one with the lowest index is used.
+     * @param properties Memory properties of the physical device.
+     * @param bits Memory-type bit mask.
+     * @param req_flags Required memory property flags.
+     * @param pref_flags Preferred memory property flags.
+     * @param forb_flags Forbidden memory property flags.
+     * @return Returns the index of the best memory type. If no memory type is suitable, <c>vka::NPOS</c> is returned.
+     */
+    uint32_t find_type_index(const VkPhysicalDeviceMemoryProperties& properties, uint32_t bits, VkMemoryPropertyFlags req_flags, VkMemoryPropertyFlags pref_flags, VkMemoryPropertyFlags forb_flags) noexcept;
+
+    /**
+     * Ranks all suitable memory types in the same way as <c>find_type_index()</c>. If a budget is specified, memory
+     * types whose heap would exceed its budget by the allocation are moved to the end of the ranking. Allocations
+     * should be tried in the order of the ranking until one succeeds.
+     * @param properties Memory properties of the physical device.
+     * @param bits Memory-type bit mask.
+     * @param req_flags Required memory property flags.
+     * @param pref_flags Preferred memory property flags.
+     * @param forb_flags Forbidden memory property flags.
+     * @param budget Budget of the memory heaps (see <c>query_budget()</c>), can be <c>nullptr</c>.
+     * @param size Size of the allocation in bytes.
+     * @param indices Returns the ranked memory-type indices. The array must have space for
+     * <c>VK_MAX_MEMORY_TYPES</c> elements.
+     * @return Returns the number of suitable memory types.
+     */
+    uint32_t rank_type_indices(
+        const VkPhysicalDeviceMemoryProperties& properties,
+        uint32_t bits,
+        VkMemoryPropertyFlags req_flags,
+        VkMemoryPropertyFlags pref_flags,
+        VkMemoryPropertyFlags forb_flags,
+        const VkPhysicalDeviceMemoryBudgetPropertiesEXT* budget,
+        VkDeviceSize size,
+        uint32_t* indices
+    ) noexcept;
+
+    /**
+     * Queries the current budget and usage of all memory heaps of a physical device. The physical device must support
+     * the <c>VK_EXT_memory_budget</c> extension and the extension must be enabled on the device.
+     * @param physical_device Physical device from which the budget is queried.
+     * @param budget Returns the budget.
+     */
+    void query_budget(VkPhysicalDevice physical_device, VkPhysicalDeviceMemoryBudgetPropertiesEXT& budget) noexcept;
+
+    /**
+     * Queries the memory requirements of a buffer together with its dedicated allocation requirements.
+     * @param device Device with which the buffer was created.
+     * @param buffer Buffer whose requirements are queried.
+     * @param requirements Returns the memory requirements.
+     * @param dedicated Returns whether the driver prefers or requires a dedicated allocation.
+     */
+    void get_requirements(VkDevice device, VkBuffer buffer, VkMemoryRequirements& requirements, VkMemoryDedicatedRequirements& dedicated) noexcept;
+
+    /**
+     * Queries the memory requirements of an image together with its dedicated allocation requirements.
+     * @param device Device with which the image was created.
+     * @param image Image whose requirements are queried.
+     * @param requirements Returns the memory requirements.
+     * @param dedicated Returns whether the driver prefers or requires a dedicated allocation.
+     */
+    void get_requirements(VkDevice device, VkImage image, VkMemoryRequirements& requirements, VkMemoryDedicatedRequirements& dedicated) noexcept;
+
+    /**
+     * Decides whether a resource gets a dedicated allocation. This is the case, if the driver prefers or requires it,
+     * or if the resource is at least as large as the dedicated threshold of the allocator.
+     * @param allocator Allocator from which the resource would be suballocated, can be <c>nullptr</c>.
+     * @param dedicated Dedicated allocation requirements of the resource.
+     * @param size Size of the resource in bytes.
+     * @return Returns whether the memory should be allocated with a <c>VkMemoryDedicatedAllocateInfo</c>.
+     */
+    bool use_dedicated(const MemoryAllocator* allocator, const VkMemoryDedicatedRequirements& dedicated, VkDeviceSize size) noexcept;
+
+    /**
+     * Allocates memory for a buffer or an image. If an allocator is specified, the memory is suballocated from the
+     * allocator or, if <c>next</c> is not <c>nullptr</c>, it is a dedicated allocation of the allocator. Otherwise,
+     * the resource gets its own memory. The memory types are tried in the order of <c>rank_type_indices()</c>, until
+     * the allocation succeeds.
+     * @param device Device with which the memory is allocated.
+     * @param properties Memory properties of the physical device.
+     * @param allocator Allocator from which the memory is suballocated, can be <c>nullptr</c>.
+     * @param requirements Memory requirements of the resource.
+     * @param req_flags Required memory property flags.
+     * @param pref_flags Preferred memory property flags.
+     * @param forb_flags Forbidden memory property flags.
+     * @param optimal Specifies whether the memory is used by an image with optimal tiling.
+     * @param next Specifies the <c>pNext</c> parameter of a
+     * <a href="https://docs.vulkan.org/refpages/latest/refpages/source/VkMemoryAllocateInfo.html">
+     * VkMemoryAllocateInfo</a>.
+     * @param allocation Returns the allocated memory.
+     * @return Returns the result of the allocation.
+     */
+    VkResult allocate(
+        VkDevice device,
+        const VkPhysicalDeviceMemoryProperties& properties,
+        MemoryAllocator* allocator,
+        const VkMemoryRequirements& requirements,
+        VkMemoryPropertyFlags req_flags,
+        VkMemoryPropertyFlags pref_flags,
+        VkMemoryPropertyFlags forb_flags,
+        bool optimal,
+        const void* next,
+        detail::memory::Allocation& allocation
+    ) noexcept;
 }
@@ -0,0 +1,213 @@
+/**
+ * @brief Implementation for the memory tracker.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+vka::MemoryTracker::MemoryTracker(const VkPhysicalDeviceMemoryProperties& properties, bool track_objects) :
+    m_properties(properties),
+    m_total{},
+    m_heaps{},
+    m_types{},
+    m_track_objects(track_objects)
+{}
+
+vka::MemoryStatistics vka::MemoryTracker::total() const noexcept
+{
+    return load(this->m_total);
+}
+
+vka::MemoryStatistics vka::MemoryTracker::heap(uint32_t heap_index) const noexcept
+{
+    return load(this->m_heaps[heap_index]);
+}
+
+vka::MemoryStatistics vka::MemoryTracker::type(uint32_t type_index) const noexcept
+{
+    return load(this->m_types[type_index]);
+}
+
+std::vector<vka::MemoryObjectInfo> vka::MemoryTracker::objects() const
+{
+    std::vector<MemoryObjectInfo> objects;
+    std::lock_guard lock(this->m_mutex);
+    objects.reserve(this->m_objects.size());
+    for (const auto& [key, info] : this->m_objects)
+        objects.push_back(info);
+    return objects;
+}
+
+void vka::MemoryTracker::reset_peaks() noexcept
+{
+    reset_peaks(this->m_total);
+    for (uint32_t i = 0; i < this->m_properties.memoryHeapCount; i++)
+        reset_peaks(this->m_heaps[i]);
+    for (uint32_t i = 0; i < this->m_properties.memoryTypeCount; i++)
+        reset_peaks(this->m_types[i]);
+}
+
+void vka::MemoryTracker::track(MemoryObjectType type, const char* name, bool dedicated_allocation, Allocation& allocation) noexcept
+{
+    const uint32_t heap_index = this->m_properties.memoryTypes[allocation.type_index].heapIndex;
+    add(this->m_total, allocation.size);
+    add(this->m_heaps[heap_index], allocation.size);
+    add(this->m_types[allocation.type_index], allocation.size);
+    allocation.tracker = this;
+
+    if (!this->m_track_objects)
+        return;
+
+    // The registry is only used for debugging, a failed insertion must not fail the creation of the object.
+    try
+    {
+        MemoryObjectInfo info = {
+            .type = type,
+            .name = name != nullptr ? name : "",
+            .size = allocation.size,
+            .memoryTypeIndex = allocation.type_index,
+            .heapIndex = heap_index,
+            .dedicated = allocation.block == nullptr,
+            .dedicatedAllocation = dedicated_allocation
+        };
+        std::lock_guard lock(this->m_mutex);
+        this->m_objects.insert_or_assign(ObjectKey{ allocation.memory, allocation.offset }, std::move(info));
+    }
+    catch (const std::bad_alloc&) {}
+}
+
+void vka::MemoryTracker::untrack(const Allocation& allocation) noexcept
+{
+    sub(this->m_total, allocation.size);
+    sub(this->m_heaps[this->m_properties.memoryTypes[allocation.type_index].heapIndex], allocation.size);
+    sub(this->m_types[allocation.type_index], allocation.size);
+
+    if (this->m_track_objects)
+    {
+        std::lock_guard lock(this->m_mutex);
+        this->m_objects.erase(ObjectKey{ allocation.memory, allocation.offset });
+    }
+}
+
+std::string vka::MemoryTracker::to_json() const
+{
+    constexpr const char* TYPE_NAMES[] = { "buffer", "texture", "attachment" };
+
+    std::string json = "{\n  \"total\": ";
+    append_json(json, this->m_total);
+
+    json += ",\n  \"heaps\": [";
+    for (uint32_t i = 0; i < this->m_properties.memoryHeapCount; i++)
+    {
+        json += i == 0 ? "\n    " : ",\n    ";
+        json += "{ \"index\": " + std::to_string(i);
+        json += ", \"size\": " + std::to_string(this->m_properties.memoryHeaps[i].size);
+        json += ", \"flags\": " + std::to_string(this->m_properties.memoryHeaps[i].flags);
+        json += ", \"statistics\": ";
+        append_json(json, this->m_heaps[i]);
+        json += " }";
+    }
+
+    json += "\n  ],\n  \"types\": [";
+    for (uint32_t i = 0; i < this->m_properties.memoryTypeCount; i++)
+    {
+        json += i == 0 ? "\n    " : ",\n    ";
+        json += "{ \"index\": " + std::to_string(i);
+        json += ", \"heapIndex\": " + std::to_string(this->m_properties.memoryTypes[i].heapIndex);
+        json += ", \"flags\": " + std::to_string(this->m_properties.memoryTypes[i].propertyFlags);
+        json += ", \"statistics\": ";
+        append_json(json, this->m_types[i]);
+        json += " }";
+    }
+
+    json += "\n  ],\n  \"objects\": [";
+    const std::vector<MemoryObjectInfo> objects = this->objects();
+    for (size_t i = 0; i < objects.size(); i++)
+    {
+        // Names are specified by the user, so they are escaped.
+        std::string name;
+        for (const char c : objects[i].name)
+        {
+            if (c == '"' || c == '\\')
+                name += '\\';
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                constexpr const char* HEX = "0123456789abcdef";
+                name += "\\u00";
+                name += HEX[c >> 4];
+                name += HEX[c & 0xF];
+            }
+            else
+                name += c;
+        }
+
+        json += i == 0 ? "\n    " : ",\n    ";
+        json += "{ \"type\": \"" + std::string(TYPE_NAMES[static_cast<uint8_t>(objects[i].type)]) + "\"";
+        json += ", \"name\": \"" + name + "\"";
+        json += ", \"size\": " + std::to_string(objects[i].size);
+        json += ", \"memoryTypeIndex\": " + std::to_string(objects[i].memoryTypeIndex);
+        json += ", \"heapIndex\": " + std::to_string(objects[i].heapIndex);
+        json += ", \"dedicated\": " + std::string(objects[i].dedicated ? "true" : "false");
+        json += ", \"dedicatedAllocation\": " + std::string(objects[i].dedicatedAllocation ? "true" : "false") + " }";
+    }
+    json += "\n  ]\n}\n";
+    return json;
+}
+
+void vka::MemoryTracker::write_json(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file) [[unlikely]]
+        detail::error::throw_runtime_error(FILE_OPEN_FAILED);
+    file << this->to_json();
+}
+
+size_t vka::MemoryTracker::ObjectKeyHash::operator() (const ObjectKey& key) const noexcept
+{
+    return std::hash<VkDeviceMemory>()(key.memory) ^ std::hash<VkDeviceSize>()(key.offset) * 0x9E3779B97F4A7C15ull;
+}
+
+void vka::MemoryTracker::add(Counter& counter, VkDeviceSize size) noexcept
+{
+    // The high-water marks are raised with a CAS-loop, which only retries if another thread raised them concurrently.
+    const VkDeviceSize bytes = counter.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    const uint32_t count = counter.count.fetch_add(1, std::memory_order_relaxed) + 1;
+    VkDeviceSize peak_bytes = counter.peak_bytes.load(std::memory_order_relaxed);
+    while (bytes > peak_bytes && !counter.peak_bytes.compare_exchange_weak(peak_bytes, bytes, std::memory_order_relaxed));
+    uint32_t peak_count = counter.peak_count.load(std::memory_order_relaxed);
+    while (count > peak_count && !counter.peak_count.compare_exchange_weak(peak_count, count, std::memory_order_relaxed));
+}
+
+void vka::MemoryTracker::sub(Counter& counter, VkDeviceSize size) noexcept
+{
+    counter.bytes.fetch_sub(size, std::memory_order_relaxed);
+    counter.count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void vka::MemoryTracker::reset_peaks(Counter& counter) noexcept
+{
+    counter.peak_bytes.store(counter.bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    counter.peak_count.store(counter.count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+vka::MemoryStatistics vka::MemoryTracker::load(const Counter& counter) noexcept
+{
+    return {
+        .bytes = counter.bytes.load(std::memory_order_relaxed),
+        .peakBytes = counter.peak_bytes.load(std::memory_order_relaxed),
+        .allocationCount = counter.count.load(std::memory_order_relaxed),
+        .peakAllocationCount = counter.peak_count.load(std::memory_order_relaxed)
+    };
+}
+
+void vka::MemoryTracker::append_json(std::string& json, const Counter& counter)
+{
+    const MemoryStatistics statistics = load(counter);
+    json += "{ \"bytes\": " + std::to_string(statistics.bytes);
+    json += ", \"peakBytes\": " + std::to_string(statistics.peakBytes);
+    json += ", \"allocationCount\": " + std::to_string(statistics.allocationCount);
+    json += ", \"peakAllocationCount\": " + std::to_string(statistics.peakAllocationCount) + " }";
+}
@@ -0,0 +1,228 @@
+/**
+ * @brief Tracker that accounts the device memory of buffers, textures and attachment images.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+namespace vka
+{
+    /**
+     * Specifies the kind of object that owns tracked memory.
+     * - <c>BUFFER</c> -- The memory is owned by a <c>Buffer</c>.
+     * - <c>TEXTURE</c> -- The memory is owned by a <c>Texture</c>.
+     * - <c>ATTACHMENT</c> -- The memory is owned by an <c>AttachmentImage</c>.
+     */
+    enum class MemoryObjectType : uint8_t
+    {
+        BUFFER,
+        TEXTURE,
+        ATTACHMENT,
+    };
+
+    /**
+     * Snapshot of the memory used by tracked objects.
+     * - <c>bytes</c> -- Number of bytes currently used.
+     * - <c>peakBytes</c> -- Highest number of bytes used at the same time.
+     * - <c>allocationCount</c> -- Number of allocations currently alive.
+     * - <c>peakAllocationCount</c> -- Highest number of allocations alive at the same time.
+     */
+    struct MemoryStatistics
+    {
+        VkDeviceSize    bytes;
+        VkDeviceSize    peakBytes;
+        uint32_t        allocationCount;
+        uint32_t        peakAllocationCount;
+    };
+
+    /**
+     * Information about a single tracked object.
+     * - <c>type</c> -- Kind of the object.
+     * - <c>name</c> -- Debug name of the object, empty if no name was specified.
+     * - <c>size</c> -- Size of the memory of the object in bytes.
+     * - <c>memoryTypeIndex</c> -- Memory type in which the object is allocated.
+     * - <c>heapIndex</c> -- Memory heap in which the object is allocated.
+     * - <c>dedicated</c> -- Specifies whether the object has its own <c>VkDeviceMemory</c>.
+     * - <c>dedicatedAllocation</c> -- Specifies whether the memory was allocated with a
+     * <c>VkMemoryDedicatedAllocateInfo</c>, because the driver prefers it or the object exceeds the dedicated threshold
+     * of the allocator.
+     */
+    struct MemoryObjectInfo
+    {
+        MemoryObjectType    type;
+        std::string         name;
+        VkDeviceSize        size;
+        uint32_t            memoryTypeIndex;
+        uint32_t            heapIndex;
+        bool                dedicated;
+        bool                dedicatedAllocation;
+    };
+
+    /**
+     * Accounts the memory of all buffers, textures and attachment images that are created with the tracker (see
+     * <c>BufferCreateInfo</c>, <c>TextureCreateInfo</c> and <c>AttachmentImageCreateInfo</c>). Totals, allocation
+     * counts and high-water marks are kept per memory heap, per memory type and for the whole tracker. They are
+     * updated with atomic operations only, so tracking is cheap enough to stay enabled in release builds.
+     * Optionally, every object is recorded in a registry together with its size and debug name. The registry is
+     * protected by a mutex and can be exported as JSON.
+     *
+     * <b>Default initialization:</b>\n
+     * There is no default constructor.
+     *
+     * <b>Initialization:</b>\n
+     * The initialization constructor creates a tracker without any tracked memory.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * The move constructor and operator are deleted, because tracked objects refer to the tracker.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * The tracker must outlive all objects that are tracked by it.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class is internally synchronized. Objects can be tracked and untracked from any thread, while the statistics
+     * are queried from another thread.
+     *
+     * <b>Actions:</b>
+     * - <b>tracking</b> -- Invoked by <c>track()</c> and <c>untrack()</c>. Usually, this is done by the objects
+     * themselves.
+     * - <b>query</b> -- Invoked by <c>total()</c>, <c>heap()</c>, <c>type()</c> or <c>objects()</c>.
+     * - <b>export</b> -- Invoked by <c>to_json()</c> or <c>write_json()</c>.
+     */
+    class MemoryTracker final
+    {
+    public:
+        using Allocation = detail::memory::Allocation;
+
+        /**
+         * Creates the tracker.
+         * @param properties Memory properties of the physical device, used to map memory types to their heaps.
+         * @param track_objects Specifies whether every object is recorded in the registry.
+         */
+        explicit MemoryTracker(const VkPhysicalDeviceMemoryProperties& properties, bool track_objects);
+
+        /// @return Returns the memory properties of the physical device.
+        constexpr const VkPhysicalDeviceMemoryProperties& properties() const noexcept;
+
+        /// @return Returns whether objects are recorded in the registry.
+        constexpr bool tracks_objects() const noexcept;
+
+        /// @return Returns the statistics of all tracked memory.
+        MemoryStatistics total() const noexcept;
+
+        /**
+         * @param heap_index Index of the memory heap.
+         * @return Returns the statistics of the tracked memory in a memory heap.
+         */
+        MemoryStatistics heap(uint32_t heap_index) const noexcept;
+
+        /**
+         * @param type_index Index of the memory type.
+         * @return Returns the statistics of the tracked memory in a memory type.
+         */
+        MemoryStatistics type(uint32_t type_index) const noexcept;
+
+        /**
+         * @return Returns a copy of the registry. If objects are not tracked, the returned vector is empty.
+         * @throw std::bad_alloc Is thrown, if copying the registry failed.
+         */
+        std::vector<MemoryObjectInfo> objects() const;
+
+        /// Sets all high-water marks to the current values.
+        void reset_peaks() noexcept;
+
+        /**
+         * Starts tracking an allocation. The allocation remembers the tracker, so that it is untracked when it is
+         * freed with <c>vka::detail::memory::free()</c>. If the object cannot be recorded in the registry, only the
+         * statistics are updated.
+         * @param type Kind of the object which owns the allocation.
+         * @param name Debug name of the object, can be <c>nullptr</c>.
+         * @param dedicated_allocation Specifies whether the memory was allocated with a
+         * <c>VkMemoryDedicatedAllocateInfo</c>.
+         * @param allocation Allocation to track.
+         */
+        void track(MemoryObjectType type, const char* name, bool dedicated_allocation, Allocation& allocation) noexcept;
+
+        /**
+         * Stops tracking an allocation.
+         * @param allocation Allocation that has been tracked by this tracker.
+         */
+        void untrack(const Allocation& allocation) noexcept;
+
+        /**
+         * Exports the statistics of all heaps and memory types and the registry as JSON.
+         * @return Returns the JSON string.
+         * @throw std::bad_alloc Is thrown, if creating the string failed.
+         */
+        std::string to_json() const;
+
+        /**
+         * Exports the statistics and the registry as JSON into a file.
+         * @param path Path of the file.
+         * @throw std::runtime_error Is thrown, if the file cannot be opened.
+         */
+        void write_json(const std::string& path) const;
+
+        // deleted
+        MemoryTracker(const MemoryTracker&) = delete;
+        MemoryTracker(MemoryTracker&&) = delete;
+        MemoryTracker& operator= (const MemoryTracker&) = delete;
+        MemoryTracker& operator= (MemoryTracker&&) = delete;
+
+    private:
+        static constexpr const char* FILE_OPEN_FAILED = "[vka::MemoryTracker]: Failed to open file.";
+
+        struct Counter
+        {
+            std::atomic<VkDeviceSize> bytes;
+            std::atomic<VkDeviceSize> peak_bytes;
+            std::atomic<uint32_t> count;
+            std::atomic<uint32_t> peak_count;
+        };
+
+        /// Allocations are identified by their memory and offset, which is unique for all allocations alive.
+        struct ObjectKey
+        {
+            VkDeviceMemory memory;
+            VkDeviceSize offset;
+
+            constexpr bool operator== (const ObjectKey& other) const noexcept = default;
+        };
+
+        struct ObjectKeyHash
+        {
+            size_t operator() (const ObjectKey& key) const noexcept;
+        };
+
+        VkPhysicalDeviceMemoryProperties m_properties;
+        Counter m_total;
+        Counter m_heaps[VK_MAX_MEMORY_HEAPS];
+        Counter m_types[VK_MAX_MEMORY_TYPES];
+        bool m_track_objects;
+        mutable std::mutex m_mutex;
+        std::unordered_map<ObjectKey, MemoryObjectInfo, ObjectKeyHash> m_objects;
+
+        /// Adds an allocation to a counter and raises its high-water marks.
+        static void add(Counter& counter, VkDeviceSize size) noexcept;
+
+        /// Removes an allocation from a counter.
+        static void sub(Counter& counter, VkDeviceSize size) noexcept;
+
+        /// Resets the high-water marks of a counter.
+        static void reset_peaks(Counter& counter) noexcept;
+
+        /// @return Returns the statistics of a counter.
+        static MemoryStatistics load(const Counter& counter) noexcept;
+
+        /// Appends the statistics of a counter to a JSON string.
+        static void append_json(std::string& json, const Counter& counter);
+    };
+}
@@ -0,0 +1,21 @@
+/**
+ * @brief Inline implementation for the memory tracker.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+#include "tracker.h"
+
+constexpr const VkPhysicalDeviceMemoryProperties& vka::MemoryTracker::properties() const noexcept
+{
+    return this->m_properties;
+}
+
+constexpr bool vka::MemoryTracker::tracks_objects() const noexcept
+{
+    return this->m_track_objects;
+}
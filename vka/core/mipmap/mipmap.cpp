@@ -0,0 +1,402 @@
+/**
+ * @brief Implementation for the mip generator.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+// SPIR-V code of mipmap.comp, which is generated by the build.
+#include <vka/core/mipmap/mipmap.comp.h>
+
+vka::MipResources::operator bool() const noexcept
+{
+    return (bool)this->m_pool;
+}
+
+void vka::MipResources::destroy() noexcept
+{
+    this->m_pool = VK_NULL_HANDLE;
+    this->m_views.clear();
+}
+
+vka::MipGenerator::MipGenerator() noexcept :
+    m_physical_device(VK_NULL_HANDLE),
+    m_write_without_format(false)
+{}
+
+vka::MipGenerator::MipGenerator(VkDevice device, VkPhysicalDevice physical_device, bool write_without_format) :
+    m_physical_device(physical_device),
+    m_write_without_format(write_without_format)
+{
+    // The base level is read with texelFetch(), which ignores the filter of the sampler.
+    const VkSamplerCreateInfo sampler_create_info = {
+        .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .magFilter = VK_FILTER_NEAREST,
+        .minFilter = VK_FILTER_NEAREST,
+        .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+        .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        .mipLodBias = 0.0f,
+        .anisotropyEnable = VK_FALSE,
+        .maxAnisotropy = 1.0f,
+        .compareEnable = VK_FALSE,
+        .compareOp = VK_COMPARE_OP_ALWAYS,
+        .minLod = 0.0f,
+        .maxLod = 0.0f,
+        .borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK,
+        .unnormalizedCoordinates = VK_FALSE
+    };
+    VkSampler sampler;
+    check_result(vkCreateSampler(device, &sampler_create_info, nullptr, &sampler), MSG_SAMPLER_CREATE_FAILED);
+    this->m_sampler = unique_handle(device, sampler);
+
+    const VkDescriptorSetLayoutBinding bindings[2] = {
+        {
+            .binding = 0,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .pImmutableSamplers = &sampler
+        },
+        {
+            .binding = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .descriptorCount = LEVELS_PER_DISPATCH,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+            .pImmutableSamplers = nullptr
+        }
+    };
+    const VkDescriptorSetLayoutCreateInfo set_layout_create_info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .bindingCount = 2,
+        .pBindings = bindings
+    };
+    VkDescriptorSetLayout set_layout;
+    check_result(vkCreateDescriptorSetLayout(device, &set_layout_create_info, nullptr, &set_layout), MSG_SET_LAYOUT_CREATE_FAILED);
+    this->m_set_layout = unique_handle(device, set_layout);
+
+    const VkPushConstantRange push_constant_range = {
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .offset = 0,
+        .size = sizeof(PushConstants)
+    };
+    const VkPipelineLayoutCreateInfo pipeline_layout_create_info = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .setLayoutCount = 1,
+        .pSetLayouts = &set_layout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &push_constant_range
+    };
+    VkPipelineLayout pipeline_layout;
+    check_result(vkCreatePipelineLayout(device, &pipeline_layout_create_info, nullptr, &pipeline_layout), MSG_PIPELINE_LAYOUT_CREATE_FAILED);
+    this->m_pipeline_layout = unique_handle(device, pipeline_layout);
+
+    this->create_pipelines(device);
+}
+
+vka::MipGenerator::operator bool() const noexcept
+{
+    return (bool)this->m_pipeline_layout;
+}
+
+VkDevice vka::MipGenerator::parent() const noexcept
+{
+    return this->m_pipeline_layout.parent();
+}
+
+bool vka::MipGenerator::supports(const Texture& texture) const noexcept
+{
+    const VkFormat storage_format = detail::texture::storage_format(texture.format());
+    return this->m_write_without_format &&
+        texture.level_count() > 1 &&
+        texture.type() == VK_IMAGE_TYPE_2D &&
+        (texture.usage() & VK_IMAGE_USAGE_STORAGE_BIT) != 0 &&
+        format::supports_feature2(this->m_physical_device, storage_format, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT);
+}
+
+vka::MipResources vka::MipGenerator::generate(VkCommandBuffer cbo, Texture& texture, MipReduction reduction, VkPipelineStageFlags stages) const
+{
+    if (!this->supports(texture))
+    {
+        texture.finish(cbo, stages);
+        return {};
+    }
+
+    const VkDevice device = this->parent();
+    const uint32_t level_count = texture.level_count();
+    const uint32_t dispatch_count = (level_count - 1 + LEVELS_PER_DISPATCH - 1) / LEVELS_PER_DISPATCH;
+    const VkFormat storage_format = detail::texture::storage_format(texture.format());
+    const bool srgb = storage_format != texture.format();
+    MipResources resources;
+
+    // Every dispatch gets its own set, because the sets of all dispatches are in use at the same time.
+    const VkDescriptorPoolSize pool_sizes[2] = {
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, dispatch_count },
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, dispatch_count * LEVELS_PER_DISPATCH }
+    };
+    const VkDescriptorPoolCreateInfo pool_create_info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .maxSets = dispatch_count,
+        .poolSizeCount = 2,
+        .pPoolSizes = pool_sizes
+    };
+    VkDescriptorPool pool;
+    check_result(vkCreateDescriptorPool(device, &pool_create_info, nullptr, &pool), MSG_POOL_CREATE_FAILED);
+    resources.m_pool = unique_handle(device, pool);
+
+    const std::vector<VkDescriptorSetLayout> set_layouts(dispatch_count, this->m_set_layout.get());
+    const VkDescriptorSetAllocateInfo set_allocate_info = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .descriptorPool = pool,
+        .descriptorSetCount = dispatch_count,
+        .pSetLayouts = set_layouts.data()
+    };
+    std::vector<VkDescriptorSet> sets(dispatch_count);
+    check_result(vkAllocateDescriptorSets(device, &set_allocate_info, sets.data()), MSG_SET_ALLOCATE_FAILED);
+
+    // Views of the levels [1, level_count), which are written, and of the base level of every dispatch, which is read.
+    std::vector<VkDescriptorImageInfo> storage_infos(level_count - 1);
+    for (uint32_t level = 1; level < level_count; level++)
+    {
+        resources.m_views.push_back(create_view(texture, storage_format, VK_IMAGE_USAGE_STORAGE_BIT, level, 1));
+        storage_infos[level - 1] = { VK_NULL_HANDLE, resources.m_views.back().get(), VK_IMAGE_LAYOUT_GENERAL };
+    }
+
+    std::vector<VkDescriptorImageInfo> base_infos(dispatch_count);
+    std::vector<VkDescriptorImageInfo> level_infos(dispatch_count * LEVELS_PER_DISPATCH);
+    std::vector<VkWriteDescriptorSet> writes(dispatch_count * 2);
+    for (uint32_t i = 0; i < dispatch_count; i++)
+    {
+        const uint32_t base_level = i * LEVELS_PER_DISPATCH;
+        resources.m_views.push_back(create_view(texture, texture.format(), VK_IMAGE_USAGE_SAMPLED_BIT, base_level, 1));
+        base_infos[i] = { VK_NULL_HANDLE, resources.m_views.back().get(), VK_IMAGE_LAYOUT_GENERAL };
+
+        // Levels beyond the texture are bound to its last level, but they are not written by the shader.
+        for (uint32_t j = 0; j < LEVELS_PER_DISPATCH; j++)
+            level_infos[i * LEVELS_PER_DISPATCH + j] = storage_infos[std::min(base_level + j, level_count - 2)];
+
+        writes[i * 2] = {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .pNext = nullptr,
+            .dstSet = sets[i],
+            .dstBinding = 0,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .pImageInfo = base_infos.data() + i,
+            .pBufferInfo = nullptr,
+            .pTexelBufferView = nullptr
+        };
+        writes[i * 2 + 1] = {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .pNext = nullptr,
+            .dstSet = sets[i],
+            .dstBinding = 1,
+            .dstArrayElement = 0,
+            .descriptorCount = LEVELS_PER_DISPATCH,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+            .pImageInfo = level_infos.data() + i * LEVELS_PER_DISPATCH,
+            .pBufferInfo = nullptr,
+            .pTexelBufferView = nullptr
+        };
+    }
+    vkUpdateDescriptorSets(device, (uint32_t)writes.size(), writes.data(), 0, nullptr);
+
+    // Level 0 was loaded with a transfer, all levels are read and written by the compute shader in the general layout.
+    barrier(
+        cbo, texture, 0, level_count,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_GENERAL,
+        VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+    );
+
+    const uint32_t pipeline = (uint32_t)reduction * 2 + (srgb ? 1 : 0);
+    vkCmdBindPipeline(cbo, VK_PIPELINE_BIND_POINT_COMPUTE, this->m_pipelines[pipeline].get());
+    for (uint32_t i = 0; i < dispatch_count; i++)
+    {
+        const uint32_t base_level = i * LEVELS_PER_DISPATCH;
+        if (i > 0)
+        {
+            // The base level of this dispatch is the last level of the previous one.
+            barrier(
+                cbo, texture, base_level, 1,
+                VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL,
+                VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+            );
+        }
+
+        const VkExtent3D base_extent = common::mip_extent(texture.size(), base_level);
+        const VkExtent3D first_extent = common::mip_extent(texture.size(), base_level + 1);
+        const PushConstants push_constants = {
+            .base_width = (int32_t)base_extent.width,
+            .base_height = (int32_t)base_extent.height,
+            .level_count = std::min(LEVELS_PER_DISPATCH, level_count - 1 - base_level)
+        };
+        vkCmdBindDescriptorSets(cbo, VK_PIPELINE_BIND_POINT_COMPUTE, this->m_pipeline_layout.get(), 0, 1, sets.data() + i, 0, nullptr);
+        vkCmdPushConstants(cbo, this->m_pipeline_layout.get(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PushConstants), &push_constants);
+        vkCmdDispatch(
+            cbo,
+            (first_extent.width + TILE_SIZE - 1) / TILE_SIZE,
+            (first_extent.height + TILE_SIZE - 1) / TILE_SIZE,
+            texture.layer_count()
+        );
+    }
+
+    barrier(
+        cbo, texture, 0, level_count,
+        VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, stages
+    );
+    return resources;
+}
+
+void vka::MipGenerator::destroy() noexcept
+{
+    for (unique_handle<VkPipeline>& pipeline : this->m_pipelines)
+        pipeline = VK_NULL_HANDLE;
+    this->m_pipeline_layout = VK_NULL_HANDLE;
+    this->m_set_layout = VK_NULL_HANDLE;
+    this->m_sampler = VK_NULL_HANDLE;
+    this->m_physical_device = VK_NULL_HANDLE;
+    this->m_write_without_format = false;
+}
+
+void vka::MipGenerator::create_pipelines(VkDevice device)
+{
+    const VkShaderModuleCreateInfo module_create_info = {
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .codeSize = sizeof(vka_mipmap_comp),
+        .pCode = vka_mipmap_comp
+    };
+    VkShaderModule shader_module;
+    check_result(vkCreateShaderModule(device, &module_create_info, nullptr, &shader_module), MSG_SHADER_CREATE_FAILED);
+    const unique_handle module_guard(device, shader_module);
+
+    // The reduction and the sRGB encoding are specialization constants, so that the shader has no runtime branches.
+    struct Specialization
+    {
+        uint32_t reduction;
+        VkBool32 srgb;
+    };
+    const VkSpecializationMapEntry entries[2] = {
+        { 0, offsetof(Specialization, reduction), sizeof(uint32_t) },
+        { 1, offsetof(Specialization, srgb), sizeof(VkBool32) }
+    };
+
+    std::array<Specialization, PIPELINE_COUNT> specializations;
+    std::array<VkSpecializationInfo, PIPELINE_COUNT> specialization_infos;
+    std::array<VkComputePipelineCreateInfo, PIPELINE_COUNT> pipeline_create_infos;
+    for (uint32_t i = 0; i < PIPELINE_COUNT; i++)
+    {
+        specializations[i] = { i / 2, i % 2 == 1 ? VK_TRUE : VK_FALSE };
+        specialization_infos[i] = {
+            .mapEntryCount = 2,
+            .pMapEntries = entries,
+            .dataSize = sizeof(Specialization),
+            .pData = specializations.data() + i
+        };
+        pipeline_create_infos[i] = {
+            .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+            .pNext = nullptr,
+            .flags = 0,
+            .stage = {
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .pNext = nullptr,
+                .flags = 0,
+                .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                .module = shader_module,
+                .pName = "main",
+                .pSpecializationInfo = specialization_infos.data() + i
+            },
+            .layout = this->m_pipeline_layout.get(),
+            .basePipelineHandle = VK_NULL_HANDLE,
+            .basePipelineIndex = -1
+        };
+    }
+
+    std::array<VkPipeline, PIPELINE_COUNT> pipelines;
+    pipelines.fill(VK_NULL_HANDLE);
+    const VkResult result = vkCreateComputePipelines(device, VK_NULL_HANDLE, PIPELINE_COUNT, pipeline_create_infos.data(), nullptr, pipelines.data());
+
+    // Pipelines that were created are destroyed, if creating another one failed.
+    for (uint32_t i = 0; i < PIPELINE_COUNT; i++)
+    {
+        if (pipelines[i] != VK_NULL_HANDLE)
+            this->m_pipelines[i] = unique_handle(device, pipelines[i]);
+    }
+    check_result(result, MSG_PIPELINE_CREATE_FAILED);
+}
+
+vka::unique_handle<VkImageView> vka::MipGenerator::create_view(const Texture& texture, VkFormat format, VkImageUsageFlags usage, uint32_t base_level, uint32_t level_count)
+{
+    // The usage is restricted, because the format of the view may not support all usages of the image.
+    const VkImageViewUsageCreateInfo usage_create_info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+        .pNext = nullptr,
+        .usage = usage
+    };
+    const VkImageViewCreateInfo view_create_info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .pNext = &usage_create_info,
+        .flags = 0,
+        .image = texture.image(),
+        .viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY,
+        .format = format,
+        .components = {
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY,
+            VK_COMPONENT_SWIZZLE_IDENTITY
+        },
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = base_level,
+            .levelCount = level_count,
+            .baseArrayLayer = 0,
+            .layerCount = texture.layer_count()
+        }
+    };
+    VkImageView view;
+    check_result(vkCreateImageView(texture.parent(), &view_create_info, nullptr, &view), MSG_VIEW_CREATE_FAILED);
+    return unique_handle(texture.parent(), view);
+}
+
+void vka::MipGenerator::barrier(VkCommandBuffer cbo, const Texture& texture, uint32_t base_level, uint32_t level_count, VkImageLayout old_layout, VkImageLayout new_layout, VkAccessFlags src_access, VkAccessFlags dst_access, VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages) noexcept
+{
+    const VkImageMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = src_access,
+        .dstAccessMask = dst_access,
+        .oldLayout = old_layout,
+        .newLayout = new_layout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = texture.image(),
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = base_level,
+            .levelCount = level_count,
+            .baseArrayLayer = 0,
+            .layerCount = texture.layer_count()
+        }
+    };
+    vkCmdPipelineBarrier(cbo, src_stages, dst_stages, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
@@ -0,0 +1,206 @@
+/**
+ * @brief Generates the mip-map levels of textures with a compute shader.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+namespace vka
+{
+    /// Specifies how 2x2 texels are reduced to one texel of the next level by a <c>MipGenerator</c>.
+    enum class MipReduction
+    {
+        /// Averages the texels, which is the same as the linear filter of a blit.
+        AVERAGE,
+        /// Takes the minimum of every component, e.g. for hierarchical depth buffers with reversed depth.
+        MIN,
+        /// Takes the maximum of every component, e.g. for hierarchical depth buffers.
+        MAX
+    };
+
+    /**
+     * Resources of mip-map levels generated by a <c>MipGenerator</c>. They are referenced by the recorded commands and
+     * must be kept alive until the command buffer has been executed, like the staging buffer returned by
+     * <c>Texture::load()</c>.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates empty resources, which are returned if the levels were blitted.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Destroys the descriptor pool and the image views. After destroying the object is empty.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     */
+    class MipResources final
+    {
+    public:
+        /// Creates empty resources.
+        MipResources() = default;
+
+        /// @return Returns whether the levels were generated with the compute shader.
+        explicit operator bool() const noexcept;
+
+        /// Destroys the resources.
+        void destroy() noexcept;
+
+        // default:
+        MipResources(MipResources&&) = default;
+        ~MipResources() = default;
+        MipResources& operator= (MipResources&&) = default;
+
+    private:
+        friend class MipGenerator;
+
+        unique_handle<VkDescriptorPool> m_pool;
+        std::vector<unique_handle<VkImageView>> m_views;
+    };
+
+    /**
+     * Generates the mip-map levels of textures with a compute shader instead of blitting them level by level. Every
+     * dispatch reduces tiles of 64x64 texels of a base level to 6 further levels in shared memory of the work groups,
+     * which covers textures up to 4096x4096 texels with 2 dispatches. All layers of a texture array are processed by
+     * the same dispatch, whereas <c>Texture::finish()</c> needs a blit and a barrier for every level. The levels are
+     * written through storage image views of the levels.
+     * The compute shader is used for 2D textures that were created with <c>VK_IMAGE_USAGE_STORAGE_BIT</c>, whose
+     * format supports storage images and if <c>shaderStorageImageWriteWithoutFormat</c> is enabled for the device. sRGB
+     * textures are averaged in linear space and written through an UNORM view. Otherwise, the levels are blitted by
+     * <c>Texture::finish()</c>, which always averages. Use <c>supports()</c> to check which one is used.
+     * The texel coordinates of a level are halved and rounded down. For odd extents, this drops the last row or column
+     * of texels, like a blit with a box filter.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates an <b>empty</b> mip generator. This empty object is invalid and cannot perform
+     * any actions. Calling <c>parent()</c> returns <c>VK_NULL_HANDLE</c>. Calling <c>destroy()</c> does nothing.
+     *
+     * <b>Initialization:</b>\n
+     * The initialization constructor creates the pipelines of all reductions.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Destroys the pipelines. The device must not execute any generation anymore. After destroying the object is an
+     * <b>empty</b> mip generator.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class can be created and used from any thread. <c>generate()</c> does not modify the generator and can be
+     * called from multiple threads at the same time.
+     *
+     * <b>Actions:</b>
+     * - <b>generating</b> -- Invoked by <c>generate()</c> records the commands that create the mip-map levels and
+     * finishes the texture.
+     */
+    class MipGenerator final
+    {
+    public:
+        /// Creates an empty mip generator. This mip generator is invalid.
+        MipGenerator() noexcept;
+
+        /**
+         * Creates the mip generator. The mip generator is valid if no exception was thrown.
+         * @param device Device with which the pipelines are created.
+         * @param physical_device Physical device of the device, whose format features are queried.
+         * @param write_without_format Specifies whether <c>shaderStorageImageWriteWithoutFormat</c> was enabled when
+         * creating the device. If it is false, the levels are always blitted.
+         * @throw std::runtime_error Is thrown, if creating the shader module, the sampler, the layouts or the pipelines
+         * failed.
+         */
+        MipGenerator(VkDevice device, VkPhysicalDevice physical_device, bool write_without_format);
+
+        /// @return Returns whether the mip generator is valid.
+        explicit operator bool() const noexcept;
+
+        /// @return Returns the parent handle.
+        VkDevice parent() const noexcept;
+
+        /**
+         * @param texture Texture whose levels should be generated.
+         * @return Returns whether the levels of the texture are generated with the compute shader.
+         */
+        bool supports(const Texture& texture) const noexcept;
+
+        /**
+         * Generates the mip-map levels of a texture and finishes it. This replaces <c>Texture::finish()</c>. Level 0
+         * must have been loaded and the texture must be in the state after loading. After that the texture is ready to
+         * be used in the layout <c>VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL</c>.
+         * @param cbo Command buffer in which the commands are recorded, whose queue must support compute.
+         * @param texture Texture whose levels are generated.
+         * @param reduction Specifies how the texels are reduced. It is ignored, if the levels are blitted.
+         * @param stages Pipeline stages in which the texture is used.
+         * @return Returns the resources of the generation, which are empty if the levels were blitted.
+         * @throw std::runtime_error Is thrown, if creating the image views or the descriptor sets failed.
+         */
+        [[nodiscard]]
+        MipResources generate(VkCommandBuffer cbo, Texture& texture, MipReduction reduction, VkPipelineStageFlags stages) const;
+
+        /// Destroys the mip generator. After destroying the mip generator is empty and therefore invalid.
+        void destroy() noexcept;
+
+        // default:
+        MipGenerator(MipGenerator&&) = default;
+        ~MipGenerator() = default;
+        MipGenerator& operator= (MipGenerator&&) = default;
+
+    private:
+        static constexpr const char* MSG_SHADER_CREATE_FAILED = "[vka::MipGenerator]: Failed to create shader module.";
+        static constexpr const char* MSG_SAMPLER_CREATE_FAILED = "[vka::MipGenerator]: Failed to create sampler.";
+        static constexpr const char* MSG_SET_LAYOUT_CREATE_FAILED = "[vka::MipGenerator]: Failed to create descriptor set layout.";
+        static constexpr const char* MSG_PIPELINE_LAYOUT_CREATE_FAILED = "[vka::MipGenerator]: Failed to create pipeline layout.";
+        static constexpr const char* MSG_PIPELINE_CREATE_FAILED = "[vka::MipGenerator]: Failed to create pipelines.";
+        static constexpr const char* MSG_POOL_CREATE_FAILED = "[vka::MipGenerator]: Failed to create descriptor pool.";
+        static constexpr const char* MSG_SET_ALLOCATE_FAILED = "[vka::MipGenerator]: Failed to allocate descriptor sets.";
+        static constexpr const char* MSG_VIEW_CREATE_FAILED = "[vka::MipGenerator]: Failed to create image view.";
+
+        /// Number of levels that are generated by a single dispatch, which must match the compute shader.
+        static constexpr uint32_t LEVELS_PER_DISPATCH = 6;
+
+        /// Number of texels of a level, which are written by a work group in one dimension.
+        static constexpr uint32_t TILE_SIZE = 32;
+
+        /// One pipeline per reduction, without and with sRGB encoding.
+        static constexpr uint32_t PIPELINE_COUNT = 6;
+
+        struct PushConstants
+        {
+            int32_t base_width;
+            int32_t base_height;
+            uint32_t level_count;
+        };
+
+        VkPhysicalDevice m_physical_device;
+        bool m_write_without_format;
+        unique_handle<VkSampler> m_sampler;
+        unique_handle<VkDescriptorSetLayout> m_set_layout;
+        unique_handle<VkPipelineLayout> m_pipeline_layout;
+        std::array<unique_handle<VkPipeline>, PIPELINE_COUNT> m_pipelines;
+
+        /// Creates the pipelines of all reductions from the embedded compute shader.
+        void create_pipelines(VkDevice device);
+
+        /// Creates a view of levels [base_level, base_level + level_count) of all layers of a texture.
+        static unique_handle<VkImageView> create_view(const Texture& texture, VkFormat format, VkImageUsageFlags usage, uint32_t base_level, uint32_t level_count);
+
+        /// Records a barrier for the levels [base_level, base_level + level_count) of all layers of a texture.
+        static void barrier(VkCommandBuffer cbo, const Texture& texture, uint32_t base_level, uint32_t level_count, VkImageLayout old_layout, VkImageLayout new_layout, VkAccessFlags src_access, VkAccessFlags dst_access, VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages) noexcept;
+    };
+}
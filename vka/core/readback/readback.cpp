@@ -0,0 +1,419 @@
+/**
+ * @brief Implementation for the asynchronous readback.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+vka::Readback::Readback(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const ReadbackCreateInfo& create_info) :
+    m_device(device),
+    m_pool(create_info.commandPool),
+    m_properties(properties),
+    m_create_info(create_info)
+{
+    if (this->m_create_info.stagingSize == 0)
+        this->m_create_info.stagingSize = DEFAULT_STAGING_SIZE;
+}
+
+vka::Readback::Readback(Readback&& src) noexcept :
+    m_device(src.m_device),
+    m_pool(src.m_pool),
+    m_properties(src.m_properties),
+    m_create_info(src.m_create_info),
+    m_requests(std::move(src.m_requests)),
+    m_submissions(std::move(src.m_submissions)),
+    m_recycled(std::move(src.m_recycled))
+{
+    src.m_device = VK_NULL_HANDLE;
+}
+
+vka::Readback::~Readback()
+{
+    this->destroy();
+}
+
+vka::Readback& vka::Readback::operator= (Readback&& src) noexcept
+{
+    this->destroy();
+    this->m_device = src.m_device;
+    this->m_pool = src.m_pool;
+    this->m_properties = src.m_properties;
+    this->m_create_info = src.m_create_info;
+    this->m_requests = std::move(src.m_requests);
+    this->m_submissions = std::move(src.m_submissions);
+    this->m_recycled = std::move(src.m_recycled);
+    src.m_device = VK_NULL_HANDLE;
+    return *this;
+}
+
+void vka::Readback::destroy() noexcept
+{
+    if (this->m_device == VK_NULL_HANDLE)
+        return;
+
+    // The command buffers and the staging buffers must not be released while they are still in use. The promises of
+    // pending reads are destroyed, which abandons their futures.
+    std::vector<VkFence> fences;
+    fences.reserve(this->m_submissions.size());
+    for (const Submission& submission : this->m_submissions)
+        fences.push_back(submission.fence.get());
+    if (!fences.empty())
+        vkWaitForFences(this->m_device, static_cast<uint32_t>(fences.size()), fences.data(), VK_TRUE, NO_TIMEOUT);
+
+    for (const Submission& submission : this->m_submissions)
+        vkFreeCommandBuffers(this->m_device, this->m_pool, 1, &submission.cbo);
+    for (const Submission& submission : this->m_recycled)
+        vkFreeCommandBuffers(this->m_device, this->m_pool, 1, &submission.cbo);
+    this->m_requests.clear();
+    this->m_submissions.clear();
+    this->m_recycled.clear();
+
+    this->m_device = VK_NULL_HANDLE;
+    this->m_pool = VK_NULL_HANDLE;
+}
+
+vka::ReadbackFuture vka::Readback::read(const Buffer& src, VkDeviceSize size, VkDeviceSize offset)
+{
+    Request& request = this->m_requests.emplace_back();
+    request.buffer = src.handle();
+    request.image = VK_NULL_HANDLE;
+    request.offset = offset;
+    request.layers = {};
+    request.extent = {};
+    request.size = size;
+    request.alignment = STAGING_ALIGNMENT;
+    request.staging_offset = 0;
+    return request.promise.get_future();
+}
+
+vka::ReadbackFuture vka::Readback::read(const Texture& src, uint32_t layer, uint32_t level)
+{
+    // The size of the copy is determined by the format of the image, so it is taken from the texture.
+    const VkFormat format = src.format();
+    const size_t texel_size = format_sizeof(format);
+    if (texel_size == 0 || texel_size == NSIZE) [[unlikely]]
+        detail::error::throw_invalid_argument(MSG_INVALID_FORMAT);
+
+    // Block-compressed formats are read in whole blocks. The buffer offset of the copy must be a multiple of the texel
+    // or block size and of 4.
+    const VkExtent3D extent = common::mip_extent(src.size(), level);
+    const VkExtent2D block = TextureContainer::block_extent(format);
+    const VkDeviceSize blocks_x = (extent.width + block.width - 1) / block.width;
+    const VkDeviceSize blocks_y = (extent.height + block.height - 1) / block.height;
+    Request& request = this->m_requests.emplace_back();
+    request.buffer = VK_NULL_HANDLE;
+    request.image = src.image();
+    request.offset = 0;
+    request.layers = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .mipLevel = level,
+        .baseArrayLayer = layer,
+        .layerCount = 1
+    };
+    request.extent = extent;
+    request.size = blocks_x * blocks_y * extent.depth * texel_size;
+    request.alignment = std::lcm(static_cast<VkDeviceSize>(texel_size), VkDeviceSize(4));
+    request.staging_offset = 0;
+    return request.promise.get_future();
+}
+
+void vka::Readback::submit(VkQueue queue)
+{
+    if (this->m_requests.empty())
+        return;
+
+    // All reads of a submission are packed into the same staging buffer. The alignment of texture reads is not
+    // necessarily a power of 2.
+    VkDeviceSize staging_size = 0;
+    for (Request& request : this->m_requests)
+    {
+        request.staging_offset = (staging_size + request.alignment - 1) / request.alignment * request.alignment;
+        staging_size = request.staging_offset + request.size;
+    }
+
+    Submission submission = this->acquire();
+    if (!submission.staging || submission.staging.size() < staging_size)
+    {
+        try
+        {
+            submission.staging = this->create_staging(std::max(staging_size, this->m_create_info.stagingSize));
+        }
+        catch (...)
+        {
+            this->m_recycled.push_back(std::move(submission));
+            throw;
+        }
+    }
+
+    // A failed submission is recycled, so that its command buffer is not lost. The command buffer is implicitly reset
+    // by the next vkBeginCommandBuffer.
+    constexpr VkCommandBufferBeginInfo begin_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = nullptr,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = nullptr
+    };
+    VkResult res = vkBeginCommandBuffer(submission.cbo, &begin_info);
+    if (is_error(res)) [[unlikely]]
+        this->m_recycled.push_back(std::move(submission));
+    check_result(res, MSG_CBO_BEGIN_FAILED);
+
+    record(submission.cbo, submission.staging.handle(), this->m_requests);
+    res = vkEndCommandBuffer(submission.cbo);
+    if (is_error(res)) [[unlikely]]
+        this->m_recycled.push_back(std::move(submission));
+    check_result(res, MSG_CBO_END_FAILED);
+
+    const VkFence fence = submission.fence.get();
+    res = vkResetFences(this->m_device, 1, &fence);
+    if (is_error(res)) [[unlikely]]
+        this->m_recycled.push_back(std::move(submission));
+    check_result(res, MSG_FENCE_RESET_FAILED);
+
+    const VkSubmitInfo submit_info = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = nullptr,
+        .waitSemaphoreCount = 0,
+        .pWaitSemaphores = nullptr,
+        .pWaitDstStageMask = nullptr,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &submission.cbo,
+        .signalSemaphoreCount = 0,
+        .pSignalSemaphores = nullptr
+    };
+    res = vkQueueSubmit(queue, 1, &submit_info, fence);
+    if (is_error(res)) [[unlikely]]
+        this->m_recycled.push_back(std::move(submission));
+    check_result(res, MSG_SUBMIT_FAILED);
+
+    submission.requests = std::move(this->m_requests);
+    this->m_requests.clear();
+    this->m_submissions.push_back(std::move(submission));
+}
+
+uint32_t vka::Readback::poll()
+{
+    // Submissions are not necessarily executed in order, if they have been submitted to different queues.
+    uint32_t count = 0;
+    for (size_t i = 0; i < this->m_submissions.size();)
+    {
+        const VkResult res = vkGetFenceStatus(this->m_device, this->m_submissions[i].fence.get());
+        check_result(res, MSG_FENCE_STATUS_FAILED);
+        if (res == VK_SUCCESS)
+        {
+            this->complete(i);
+            count++;
+        }
+        else
+            i++;
+    }
+    return count;
+}
+
+VkResult vka::Readback::wait(uint64_t timeout)
+{
+    if (this->m_submissions.empty())
+        return VK_SUCCESS;
+
+    std::vector<VkFence> fences;
+    fences.reserve(this->m_submissions.size());
+    for (const Submission& submission : this->m_submissions)
+        fences.push_back(submission.fence.get());
+    const VkResult res = vkWaitForFences(this->m_device, static_cast<uint32_t>(fences.size()), fences.data(), VK_TRUE, timeout);
+    check_result(res, MSG_FENCE_WAIT_FAILED);
+    if (res == VK_SUCCESS)
+    {
+        while (!this->m_submissions.empty())
+            this->complete(this->m_submissions.size() - 1);
+    }
+    return res;
+}
+
+vka::Readback::Submission vka::Readback::acquire()
+{
+    if (!this->m_recycled.empty())
+    {
+        Submission submission = std::move(this->m_recycled.back());
+        this->m_recycled.pop_back();
+        return submission;
+    }
+
+    const VkCommandBufferAllocateInfo alloc_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .commandPool = this->m_pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+    Submission submission;
+    check_result(vkAllocateCommandBuffers(this->m_device, &alloc_info, &submission.cbo), MSG_CBO_ALLOC_FAILED);
+
+    // The fence is created signaled, because every submission resets it before submitting.
+    constexpr VkFenceCreateInfo fence_info = {
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = VK_FENCE_CREATE_SIGNALED_BIT
+    };
+    VkFence fence;
+    const VkResult res = vkCreateFence(this->m_device, &fence_info, nullptr, &fence);
+    if (is_error(res)) [[unlikely]]
+        vkFreeCommandBuffers(this->m_device, this->m_pool, 1, &submission.cbo);
+    check_result(res, MSG_FENCE_CREATE_FAILED);
+    submission.fence = unique_handle(this->m_device, fence);
+    return submission;
+}
+
+void vka::Readback::record(VkCommandBuffer cbo, VkBuffer staging, const std::vector<Request>& requests)
+{
+    // Textures are transitioned into the transfer layout and back. A subresource that is read more than once only
+    // gets a single pair of transitions.
+    std::vector<VkImageMemoryBarrier> to_transfer, to_shader;
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        const Request& request = requests[i];
+        if (request.image == VK_NULL_HANDLE)
+            continue;
+        const bool duplicate = std::any_of(requests.begin(), requests.begin() + i, [&request](const Request& other) {
+            return other.image == request.image && other.layers.mipLevel == request.layers.mipLevel && other.layers.baseArrayLayer == request.layers.baseArrayLayer;
+        });
+        if (duplicate)
+            continue;
+
+        const VkImageSubresourceRange range = {
+            .aspectMask = request.layers.aspectMask,
+            .baseMipLevel = request.layers.mipLevel,
+            .levelCount = 1,
+            .baseArrayLayer = request.layers.baseArrayLayer,
+            .layerCount = request.layers.layerCount
+        };
+        to_transfer.push_back({
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .pNext = nullptr,
+            .srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = request.image,
+            .subresourceRange = range
+        });
+        to_shader.push_back({
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .pNext = nullptr,
+            .srcAccessMask = 0,
+            .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = request.image,
+            .subresourceRange = range
+        });
+    }
+
+    // The copies wait for all previously submitted writes.
+    const VkMemoryBarrier read_barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT
+    };
+    vkCmdPipelineBarrier(
+        cbo,
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        1,
+        &read_barrier,
+        0,
+        nullptr,
+        static_cast<uint32_t>(to_transfer.size()),
+        to_transfer.data()
+    );
+
+    for (const Request& request : requests)
+    {
+        if (request.image == VK_NULL_HANDLE)
+        {
+            const VkBufferCopy region = { request.offset, request.staging_offset, request.size };
+            vkCmdCopyBuffer(cbo, request.buffer, staging, 1, &region);
+        }
+        else
+        {
+            const VkBufferImageCopy region = {
+                .bufferOffset = request.staging_offset,
+                .bufferRowLength = 0,
+                .bufferImageHeight = 0,
+                .imageSubresource = request.layers,
+                .imageOffset = { 0, 0, 0 },
+                .imageExtent = request.extent
+            };
+            vkCmdCopyImageToBuffer(cbo, request.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging, 1, &region);
+        }
+    }
+
+    // The staging memory is made visible to the host, the textures are returned to the shaders.
+    const VkMemoryBarrier host_barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_HOST_READ_BIT
+    };
+    vkCmdPipelineBarrier(
+        cbo,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+        0,
+        1,
+        &host_barrier,
+        0,
+        nullptr,
+        static_cast<uint32_t>(to_shader.size()),
+        to_shader.data()
+    );
+}
+
+void vka::Readback::complete(size_t index)
+{
+    Submission& submission = this->m_submissions[index];
+    submission.staging.invalidate();
+
+    const uint8_t* const map = static_cast<const uint8_t*>(submission.staging.map());
+    for (Request& request : submission.requests)
+    {
+        const uint8_t* const begin = map + request.staging_offset;
+        request.promise.set_value(std::vector<uint8_t>(begin, begin + request.size));
+    }
+    submission.requests.clear();
+
+    this->m_recycled.push_back(std::move(submission));
+    this->m_submissions.erase(this->m_submissions.begin() + static_cast<ptrdiff_t>(index));
+}
+
+vka::Buffer vka::Readback::create_staging(VkDeviceSize size) const
+{
+    // Host-cached memory is much faster to read from than write-combined memory, but may not be host-coherent.
+    const BufferCreateInfo create_info = {
+        .pBufferNext = nullptr,
+        .bufferFlags = 0,
+        .bufferSize = size,
+        .bufferUsage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        .bufferSharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .bufferQueueFamilyIndexCount = 1,
+        .bufferQueueFamilyIndices = &this->m_create_info.queueFamilyIndex,
+        .pMemoryNext = nullptr,
+        .memoryType = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+        .memoryTypePreferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+        .memoryTypeForbidden = 0,
+        .memoryAllocator = this->m_create_info.memoryAllocator,
+        .memoryNonCoherentAtomSize = this->m_create_info.memoryNonCoherentAtomSize,
+        .memoryPersistentMap = true,
+        .memoryTracker = this->m_create_info.memoryTracker,
+        .memoryDebugName = "vka::Readback staging"
+    };
+    return Buffer(this->m_device, this->m_properties, create_info);
+}
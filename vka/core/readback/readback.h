@@ -0,0 +1,226 @@
+/**
+ * @brief Asynchronous readback of buffer and texture data to the host.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+namespace vka
+{
+    /**
+     * Structure specifying the parameters of a newly created readback object. Parameters prefixed with <c>memory</c>
+     * correspond to the parameters of <c>BufferCreateInfo</c> and are used for the staging buffers.
+     * - <c>commandPool</c> -- Pool from which the command buffers are allocated. It must be created with
+     * <c>VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT</c>, because the command buffers are recycled.
+     * - <c>queueFamilyIndex</c> -- Queue family of the staging buffers, the same as the one of the command pool.
+     * - <c>stagingSize</c> -- Minimum size of a staging buffer. All reads of a submission share the same staging
+     * buffer. If it is <c>0</c>, <c>Readback::DEFAULT_STAGING_SIZE</c> is used.
+     */
+    struct ReadbackCreateInfo
+    {
+        VkCommandPool           commandPool;
+        uint32_t                queueFamilyIndex;
+        MemoryAllocator*        memoryAllocator;
+        VkDeviceSize            memoryNonCoherentAtomSize;
+        MemoryTracker*          memoryTracker;
+        VkDeviceSize            stagingSize;
+    };
+
+    /// Data that has been read back from the device.
+    using ReadbackFuture = std::future<std::vector<uint8_t>>;
+
+    /**
+     * Reads data of buffers and textures back to the host without blocking the queue. Reads are collected and
+     * submitted with a single command buffer, which copies the data into host-cached staging memory. Every read returns
+     * a future, which becomes ready when <c>poll()</c> detects that its submission has been executed. Then, the staging
+     * memory is invalidated, the data is copied into the future and the command buffer, the fence and the staging
+     * buffer are recycled for the next submission. Therefore, the render thread only has to call <c>poll()</c> once per
+     * frame, while other threads can wait for the futures.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates an <b>empty</b> readback object. This empty object is invalid and cannot perform
+     * any actions. Calling <c>parent()</c> returns <c>VK_NULL_HANDLE</c>. Calling <c>destroy()</c> does nothing.
+     *
+     * <b>Initialization:</b>\n
+     * The initialization constructor creates a valid readback object without any reads.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Waits until all submissions have been executed, frees the command buffers, destroys the fences and releases the
+     * staging buffers. Futures of reads which have not been completed by <c>poll()</c> or <c>wait()</c> are abandoned
+     * and throw <c>std::future_error</c>. After destroying the object is an <b>empty</b> readback object.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class can be created and used from any thread. However, if you use this class across multiple threads,
+     * actions must be externally synchronized. The returned futures can be used from any thread.
+     *
+     * <b>Actions:</b>
+     * - <b>read</b> -- Invoked by <c>read()</c> adds a read of a buffer region or a texture subresource.
+     * - <b>submission</b> -- Invoked by <c>submit()</c> records and submits all added reads.
+     * - <b>completion</b> -- Invoked by <c>poll()</c> or <c>wait()</c> completes the futures of executed submissions.
+     */
+    class Readback final
+    {
+    public:
+        /// Default minimum size of a staging buffer.
+        static constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 16ull * 1024 * 1024;
+
+        /// Creates an empty readback object. This object is invalid.
+        constexpr Readback() noexcept;
+
+        /**
+         * Creates the readback object. The object is valid if no exception was thrown.
+         * @param device Device with which the readback object is created.
+         * @param properties Memory properties of the physical device.
+         * @param create_info Create-info for the readback object.
+         */
+        explicit Readback(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const ReadbackCreateInfo& create_info);
+
+        /// Moves a readback object. The source object becomes invalidated and using to results in undefined behaviour.
+        Readback(Readback&& src) noexcept;
+
+        /// Waits for all submissions and destroys the readback object.
+        ~Readback();
+
+        /**
+         * Moves a readback object. The source object becomes invalidated and using to results in undefined behaviour.
+         * An already created object is destroyed.
+         */
+        Readback& operator= (Readback&& src) noexcept;
+
+        /// @return Returns whether the readback object is valid.
+        explicit constexpr operator bool() const noexcept;
+
+        /// @return Returns the parent handle.
+        constexpr VkDevice parent() const noexcept;
+
+        /// @return Returns the number of reads which have not been submitted yet.
+        constexpr size_t queued_count() const noexcept;
+
+        /// @return Returns the number of submissions which have not been completed yet.
+        constexpr size_t submission_count() const noexcept;
+
+        /// Destroys the readback object. After destroying the object is empty and therefore invalid.
+        void destroy() noexcept;
+
+        /**
+         * Adds a read of a buffer region.
+         * @param src Source buffer. Must be created with <c>VK_BUFFER_USAGE_TRANSFER_SRC_BIT</c>.
+         * @param size Number of bytes to read.
+         * @param offset Offset in bytes in the source buffer.
+         * @return Returns the future which receives the data.
+         * @throw std::bad_alloc Is thrown, if adding the read failed.
+         */
+        ReadbackFuture read(const Buffer& src, VkDeviceSize size, VkDeviceSize offset = 0);
+
+        /**
+         * Adds a read of a texture subresource. The texture must be finished, because it is read in the
+         * <c>VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL</c> layout. The data is tightly packed, block-compressed formats
+         * are read in whole blocks.
+         * @param src Source texture.
+         * @param layer Source array layer.
+         * @param level Source mip-map level.
+         * @return Returns the future which receives the data.
+         * @throw std::invalid_argument Is thrown, if the format of the texture has no texel size.
+         * @throw std::bad_alloc Is thrown, if adding the read failed.
+         */
+        ReadbackFuture read(const Texture& src, uint32_t layer = 0, uint32_t level = 0);
+
+        /**
+         * Records all added reads and submits them. The copies wait for all commands that have been submitted to the
+         * queue before. If no reads have been added, this function does nothing.
+         * @param queue Queue to which the reads are submitted.
+         * @throw std::runtime_error Is thrown, if creating a staging buffer, allocating, recording or submitting the
+         * command buffer or creating the fence failed.
+         */
+        void submit(VkQueue queue);
+
+        /**
+         * Completes the futures of all submissions which have been executed. This function does not block.
+         * @return Returns the number of completed submissions.
+         * @throw std::runtime_error Is thrown, if querying a fence status or invalidating staging memory failed.
+         */
+        uint32_t poll();
+
+        /**
+         * Waits until all submissions have been executed and completes their futures.
+         * @param timeout Optionally specifies a timeout value in nanoseconds.
+         * @return Only returns success codes like <c>VK_SUCCESS</c> or <c>VK_TIMEOUT</c>.
+         * @throw std::runtime_error Is thrown, if the wait operation or invalidating staging memory failed.
+         */
+        VkResult wait(uint64_t timeout = NO_TIMEOUT);
+
+        // deleted
+        Readback(const Readback&) = delete;
+        Readback& operator= (const Readback&) = delete;
+
+    private:
+        static constexpr const char* MSG_CBO_ALLOC_FAILED = "[vka::Readback]: Failed to allocate command buffer.";
+        static constexpr const char* MSG_CBO_BEGIN_FAILED = "[vka::Readback]: Failed to begin command buffer recording.";
+        static constexpr const char* MSG_CBO_END_FAILED = "[vka::Readback]: Failed to end command buffer recording.";
+        static constexpr const char* MSG_FENCE_CREATE_FAILED = "[vka::Readback]: Failed to create fence.";
+        static constexpr const char* MSG_FENCE_RESET_FAILED = "[vka::Readback]: Failed to reset fence.";
+        static constexpr const char* MSG_FENCE_STATUS_FAILED = "[vka::Readback]: Failed to query fence status.";
+        static constexpr const char* MSG_FENCE_WAIT_FAILED = "[vka::Readback]: Failed to wait for fences.";
+        static constexpr const char* MSG_SUBMIT_FAILED = "[vka::Readback]: Failed to submit command buffer.";
+        static constexpr const char* MSG_INVALID_FORMAT = "[vka::Readback]: Format has no texel size.";
+
+        /// Alignment of staging offsets of buffer reads. Offsets of texture reads are aligned to the texel size.
+        static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+        /// A buffer read has no image, a texture read has no buffer.
+        struct Request
+        {
+            VkBuffer buffer;
+            VkImage image;
+            VkDeviceSize offset;
+            VkImageSubresourceLayers layers;
+            VkExtent3D extent;
+            VkDeviceSize size;
+            VkDeviceSize alignment;
+            VkDeviceSize staging_offset;
+            std::promise<std::vector<uint8_t>> promise;
+        };
+
+        struct Submission
+        {
+            VkCommandBuffer cbo;
+            unique_handle<VkFence> fence;
+            Buffer staging;
+            std::vector<Request> requests;
+        };
+
+        VkDevice m_device;
+        VkCommandPool m_pool;
+        VkPhysicalDeviceMemoryProperties m_properties;
+        ReadbackCreateInfo m_create_info;
+        std::vector<Request> m_requests;
+        std::vector<Submission> m_submissions;
+        std::vector<Submission> m_recycled;
+
+        /// Returns a recycled submission or creates a new one.
+        Submission acquire();
+
+        /// Records the barriers and copies of all requests.
+        static void record(VkCommandBuffer cbo, VkBuffer staging, const std::vector<Request>& requests);
+
+        /// Copies the data of an executed submission into its futures and recycles the submission.
+        void complete(size_t index);
+
+        /// Creates a staging buffer.
+        Buffer create_staging(VkDeviceSize size) const;
+    };
+}
@@ -0,0 +1,38 @@
+/**
+ * @brief Inline implementation for the asynchronous readback.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+#include "readback.h"
+
+constexpr vka::Readback::Readback() noexcept :
+    m_device(VK_NULL_HANDLE),
+    m_pool(VK_NULL_HANDLE),
+    m_properties{},
+    m_create_info{}
+{}
+
+constexpr vka::Readback::operator bool() const noexcept
+{
+    return this->m_device != VK_NULL_HANDLE;
+}
+
+constexpr VkDevice vka::Readback::parent() const noexcept
+{
+    return this->m_device;
+}
+
+constexpr size_t vka::Readback::queued_count() const noexcept
+{
+    return this->m_requests.size();
+}
+
+constexpr size_t vka::Readback::submission_count() const noexcept
+{
+    return this->m_submissions.size();
+}
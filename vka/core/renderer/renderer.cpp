@@ -68,6 +68,14 @@ bool vka::Renderer::execute(VkQueue queue, const VkCommandBuffer* cbos, VkPipeli
     return this->preset_image(queue, sem_render, image_index, res);
 }
 
+uint32_t vka::Renderer::wait_frame()
+{
+    // The fence stays signaled, so waiting for it again in execute() returns immediately.
+    const uint32_t frame_index = this->frame_index();
+    this->wait_fence(this->m_context.get().fences[frame_index]);
+    return frame_index;
+}
+
 VkResult vka::Renderer::wait(uint64_t timeout)
 {
     const VkResult res = vkWaitForFences(this->m_context.parent(), this->m_context.get().fif_count, this->m_context.get().fences, VK_TRUE, timeout);
@@ -59,9 +59,28 @@ namespace vka
         /// @return Returns whether the renderer is valid.
         explicit constexpr operator bool() const noexcept;
 
+        /// @return Returns the number of frames in flight.
+        constexpr uint32_t frame_count() const noexcept;
+
+        /**
+         * @return Returns the index of the frame in flight that is rendered by the next call of <c>execute()</c>.
+         * @pre This function is only called on valid renderer objects.
+         */
+        constexpr uint32_t frame_index() const noexcept;
+
         /// Destroys the renderer. After destroying the renderer is empty and therefore invalid.
         constexpr void destroy() noexcept;
 
+        /**
+         * Waits until the frame in flight, that is rendered by the next call of <c>execute()</c>, is no longer used by
+         * the GPU. After this call, per-frame resources of that frame can be written by the host (see
+         * <c>FrameRingBuffer::begin_frame()</c>).
+         * @return Returns the index of the frame in flight.
+         * @throw std::runtime_error Is thrown, if the wait operation failed.
+         * @pre This function is only called on valid renderer objects.
+         */
+        uint32_t wait_frame();
+
         /**
          * Executes the render process.
          * @param queue Graphics queue to which the render commands are submitted.
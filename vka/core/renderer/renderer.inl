@@ -12,6 +12,16 @@ constexpr vka::Renderer::operator bool() const noexcept
     return (bool)this->m_context;
 }
 
+constexpr uint32_t vka::Renderer::frame_count() const noexcept
+{
+    return this->m_context.get().fif_count;
+}
+
+constexpr uint32_t vka::Renderer::frame_index() const noexcept
+{
+    return this->m_frame_index % this->m_context.get().fif_count;
+}
+
 constexpr void vka::Renderer::destroy() noexcept
 {
     this->m_window = nullptr;
@@ -0,0 +1,52 @@
+/**
+ * @brief Implementation for the frame ring buffer.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+vka::FrameRingBuffer::FrameRingBuffer(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const FrameRingBufferCreateInfo& create_info) :
+    FrameRingBuffer()
+{
+    if (create_info.frameSize == 0 || create_info.frameCount == 0) [[unlikely]]
+        detail::error::throw_invalid_argument(MSG_INVALID_SIZE);
+    if (create_info.sliceAlignment != 0 && !std::has_single_bit(create_info.sliceAlignment)) [[unlikely]]
+        detail::error::throw_invalid_argument(MSG_INVALID_ALIGNMENT);
+
+    // Every frame must begin at an aligned offset, therefore the frame size is rounded up to the alignment.
+    const VkDeviceSize alignment = create_info.sliceAlignment == 0 ? 1 : create_info.sliceAlignment;
+    this->m_frame_size = detail::memory::align_up(create_info.frameSize, alignment);
+    this->m_alignment = alignment;
+    this->m_frame_count = create_info.frameCount;
+
+    FrameRingBufferCreateInfo info = create_info;
+    info.frameSize = this->m_frame_size;
+    this->m_buffer = create_buffer(device, properties, info);
+    this->m_map = this->m_buffer.map();
+}
+
+vka::Buffer vka::FrameRingBuffer::create_buffer(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const FrameRingBufferCreateInfo& create_info)
+{
+    const BufferCreateInfo buffer_ci = {
+        .pBufferNext = nullptr,
+        .bufferFlags = 0,
+        .bufferSize = create_info.frameSize * create_info.frameCount,
+        .bufferUsage = create_info.bufferUsage,
+        .bufferSharingMode = create_info.bufferQueueFamilyIndexCount > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+        .bufferQueueFamilyIndexCount = create_info.bufferQueueFamilyIndexCount,
+        .bufferQueueFamilyIndices = create_info.bufferQueueFamilyIndices,
+        .pMemoryNext = nullptr,
+        .memoryType = create_info.memoryType | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+        .memoryTypePreferred = create_info.memoryTypePreferred,
+        .memoryTypeForbidden = 0,
+        .memoryAllocator = create_info.memoryAllocator,
+        .memoryNonCoherentAtomSize = create_info.memoryNonCoherentAtomSize,
+        .memoryPersistentMap = true,
+        .memoryTracker = create_info.memoryTracker,
+        .memoryDebugName = "vka::FrameRingBuffer"
+    };
+    return Buffer(device, properties, buffer_ci);
+}
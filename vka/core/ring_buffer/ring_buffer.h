@@ -0,0 +1,199 @@
+/**
+ * @brief Ring buffer for transient data that is written once per frame in flight.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+namespace vka
+{
+    /**
+     * Structure specifying the parameters of a newly created frame ring buffer. Parameters prefixed with
+     * <c>buffer</c> or <c>memory</c> correspond to the parameters of <c>BufferCreateInfo</c>. The sharing mode is
+     * <c>VK_SHARING_MODE_CONCURRENT</c>, if more than one queue family is specified.
+     * - <c>memoryType</c> -- Must contain <c>VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT</c>. If the memory is not
+     * host-coherent, every frame must be flushed with <c>flush()</c> before it is submitted.
+     * - <c>memoryTypePreferred</c> -- Preferred memory property flags. With <c>VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT</c>
+     * the slices are written directly into device-local memory, if the device has a host-visible device-local heap.
+     * - <c>frameSize</c> -- Number of bytes available per frame in flight.
+     * - <c>frameCount</c> -- Number of frames in flight.
+     * - <c>sliceAlignment</c> -- Alignment of every slice, must be a power of 2. For uniform buffers this is
+     * <c>VkPhysicalDeviceLimits::minUniformBufferOffsetAlignment</c>, for storage buffers
+     * <c>VkPhysicalDeviceLimits::minStorageBufferOffsetAlignment</c>.
+     */
+    struct FrameRingBufferCreateInfo
+    {
+        VkBufferUsageFlags      bufferUsage;
+        uint32_t                bufferQueueFamilyIndexCount;
+        const uint32_t*         bufferQueueFamilyIndices;
+        VkMemoryPropertyFlags   memoryType;
+        VkMemoryPropertyFlags   memoryTypePreferred;
+        MemoryAllocator*        memoryAllocator;
+        VkDeviceSize            memoryNonCoherentAtomSize;
+        MemoryTracker*          memoryTracker;
+        VkDeviceSize            frameSize;
+        uint32_t                frameCount;
+        VkDeviceSize            sliceAlignment;
+    };
+
+    /**
+     * Region of a buffer that was handed out by a <c>FrameRingBuffer</c>.
+     * - <c>buffer</c> -- Buffer that contains the slice.
+     * - <c>offset</c> -- Offset of the slice within the buffer, e.g. used as a dynamic offset.
+     * - <c>size</c> -- Size of the slice in bytes.
+     * - <c>data</c> -- Host pointer to the slice.
+     */
+    struct BufferSlice
+    {
+        VkBuffer                buffer;
+        VkDeviceSize            offset;
+        VkDeviceSize            size;
+        void*                   data;
+    };
+
+    /**
+     * Persistently mapped buffer that is divided into one region per frame in flight. Every frame, slices are handed
+     * out linearly from the region of the current frame. A region is reused, when its frame in flight comes around
+     * again. Because the GPU may still read from the region of a previous frame, <c>begin_frame()</c> must only be
+     * called after the fence of that frame has been signaled (see <c>Renderer::wait_frame()</c>). Compared to mapping
+     * and unmapping a single buffer every frame, there are no map calls in the render loop and the host never writes
+     * memory which is still read by the GPU.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates an <b>empty</b> ring buffer. This empty object is invalid and cannot hand out any
+     * slices. Any member function returning a vulkan handle returns <c>VK_NULL_HANDLE</c>. Calling <c>destroy()</c>
+     * does nothing.
+     *
+     * <b>Initialization:</b>\n
+     * The initialization constructor creates a valid ring buffer that is mapped until it is destroyed, if no exception
+     * was thrown. The first frame has already begun.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Destroys the buffer and sets everything back to default values. After destroying the object is an <b>empty</b>
+     * ring buffer.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class can be created and used from any thread. However, if you use this class across multiple threads,
+     * actions must be externally synchronized.
+     *
+     * <b>Actions:</b>
+     * - <b>begin frame</b> -- Invoked by <c>begin_frame()</c> recycles the region of a frame in flight.
+     * - <b>allocation</b> -- Invoked by <c>allocate()</c> or <c>push()</c> hands out a slice of the current frame.
+     * - <b>flush</b> -- Invoked by <c>flush()</c> makes the slices of the current frame visible to the device.
+     */
+    class FrameRingBuffer final
+    {
+    public:
+        /// Creates an empty ring buffer. This ring buffer is invalid.
+        constexpr FrameRingBuffer() noexcept;
+
+        /**
+         * Creates the ring buffer. The ring buffer is valid if no exception was thrown.
+         * @param device Device with which the ring buffer is created.
+         * @param properties Memory properties of the physical device.
+         * @param create_info Create-info for the ring buffer.
+         * @throw std::invalid_argument Is thrown, if the frame size or frame count is 0 or if the slice alignment is
+         * not a power of 2.
+         * @throw std::runtime_error Is thrown, if creating or mapping the buffer failed.
+         */
+        explicit FrameRingBuffer(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const FrameRingBufferCreateInfo& create_info);
+
+        /// @return Returns whether the ring buffer is valid.
+        explicit constexpr operator bool() const noexcept;
+
+        /// @return Returns the parent handle.
+        constexpr VkDevice parent() const noexcept;
+
+        /// @return Returns the vulkan <c>VkBuffer</c> handle.
+        constexpr VkBuffer handle() const noexcept;
+
+        /// @return Returns the underlying buffer.
+        constexpr const Buffer& buffer() const noexcept;
+
+        /// @return Returns the number of bytes available per frame.
+        constexpr VkDeviceSize frame_size() const noexcept;
+
+        /// @return Returns the number of frames in flight.
+        constexpr uint32_t frame_count() const noexcept;
+
+        /// @return Returns the index of the current frame in flight.
+        constexpr uint32_t frame() const noexcept;
+
+        /// @return Returns the number of bytes used in the current frame including alignment padding.
+        constexpr VkDeviceSize used() const noexcept;
+
+        /// Destroys the ring buffer. After destroying the ring buffer is empty and therefore invalid.
+        constexpr void destroy() noexcept;
+
+        /**
+         * Begins a frame and makes its whole region available again.
+         * @param frame Index of the frame in flight.
+         * @pre The GPU has finished all work that reads from the region of that frame.
+         */
+        constexpr void begin_frame(uint32_t frame) noexcept;
+
+        /**
+         * Hands out a slice of the current frame.
+         * @param size Size of the slice in bytes.
+         * @return Returns the slice. Its offset is aligned to the slice alignment.
+         * @throw std::out_of_range Is thrown, if the remaining region of the current frame is too small.
+         */
+        constexpr BufferSlice allocate(VkDeviceSize size);
+
+        /**
+         * Hands out a slice of the current frame and copies a value into it.
+         * @param value Value to copy.
+         * @return Returns the slice which contains the value.
+         * @throw std::out_of_range Is thrown, if the remaining region of the current frame is too small.
+         */
+        template<typename T>
+        BufferSlice push(const T& value);
+
+        /**
+         * Makes all slices of the current frame visible to the device. For host-coherent memory, this function does
+         * nothing.
+         * @throw std::runtime_error Is thrown if flushing failed.
+         */
+        inline void flush();
+
+        // deleted
+        FrameRingBuffer(const FrameRingBuffer&) = delete;
+        FrameRingBuffer& operator= (const FrameRingBuffer&) = delete;
+
+        // default
+        FrameRingBuffer(FrameRingBuffer&&) = default;
+        ~FrameRingBuffer() = default;
+        FrameRingBuffer& operator= (FrameRingBuffer&&) = default;
+
+    private:
+        static constexpr const char* MSG_INVALID_SIZE = "[vka::FrameRingBuffer]: Frame size and frame count must not be 0.";
+        static constexpr const char* MSG_INVALID_ALIGNMENT = "[vka::FrameRingBuffer]: Slice alignment must be a power of 2.";
+        static constexpr const char* MSG_OUT_OF_MEMORY = "[vka::FrameRingBuffer]: Frame is out of memory.";
+
+        Buffer m_buffer;
+        void* m_map;
+        VkDeviceSize m_frame_size;
+        VkDeviceSize m_alignment;
+        VkDeviceSize m_begin;
+        VkDeviceSize m_offset;
+        uint32_t m_frame_count;
+        uint32_t m_frame;
+
+        /// Creates the buffer that contains the regions of all frames.
+        static Buffer create_buffer(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const FrameRingBufferCreateInfo& create_info);
+    };
+}
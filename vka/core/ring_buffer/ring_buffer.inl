@@ -0,0 +1,110 @@
+/**
+ * @brief Inline implementation for the frame ring buffer.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+#include "ring_buffer.h"
+
+constexpr vka::FrameRingBuffer::FrameRingBuffer() noexcept :
+    m_map(nullptr),
+    m_frame_size(0),
+    m_alignment(1),
+    m_begin(0),
+    m_offset(0),
+    m_frame_count(0),
+    m_frame(0)
+{}
+
+constexpr vka::FrameRingBuffer::operator bool() const noexcept
+{
+    return (bool)this->m_buffer;
+}
+
+constexpr VkDevice vka::FrameRingBuffer::parent() const noexcept
+{
+    return this->m_buffer.parent();
+}
+
+constexpr VkBuffer vka::FrameRingBuffer::handle() const noexcept
+{
+    return this->m_buffer.handle();
+}
+
+constexpr const vka::Buffer& vka::FrameRingBuffer::buffer() const noexcept
+{
+    return this->m_buffer;
+}
+
+constexpr VkDeviceSize vka::FrameRingBuffer::frame_size() const noexcept
+{
+    return this->m_frame_size;
+}
+
+constexpr uint32_t vka::FrameRingBuffer::frame_count() const noexcept
+{
+    return this->m_frame_count;
+}
+
+constexpr uint32_t vka::FrameRingBuffer::frame() const noexcept
+{
+    return this->m_frame;
+}
+
+constexpr VkDeviceSize vka::FrameRingBuffer::used() const noexcept
+{
+    return this->m_offset - this->m_begin;
+}
+
+constexpr void vka::FrameRingBuffer::destroy() noexcept
+{
+    this->m_buffer.destroy();
+    this->m_map = nullptr;
+    this->m_frame_size = 0;
+    this->m_alignment = 1;
+    this->m_begin = 0;
+    this->m_offset = 0;
+    this->m_frame_count = 0;
+    this->m_frame = 0;
+}
+
+constexpr void vka::FrameRingBuffer::begin_frame(uint32_t frame) noexcept
+{
+    this->m_frame = frame % this->m_frame_count;
+    this->m_begin = this->m_frame * this->m_frame_size;
+    this->m_offset = this->m_begin;
+}
+
+constexpr vka::BufferSlice vka::FrameRingBuffer::allocate(VkDeviceSize size)
+{
+    // The alignment is a power of 2 and the beginning of each frame is aligned, so aligning the offset is enough.
+    const VkDeviceSize offset = detail::memory::align_up(this->m_offset, this->m_alignment);
+    if (offset + size > this->m_begin + this->m_frame_size) [[unlikely]]
+        detail::error::throw_out_of_range(MSG_OUT_OF_MEMORY);
+
+    this->m_offset = offset + size;
+    return {
+        .buffer = this->m_buffer.handle(),
+        .offset = offset,
+        .size = size,
+        .data = detail::common::add_vp(this->m_map, offset)
+    };
+}
+
+template<typename T>
+vka::BufferSlice vka::FrameRingBuffer::push(const T& value)
+{
+    const BufferSlice slice = this->allocate(sizeof(T));
+    std::memcpy(slice.data, &value, sizeof(T));
+    return slice;
+}
+
+inline void vka::FrameRingBuffer::flush()
+{
+    if (this->m_offset > this->m_begin)
+        this->m_buffer.flush(this->m_begin, this->m_offset - this->m_begin);
+}
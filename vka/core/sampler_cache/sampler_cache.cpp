@@ -0,0 +1,241 @@
+/**
+ * @brief Implementation for the sampler cache.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+vka::SharedSampler::SharedSampler() noexcept :
+    m_cache(nullptr),
+    m_sampler(nullptr)
+{}
+
+vka::SharedSampler::SharedSampler(SamplerCache* cache, const VkSampler* sampler) noexcept :
+    m_cache(cache),
+    m_sampler(sampler)
+{}
+
+vka::SharedSampler::SharedSampler(const SharedSampler& src) noexcept :
+    m_cache(src.m_cache),
+    m_sampler(src.m_sampler)
+{
+    if (this->m_cache != nullptr)
+        this->m_cache->retain(*this->m_sampler);
+}
+
+vka::SharedSampler::SharedSampler(SharedSampler&& src) noexcept :
+    m_cache(src.m_cache),
+    m_sampler(src.m_sampler)
+{
+    src.m_cache = nullptr;
+    src.m_sampler = nullptr;
+}
+
+vka::SharedSampler::~SharedSampler()
+{
+    this->reset();
+}
+
+vka::SharedSampler& vka::SharedSampler::operator= (const SharedSampler& src) noexcept
+{
+    // Retain first, so that assigning a reference to the same sampler does not destroy it.
+    if (src.m_cache != nullptr)
+        src.m_cache->retain(*src.m_sampler);
+    this->reset();
+    this->m_cache = src.m_cache;
+    this->m_sampler = src.m_sampler;
+    return *this;
+}
+
+vka::SharedSampler& vka::SharedSampler::operator= (SharedSampler&& src) noexcept
+{
+    if (this != &src)
+    {
+        this->reset();
+        this->m_cache = src.m_cache;
+        this->m_sampler = src.m_sampler;
+        src.m_cache = nullptr;
+        src.m_sampler = nullptr;
+    }
+    return *this;
+}
+
+vka::SharedSampler::operator bool() const noexcept
+{
+    return this->m_sampler != nullptr;
+}
+
+VkSampler vka::SharedSampler::get() const noexcept
+{
+    return this->m_sampler != nullptr ? *this->m_sampler : VK_NULL_HANDLE;
+}
+
+const VkSampler* vka::SharedSampler::data() const noexcept
+{
+    return this->m_sampler;
+}
+
+void vka::SharedSampler::reset() noexcept
+{
+    if (this->m_cache != nullptr)
+        this->m_cache->release(*this->m_sampler);
+    this->m_cache = nullptr;
+    this->m_sampler = nullptr;
+}
+
+vka::SamplerCache::SamplerCache() noexcept :
+    m_device(VK_NULL_HANDLE)
+{}
+
+vka::SamplerCache::SamplerCache(VkDevice device) :
+    m_device(device)
+{}
+
+vka::SamplerCache::~SamplerCache()
+{
+    this->destroy();
+}
+
+vka::SamplerCache::operator bool() const noexcept
+{
+    return this->m_device != VK_NULL_HANDLE;
+}
+
+VkDevice vka::SamplerCache::parent() const noexcept
+{
+    return this->m_device;
+}
+
+size_t vka::SamplerCache::count() const noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    return this->m_entries.size();
+}
+
+vka::SharedSampler vka::SamplerCache::get(const VkSamplerCreateInfo& create_info)
+{
+    return SharedSampler(this, this->acquire_entry(create_info));
+}
+
+VkSampler vka::SamplerCache::acquire(const VkSamplerCreateInfo& create_info)
+{
+    return *this->acquire_entry(create_info);
+}
+
+void vka::SamplerCache::release(VkSampler sampler) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    const auto it = this->m_keys.find(sampler);
+    if (it == this->m_keys.end()) [[unlikely]]
+        return;
+
+    // The key is copied, as it is destroyed together with its entry.
+    const Key key = *it->second;
+    Entry& entry = this->m_entries.at(key);
+    if (--entry.references > 0)
+        return;
+
+    vkDestroySampler(this->m_device, sampler, nullptr);
+    this->m_keys.erase(it);
+    this->m_entries.erase(key);
+}
+
+void vka::SamplerCache::destroy() noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    for (const auto& [key, entry] : this->m_entries)
+        vkDestroySampler(this->m_device, entry.sampler, nullptr);
+    this->m_entries.clear();
+    this->m_keys.clear();
+    this->m_device = VK_NULL_HANDLE;
+}
+
+size_t vka::SamplerCache::KeyHash::operator() (const Key& key) const noexcept
+{
+    size_t seed = std::hash<uint32_t>()(key.flags);
+    const auto combine = [&seed](size_t value) {
+        seed ^= value + 0x9E3779B9 + (seed << 6) + (seed >> 2);
+    };
+    combine(std::hash<uint32_t>()((uint32_t)key.mag_filter));
+    combine(std::hash<uint32_t>()((uint32_t)key.min_filter));
+    combine(std::hash<uint32_t>()((uint32_t)key.mipmap_mode));
+    combine(std::hash<uint32_t>()((uint32_t)key.address_mode_u));
+    combine(std::hash<uint32_t>()((uint32_t)key.address_mode_v));
+    combine(std::hash<uint32_t>()((uint32_t)key.address_mode_w));
+    combine(std::hash<float>()(key.mip_lod_bias));
+    combine(std::hash<uint32_t>()(key.anisotropy_enable));
+    combine(std::hash<float>()(key.max_anisotropy));
+    combine(std::hash<uint32_t>()(key.compare_enable));
+    combine(std::hash<uint32_t>()((uint32_t)key.compare_op));
+    combine(std::hash<float>()(key.min_lod));
+    combine(std::hash<float>()(key.max_lod));
+    combine(std::hash<uint32_t>()((uint32_t)key.border_color));
+    combine(std::hash<uint32_t>()(key.unnormalized_coordinates));
+    combine(std::hash<uint32_t>()((uint32_t)key.reduction_mode));
+    return seed;
+}
+
+const VkSampler* vka::SamplerCache::acquire_entry(const VkSamplerCreateInfo& create_info)
+{
+    const Key key = make_key(create_info);
+
+    std::lock_guard lock(this->m_mutex);
+    const auto it = this->m_entries.find(key);
+    if (it != this->m_entries.end())
+    {
+        it->second.references++;
+        return &it->second.sampler;
+    }
+
+    VkSampler sampler;
+    check_result(vkCreateSampler(this->m_device, &create_info, nullptr, &sampler), MSG_CREATE_FAILED);
+    unique_handle sampler_guard(this->m_device, sampler);
+
+    // Elements of an unordered map keep their address on rehashing, so the key and the handle can be referenced.
+    const auto [entry, inserted] = this->m_entries.emplace(key, Entry{ sampler, 1 });
+    this->m_keys.emplace(sampler, &entry->first);
+    sampler_guard.release();
+    return &entry->second.sampler;
+}
+
+void vka::SamplerCache::retain(VkSampler sampler) noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    const auto it = this->m_keys.find(sampler);
+    if (it != this->m_keys.end()) [[likely]]
+        this->m_entries.at(*it->second).references++;
+}
+
+vka::SamplerCache::Key vka::SamplerCache::make_key(const VkSamplerCreateInfo& create_info)
+{
+    Key key = {
+        .flags = create_info.flags,
+        .mag_filter = create_info.magFilter,
+        .min_filter = create_info.minFilter,
+        .mipmap_mode = create_info.mipmapMode,
+        .address_mode_u = create_info.addressModeU,
+        .address_mode_v = create_info.addressModeV,
+        .address_mode_w = create_info.addressModeW,
+        .mip_lod_bias = create_info.mipLodBias,
+        .anisotropy_enable = create_info.anisotropyEnable,
+        .max_anisotropy = create_info.anisotropyEnable ? create_info.maxAnisotropy : 0.0f,
+        .compare_enable = create_info.compareEnable,
+        .compare_op = create_info.compareEnable ? create_info.compareOp : VK_COMPARE_OP_NEVER,
+        .min_lod = create_info.minLod,
+        .max_lod = create_info.maxLod,
+        .border_color = create_info.borderColor,
+        .unnormalized_coordinates = create_info.unnormalizedCoordinates,
+        .reduction_mode = VK_SAMPLER_REDUCTION_MODE_WEIGHTED_AVERAGE
+    };
+
+    for (const VkBaseInStructure* next = (const VkBaseInStructure*)create_info.pNext; next != nullptr; next = next->pNext)
+    {
+        if (next->sType != VK_STRUCTURE_TYPE_SAMPLER_REDUCTION_MODE_CREATE_INFO) [[unlikely]]
+            detail::error::throw_invalid_argument(MSG_INVALID_CHAIN);
+        key.reduction_mode = ((const VkSamplerReductionModeCreateInfo*)next)->reductionMode;
+    }
+    return key;
+}
@@ -0,0 +1,241 @@
+/**
+ * @brief Cache that shares samplers which are created with the same parameters.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+namespace vka
+{
+    class SamplerCache;
+
+    /**
+     * Reference to a sampler of a <c>SamplerCache</c>. Every copy holds a reference, the sampler is destroyed when
+     * the last reference is released.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates an <b>empty</b> reference. Calling <c>get()</c> returns <c>VK_NULL_HANDLE</c>
+     * and calling <c>data()</c> returns <c>nullptr</c>.
+     *
+     * <b>Copy behaviour:</b>\n
+     * Copying adds a reference to the same sampler.
+     *
+     * <b>Moving behaviour:</b>\n
+     * Moving transfers the reference. The moved object is empty afterwards. If an already valid object is replaced by a
+     * move, its reference is released.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Releases the reference. After resetting the object is empty.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * Different references to the same sampler can be copied and released from any thread, as the reference count is
+     * synchronized by the cache.
+     */
+    class SharedSampler final
+    {
+    public:
+        /// Creates an empty reference.
+        SharedSampler() noexcept;
+
+        /// Adds a reference to the sampler of another reference.
+        SharedSampler(const SharedSampler& src) noexcept;
+
+        /// Transfers the reference of another reference.
+        SharedSampler(SharedSampler&& src) noexcept;
+
+        /// Releases the reference.
+        ~SharedSampler();
+
+        /// Releases the current reference and adds a reference to the sampler of another reference.
+        SharedSampler& operator= (const SharedSampler& src) noexcept;
+
+        /// Releases the current reference and transfers the reference of another reference.
+        SharedSampler& operator= (SharedSampler&& src) noexcept;
+
+        /// @return Returns whether the reference is valid.
+        explicit operator bool() const noexcept;
+
+        /// @return Returns the vulkan <c>VkSampler</c> handle.
+        VkSampler get() const noexcept;
+
+        /**
+         * The address is owned by the cache and stays valid as long as any reference to the sampler exists, also if
+         * this object is moved. Therefore, it can be passed as immutable sampler to <c>DescriptorBindingList</c>.
+         * @return Returns the address of the vulkan <c>VkSampler</c> handle.
+         */
+        const VkSampler* data() const noexcept;
+
+        /// Releases the reference. After resetting the reference is empty.
+        void reset() noexcept;
+
+    private:
+        friend class SamplerCache;
+
+        SamplerCache* m_cache;
+        const VkSampler* m_sampler;
+
+        SharedSampler(SamplerCache* cache, const VkSampler* sampler) noexcept;
+    };
+
+    /**
+     * Shares samplers between all users of the same sampler parameters. The samplers are reference counted and
+     * destroyed when their last reference is released, which keeps the number of samplers of a device, limited by
+     * <c>maxSamplerAllocationCount</c>, as low as possible. The samplers are either acquired as
+     * <c>SharedSampler</c> with <c>get()</c> or as raw handle with <c>acquire()</c>, which must be released with
+     * <c>release()</c>. Textures whose create-info refers to a cache take their sampler from it.
+     * Parameters which are ignored by vulkan do not distinguish samplers, i.e. <c>maxAnisotropy</c> if anisotropy is
+     * disabled and <c>compareOp</c> if comparison is disabled. The only supported structure of the <c>pNext</c> chain
+     * is <c>VkSamplerReductionModeCreateInfo</c>.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates an <b>empty</b> cache. This empty object is invalid and cannot perform any
+     * actions. Calling <c>parent()</c> returns <c>VK_NULL_HANDLE</c>. Calling <c>destroy()</c> does nothing.
+     *
+     * <b>Initialization:</b>\n
+     * The initialization constructor creates a valid cache without any samplers.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * The cache cannot be moved, because it is internally synchronized and referenced by its samplers. Use a
+     * <c>std::unique_ptr</c> to transfer its ownership.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Destroys all samplers, regardless of their references. Therefore, the cache must outlive all textures and
+     * references that use its samplers. After destroying the object is an <b>empty</b> cache.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class is internally synchronized and can be used from any thread.
+     *
+     * <b>Actions:</b>
+     * - <b>acquiring</b> -- Invoked by <c>get()</c> or <c>acquire()</c> returns a cached sampler or creates it.
+     * - <b>releasing</b> -- Invoked by <c>release()</c> or by the last <c>SharedSampler</c> destroys a sampler that is
+     * not referenced anymore.
+     */
+    class SamplerCache final
+    {
+    public:
+        /// Creates an empty sampler cache. This sampler cache is invalid.
+        SamplerCache() noexcept;
+
+        /**
+         * Creates the sampler cache. The cache is valid if no exception was thrown.
+         * @param device Device with which the samplers are created.
+         */
+        explicit SamplerCache(VkDevice device);
+
+        /// Destroys the samplers.
+        ~SamplerCache();
+
+        /// @return Returns whether the sampler cache is valid.
+        explicit operator bool() const noexcept;
+
+        /// @return Returns the parent handle.
+        VkDevice parent() const noexcept;
+
+        /// @return Returns the number of cached samplers.
+        size_t count() const noexcept;
+
+        /**
+         * Returns a reference to a sampler and creates the sampler, if it is not in the cache.
+         * @param create_info Create-info of the sampler.
+         * @return Returns the reference to the sampler.
+         * @throw std::invalid_argument Is thrown, if the <c>pNext</c> chain contains an unsupported structure.
+         * @throw std::runtime_error Is thrown, if creating the sampler failed.
+         */
+        SharedSampler get(const VkSamplerCreateInfo& create_info);
+
+        /**
+         * Adds a reference to a sampler and creates the sampler, if it is not in the cache.
+         * @param create_info Create-info of the sampler.
+         * @return Returns the vulkan <c>VkSampler</c> handle, which must be released with <c>release()</c>.
+         * @throw std::invalid_argument Is thrown, if the <c>pNext</c> chain contains an unsupported structure.
+         * @throw std::runtime_error Is thrown, if creating the sampler failed.
+         */
+        VkSampler acquire(const VkSamplerCreateInfo& create_info);
+
+        /**
+         * Removes a reference from a sampler and destroys it, if it was the last one.
+         * @param sampler Sampler that was acquired from this cache.
+         * @pre The device does not use the sampler anymore, if it is the last reference.
+         */
+        void release(VkSampler sampler) noexcept;
+
+        /**
+         * Destroys the sampler cache. After destroying the sampler cache is empty and therefore invalid.
+         * @pre No sampler of the cache is referenced or used by the device anymore.
+         */
+        void destroy() noexcept;
+
+        // Deleted:
+        SamplerCache(const SamplerCache&) = delete;
+        SamplerCache& operator= (const SamplerCache&) = delete;
+
+    private:
+        static constexpr const char* MSG_CREATE_FAILED = "[vka::SamplerCache]: Failed to create sampler.";
+        static constexpr const char* MSG_INVALID_CHAIN = "[vka::SamplerCache]: Unsupported structure in pNext chain of sampler create-info.";
+
+        friend class SharedSampler;
+
+        struct Key
+        {
+            VkSamplerCreateFlags flags;
+            VkFilter mag_filter;
+            VkFilter min_filter;
+            VkSamplerMipmapMode mipmap_mode;
+            VkSamplerAddressMode address_mode_u;
+            VkSamplerAddressMode address_mode_v;
+            VkSamplerAddressMode address_mode_w;
+            float mip_lod_bias;
+            VkBool32 anisotropy_enable;
+            float max_anisotropy;
+            VkBool32 compare_enable;
+            VkCompareOp compare_op;
+            float min_lod;
+            float max_lod;
+            VkBorderColor border_color;
+            VkBool32 unnormalized_coordinates;
+            VkSamplerReductionMode reduction_mode;
+
+            bool operator== (const Key& other) const noexcept = default;
+        };
+
+        struct KeyHash
+        {
+            size_t operator() (const Key& key) const noexcept;
+        };
+
+        struct Entry
+        {
+            VkSampler sampler;
+            uint32_t references;
+        };
+
+        VkDevice m_device;
+        mutable std::mutex m_mutex;
+        std::unordered_map<Key, Entry, KeyHash> m_entries;
+        std::unordered_map<VkSampler, const Key*> m_keys;
+
+        /**
+         * Adds a reference to a sampler and creates it, if it is not in the cache.
+         * @return Returns the address of the sampler handle in its entry, which does not change until it is destroyed.
+         */
+        const VkSampler* acquire_entry(const VkSamplerCreateInfo& create_info);
+
+        /// Adds a reference to a sampler that is already referenced.
+        void retain(VkSampler sampler) noexcept;
+
+        /// Creates the key of a sampler create-info.
+        static Key make_key(const VkSamplerCreateInfo& create_info);
+    };
+}
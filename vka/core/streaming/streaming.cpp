@@ -0,0 +1,306 @@
+/**
+ * @brief Implementation for the streaming texture.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+vka::StreamingTexture::StreamingTexture(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const StreamingTextureCreateInfo& create_info) :
+    m_properties(properties),
+    m_create_info(create_info),
+    m_block(TextureContainer::block_extent(create_info.format)),
+    m_texel_size(format_sizeof(create_info.format)),
+    m_row(0)
+{
+    if (create_info.levelCount == 0) [[unlikely]]
+        detail::error::throw_invalid_argument(MSG_INVALID_LEVEL_COUNT);
+    if (this->m_texel_size == 0 || this->m_texel_size == NSIZE) [[unlikely]]
+        detail::error::throw_invalid_argument(MSG_INVALID_FORMAT);
+
+    const uint32_t resident_count = std::clamp(create_info.residentLevelCount, 1u, create_info.levelCount);
+    this->m_resident = create_info.levelCount - resident_count;
+    this->m_target = this->m_resident;
+    this->m_retired.resize(create_info.staging->frame_count());
+
+    unique_handle<Handle> image = this->create_image(device, this->m_resident);
+    const VkImage handle = image.get().image;
+    transition(create_info.commandBuffer, handle, resident_count, create_info.layerCount, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+               0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    for (uint32_t level = this->m_resident; level < create_info.levelCount; level++)
+        this->upload(create_info.commandBuffer, *create_info.staging, handle, level - this->m_resident, level, 0, this->row_count(level));
+    transition(create_info.commandBuffer, handle, resident_count, create_info.layerCount, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+               VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, create_info.shaderStages);
+    this->m_image = std::move(image);
+}
+
+bool vka::StreamingTexture::stream(VkCommandBuffer cbo, FrameRingBuffer& staging, VkDeviceSize budget)
+{
+    const VkDevice device = this->m_image.parent();
+    const uint32_t layer_count = this->m_create_info.layerCount;
+    const uint32_t level_count = this->m_create_info.levelCount;
+    const uint32_t frame = staging.frame();
+
+    // Eviction shrinks the image to the requested levels, a level that is currently streamed in is dropped.
+    if (this->m_target > this->m_resident)
+    {
+        if (this->m_pending)
+            this->retire(this->m_pending, frame);
+
+        unique_handle<Handle> image = this->create_image(device, this->m_target);
+        const VkImage handle = image.get().image;
+        const uint32_t count = level_count - this->m_target;
+        transition(cbo, handle, count, layer_count, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                   0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+        this->copy_levels(cbo, handle, this->m_target);
+        transition(cbo, handle, count, layer_count, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                   VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, this->m_create_info.shaderStages);
+
+        this->retire(this->m_image, frame);
+        this->m_image = std::move(image);
+        this->m_resident = this->m_target;
+        return true;
+    }
+
+    // The request was withdrawn while the next level was streamed in.
+    if (this->m_pending && this->m_target == this->m_resident)
+        this->retire(this->m_pending, frame);
+
+    bool changed = false;
+    VkDeviceSize used = 0;
+    while (this->m_target < this->m_resident)
+    {
+        const uint32_t level = this->m_resident - 1;
+        const uint32_t count = level_count - level;
+        if (!this->m_pending)
+        {
+            this->m_pending = this->create_image(device, level);
+            transition(cbo, this->m_pending.get().image, count, layer_count, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                       0, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+            this->copy_levels(cbo, this->m_pending.get().image, level);
+            this->m_row = 0;
+        }
+
+        // At least one row is uploaded per call, even if it exceeds the budget.
+        const uint32_t row_count = this->row_count(level);
+        const VkDeviceSize row_size = this->row_size(level) * layer_count;
+        const VkDeviceSize remaining = budget > used ? budget - used : 0;
+        uint32_t rows = (uint32_t)std::min<VkDeviceSize>(row_count - this->m_row, remaining / row_size);
+        if (rows == 0)
+        {
+            if (used != 0)
+                break;
+            rows = 1;
+        }
+
+        this->upload(cbo, staging, this->m_pending.get().image, 0, level, this->m_row, this->m_row + rows);
+        this->m_row += rows;
+        used += rows * row_size;
+        if (this->m_row < row_count)
+            break;
+
+        transition(cbo, this->m_pending.get().image, count, layer_count, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                   VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, this->m_create_info.shaderStages);
+        this->retire(this->m_image, frame);
+        this->m_image = std::move(this->m_pending);
+        this->m_resident = level;
+        changed = true;
+        if (used >= budget)
+            break;
+    }
+    return changed;
+}
+
+void vka::StreamingTexture::begin_frame(uint32_t frame) noexcept
+{
+    if (frame < this->m_retired.size())
+        this->m_retired[frame].clear();
+}
+
+void vka::StreamingTexture::destroy() noexcept
+{
+    this->m_image = VK_NULL_HANDLE;
+    this->m_pending = VK_NULL_HANDLE;
+    this->m_retired.clear();
+    this->m_create_info = {};
+    this->m_block = { 0, 0 };
+    this->m_texel_size = 0;
+    this->m_resident = 0;
+    this->m_target = 0;
+    this->m_row = 0;
+}
+
+uint32_t vka::StreamingTexture::row_count(uint32_t level) const noexcept
+{
+    const VkExtent3D extent = common::mip_extent({ this->m_create_info.extent.width, this->m_create_info.extent.height, 1 }, level);
+    return (extent.height + this->m_block.height - 1) / this->m_block.height;
+}
+
+VkDeviceSize vka::StreamingTexture::row_size(uint32_t level) const noexcept
+{
+    const VkExtent3D extent = common::mip_extent({ this->m_create_info.extent.width, this->m_create_info.extent.height, 1 }, level);
+    return (VkDeviceSize)((extent.width + this->m_block.width - 1) / this->m_block.width) * this->m_texel_size;
+}
+
+vka::unique_handle<vka::StreamingTexture::Handle> vka::StreamingTexture::create_image(VkDevice device, uint32_t first) const
+{
+    // create image
+    const uint32_t level_count = this->m_create_info.levelCount - first;
+    const VkExtent3D extent = common::mip_extent({ this->m_create_info.extent.width, this->m_create_info.extent.height, 1 }, first);
+    const VkImageCreateInfo image_create_info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = this->m_create_info.imageFlags,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = this->m_create_info.format,
+        .extent = extent,
+        .mipLevels = level_count,
+        .arrayLayers = this->m_create_info.layerCount,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 0,
+        .pQueueFamilyIndices = nullptr,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+    VkImage image;
+    check_result(vkCreateImage(device, &image_create_info, nullptr, &image), MSG_IMAGE_CREATE_FAILED);
+    unique_handle image_guard(device, image);
+
+    // query memory requirements
+    VkMemoryRequirements requirements;
+    VkMemoryDedicatedRequirements dedicated_requirements;
+    memory::get_requirements(device, image, requirements, dedicated_requirements);
+    const bool dedicated = memory::use_dedicated(this->m_create_info.memoryAllocator, dedicated_requirements, requirements.size);
+    const VkMemoryDedicatedAllocateInfo dedicated_ai = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .image = image,
+        .buffer = VK_NULL_HANDLE
+    };
+
+    // allocate memory
+    detail::memory::Allocation allocation;
+    check_result(memory::allocate(device, this->m_properties, this->m_create_info.memoryAllocator, requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, 0, true, dedicated ? &dedicated_ai : nullptr, allocation), MSG_ALLOC_MEMORY_FAILED);
+    if (this->m_create_info.memoryTracker != nullptr)
+        this->m_create_info.memoryTracker->track(MemoryObjectType::TEXTURE, this->m_create_info.memoryDebugName, dedicated, allocation);
+    unique_handle memory_guard(device, allocation);
+    check_result(vkBindImageMemory(device, image, allocation.memory, allocation.offset), MSG_BIND_MEMORY_FAILED);
+
+    // create image view
+    const VkImageSubresourceRange range = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = level_count,
+        .baseArrayLayer = 0,
+        .layerCount = this->m_create_info.layerCount
+    };
+    const VkImageViewCreateInfo view_create_info = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .image = image,
+        .viewType = this->m_create_info.viewType,
+        .format = this->m_create_info.format,
+        .components = {},
+        .subresourceRange = range
+    };
+    VkImageView view;
+    check_result(vkCreateImageView(device, &view_create_info, nullptr, &view), MSG_VIEW_CREATE_FAILED);
+
+    const Handle handle = {
+        .image = image_guard.release(),
+        .memory = memory_guard.release(),
+        .view = view
+    };
+    return unique_handle(device, handle);
+}
+
+void vka::StreamingTexture::upload(VkCommandBuffer cbo, FrameRingBuffer& staging, VkImage image, uint32_t image_level, uint32_t level, uint32_t row_begin, uint32_t row_end) const
+{
+    const uint32_t layer_count = this->m_create_info.layerCount;
+    const VkExtent3D extent = common::mip_extent({ this->m_create_info.extent.width, this->m_create_info.extent.height, 1 }, level);
+    const VkDeviceSize row_size = this->row_size(level);
+    const VkDeviceSize layer_size = row_size * this->row_count(level);
+    const VkDeviceSize size = (row_end - row_begin) * row_size;
+
+    // Buffer offsets must be a multiple of the texel size and of 4, which is not a power of 2 for every format.
+    // Therefore, the slice is aligned manually.
+    const VkDeviceSize alignment = std::lcm(this->m_texel_size, (VkDeviceSize)4);
+    const VkDeviceSize stride = (size + alignment - 1) / alignment * alignment;
+    const BufferSlice slice = staging.allocate(stride * layer_count + alignment - 1);
+    const VkDeviceSize offset = (slice.offset + alignment - 1) / alignment * alignment;
+    uint8_t* dst = static_cast<uint8_t*>(detail::common::add_vp(slice.data, offset - slice.offset));
+    const uint8_t* src = static_cast<const uint8_t*>(this->m_create_info.levelData[level]) + row_begin * row_size;
+
+    std::vector<VkBufferImageCopy> regions(layer_count);
+    const uint32_t y = row_begin * this->m_block.height;
+    const uint32_t height = std::min(row_end * this->m_block.height, extent.height) - y;
+    for (uint32_t layer = 0; layer < layer_count; layer++)
+    {
+        std::memcpy(dst + layer * stride, src + layer * layer_size, size);
+        regions[layer] = {
+            .bufferOffset = offset + layer * stride,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, image_level, layer, 1 },
+            .imageOffset = { 0, (int32_t)y, 0 },
+            .imageExtent = { extent.width, height, 1 }
+        };
+    }
+    vkCmdCopyBufferToImage(cbo, slice.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, layer_count, regions.data());
+}
+
+void vka::StreamingTexture::copy_levels(VkCommandBuffer cbo, VkImage dst, uint32_t first) const noexcept
+{
+    const uint32_t layer_count = this->m_create_info.layerCount;
+    const uint32_t level_count = this->m_create_info.levelCount;
+    const uint32_t src_count = level_count - this->m_resident;
+    const uint32_t begin = std::max(first, this->m_resident);
+    const VkImage src = this->m_image.get().image;
+
+    VkImageCopy regions[32];
+    uint32_t region_count = 0;
+    for (uint32_t level = begin; level < level_count; level++)
+    {
+        regions[region_count++] = {
+            .srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - this->m_resident, 0, layer_count },
+            .srcOffset = { 0, 0, 0 },
+            .dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - first, 0, layer_count },
+            .dstOffset = { 0, 0, 0 },
+            .extent = common::mip_extent({ this->m_create_info.extent.width, this->m_create_info.extent.height, 1 }, level)
+        };
+    }
+
+    // The source stays sampleable, because it is still in use until the new image replaces it.
+    transition(cbo, src, src_count, layer_count, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+               0, VK_ACCESS_TRANSFER_READ_BIT, this->m_create_info.shaderStages, VK_PIPELINE_STAGE_TRANSFER_BIT);
+    vkCmdCopyImage(cbo, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, region_count, regions);
+    transition(cbo, src, src_count, layer_count, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+               0, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, this->m_create_info.shaderStages);
+}
+
+void vka::StreamingTexture::retire(unique_handle<Handle>& image, uint32_t frame)
+{
+    this->m_retired[frame].push_back(std::move(image));
+}
+
+void vka::StreamingTexture::transition(VkCommandBuffer cbo, VkImage image, uint32_t level_count, uint32_t layer_count, VkImageLayout old_layout, VkImageLayout new_layout, VkAccessFlags src_access, VkAccessFlags dst_access, VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages) noexcept
+{
+    const VkImageMemoryBarrier barrier = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = src_access,
+        .dstAccessMask = dst_access,
+        .oldLayout = old_layout,
+        .newLayout = new_layout,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = image,
+        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, level_count, 0, layer_count }
+    };
+    vkCmdPipelineBarrier(cbo, src_stages, dst_stages, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
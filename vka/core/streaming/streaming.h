@@ -0,0 +1,221 @@
+/**
+ * @brief Textures whose mip levels are streamed in progressively.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+namespace vka
+{
+    /**
+     * Structure specifying the parameters of a newly created streaming texture. Parameters prefixed with
+     * <c>memory</c> correspond to the parameters of <c>TextureCreateInfo</c>.
+     * - <c>format</c> -- Format of the image. Block compressed formats are supported.
+     * - <c>extent</c> -- Extent of level 0.
+     * - <c>layerCount</c> -- Number of array layers.
+     * - <c>levelCount</c> -- Number of mip levels, which must not exceed the full mip chain of <c>extent</c>.
+     * - <c>levelData</c> -- Array of <c>levelCount</c> pointers to the data of each level. The layers of a level are
+     * tightly packed one after another, as returned by <c>TextureMipChain::data()</c> or
+     * <c>TextureCompressor::data()</c>. The data is read while the levels are streamed in and must therefore stay
+     * valid as long as the texture is streaming.
+     * - <c>residentLevelCount</c> -- Number of the smallest levels that are uploaded immediately. It is clamped to
+     * [1, <c>levelCount</c>].
+     * - <c>viewType</c> -- Type of the image view, e.g. <c>VK_IMAGE_VIEW_TYPE_CUBE</c> together with
+     * <c>imageFlags = VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT</c>.
+     * - <c>shaderStages</c> -- Pipeline stages in which the texture is sampled.
+     * - <c>commandBuffer</c> -- Command buffer in which the resident levels are uploaded.
+     * - <c>staging</c> -- Ring buffer from which the resident levels are uploaded. Its buffer must have been created
+     * with <c>VK_BUFFER_USAGE_TRANSFER_SRC_BIT</c>.
+     */
+    struct StreamingTextureCreateInfo
+    {
+        VkFormat                format;
+        VkExtent2D              extent;
+        uint32_t                layerCount;
+        uint32_t                levelCount;
+        const void* const*      levelData;
+        uint32_t                residentLevelCount;
+        VkImageCreateFlags      imageFlags;
+        VkImageViewType         viewType;
+        VkPipelineStageFlags    shaderStages;
+        VkCommandBuffer         commandBuffer;
+        FrameRingBuffer*        staging;
+        MemoryAllocator*        memoryAllocator;
+        MemoryTracker*          memoryTracker;
+        const char*             memoryDebugName;
+    };
+
+    /**
+     * Texture whose mip levels are streamed in from the smallest to the largest one. Only the smallest levels are
+     * uploaded on creation, so that the texture can be sampled within the same frame. Higher levels are requested with
+     * <c>request_level()</c> and uploaded by <c>stream()</c> under a per-frame byte budget. Requesting a smaller level
+     * than the resident one evicts the larger levels and releases their memory, which allows a working set of textures
+     * that exceeds the device memory.
+     * Core vulkan cannot release the memory of a single mip level without sparse residency. Therefore, the image only
+     * contains the resident levels and the view covers all of them, which clamps the sampled LOD without changing the
+     * sampler. When a level is added, it is uploaded into a new image with one more level, to which the existing
+     * levels are copied on the device. When the new level is complete, the new image replaces the old one and
+     * <c>stream()</c> returns <c>true</c>. The same happens when levels are evicted. Replaced images are destroyed in
+     * <c>begin_frame()</c> once the frame in which they were replaced has been executed. As the view changes, every
+     * descriptor that references <c>view()</c> must be updated before it is used again. The texture does not own a
+     * sampler and can be combined with any sampler.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates an <b>empty</b> streaming texture. This empty object is invalid and cannot
+     * perform any actions. Calling <c>image()</c> or <c>view()</c> returns <c>VK_NULL_HANDLE</c>. Calling
+     * <c>destroy()</c> does nothing.
+     *
+     * <b>Initialization:</b>\n
+     * The initialization constructor creates a valid streaming texture, whose resident levels are uploaded in the
+     * given command buffer.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Destroys the image, the image that is currently streamed in and all replaced images. The device must not use
+     * any of them anymore. After destroying the object is an <b>empty</b> streaming texture.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class can be created and used from any thread. However, if you use this class across multiple threads,
+     * actions must be externally synchronized.
+     *
+     * <b>Actions:</b>
+     * - <b>request</b> -- Invoked by <c>request_level()</c> sets the largest level that should be resident.
+     * - <b>streaming</b> -- Invoked by <c>stream()</c> uploads or evicts levels towards the requested level.
+     * - <b>begin frame</b> -- Invoked by <c>begin_frame()</c> destroys images that were replaced in a frame in flight.
+     */
+    class StreamingTexture final
+    {
+        using Handle = detail::attachment::Handle;
+
+    public:
+        /// Creates an empty streaming texture. This streaming texture is invalid.
+        constexpr StreamingTexture() noexcept;
+
+        /**
+         * Creates the streaming texture and uploads its resident levels. The texture is valid if no exception was
+         * thrown. After the upload the image is in the layout <c>VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL</c>.
+         * @param device Device with which the streaming texture is created.
+         * @param properties Memory properties of the physical device.
+         * @param create_info Create-info for the streaming texture.
+         * @throw std::invalid_argument Is thrown, if the format has no texel size or if no level is specified.
+         * @throw std::out_of_range Is thrown, if the resident levels do not fit into the current frame of the ring
+         * buffer.
+         * @throw std::runtime_error Is thrown, if creating the image, allocating memory for the image, binding the
+         * memory to the image or creating the image view failed.
+         */
+        explicit StreamingTexture(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const StreamingTextureCreateInfo& create_info);
+
+        /// @return Returns whether the streaming texture is valid.
+        explicit constexpr operator bool() const noexcept;
+
+        /// @return Returns the parent handle.
+        constexpr VkDevice parent() const noexcept;
+
+        /// @return Returns the vulkan <c>VkImage</c> handle that contains the resident levels.
+        constexpr VkImage image() const noexcept;
+
+        /// @return Returns the vulkan <c>VkImageView</c> handle that covers the resident levels.
+        constexpr VkImageView view() const noexcept;
+
+        /// @return Returns the number of mip levels of the full texture.
+        constexpr uint32_t level_count() const noexcept;
+
+        /// @return Returns the largest resident level, which is level 0 of <c>image()</c>.
+        constexpr uint32_t resident_level() const noexcept;
+
+        /// @return Returns the largest level that should be resident.
+        constexpr uint32_t target_level() const noexcept;
+
+        /// @return Returns whether the resident levels differ from the requested ones.
+        constexpr bool streaming() const noexcept;
+
+        /**
+         * Sets the largest level that should be resident. Levels below it are streamed in, levels below it that are
+         * already resident are evicted by the next call to <c>stream()</c>.
+         * @param level Largest level that should be resident, it is clamped to the smallest level.
+         */
+        constexpr void request_level(uint32_t level) noexcept;
+
+        /**
+         * Uploads or evicts levels towards the requested level. At most <c>budget</c> bytes are uploaded, but at least
+         * one row of blocks so that streaming always progresses. Copying the resident levels into a new image is done
+         * on the device and is not counted against the budget.
+         * @param cbo Command buffer in which the upload is recorded.
+         * @param staging Ring buffer from which the data is uploaded.
+         * @param budget Maximum number of bytes to upload.
+         * @return Returns <c>true</c>, if the image and the view have changed. Then, the descriptors referencing the
+         * view must be updated.
+         * @throw std::out_of_range Is thrown, if the current frame of the ring buffer is too small.
+         * @throw std::runtime_error Is thrown, if creating a new image failed.
+         */
+        bool stream(VkCommandBuffer cbo, FrameRingBuffer& staging, VkDeviceSize budget);
+
+        /**
+         * Destroys the images that were replaced in a frame in flight.
+         * @param frame Index of the frame in flight, the same as the one passed to <c>FrameRingBuffer::begin_frame()</c>.
+         * @pre The GPU has finished all work of that frame.
+         */
+        void begin_frame(uint32_t frame) noexcept;
+
+        /// Destroys the streaming texture. After destroying the streaming texture is empty and therefore invalid.
+        void destroy() noexcept;
+
+        // default:
+        StreamingTexture(StreamingTexture&&) = default;
+        ~StreamingTexture() = default;
+        StreamingTexture& operator= (StreamingTexture&&) = default;
+
+    private:
+        static constexpr const char* MSG_INVALID_FORMAT = "[vka::StreamingTexture]: Format has no texel size.";
+        static constexpr const char* MSG_INVALID_LEVEL_COUNT = "[vka::StreamingTexture]: Level count must not be 0.";
+        static constexpr const char* MSG_IMAGE_CREATE_FAILED = "[vka::StreamingTexture]: Failed to create image handle.";
+        static constexpr const char* MSG_ALLOC_MEMORY_FAILED = "[vka::StreamingTexture]: Failed to allocate memory.";
+        static constexpr const char* MSG_BIND_MEMORY_FAILED = "[vka::StreamingTexture]: Failed to bind memory to image.";
+        static constexpr const char* MSG_VIEW_CREATE_FAILED = "[vka::StreamingTexture]: Failed to create image view.";
+
+        unique_handle<Handle> m_image;
+        unique_handle<Handle> m_pending;
+        std::vector<std::vector<unique_handle<Handle>>> m_retired;
+        VkPhysicalDeviceMemoryProperties m_properties;
+        StreamingTextureCreateInfo m_create_info;
+        VkExtent2D m_block;
+        VkDeviceSize m_texel_size;
+        uint32_t m_resident;
+        uint32_t m_target;
+        uint32_t m_row;
+
+        /// @return Returns the number of block rows of a level.
+        uint32_t row_count(uint32_t level) const noexcept;
+
+        /// @return Returns the size of a block row of a level in bytes.
+        VkDeviceSize row_size(uint32_t level) const noexcept;
+
+        /// Creates an image that contains the levels [first, levelCount) and a view of all of them.
+        unique_handle<Handle> create_image(VkDevice device, uint32_t first) const;
+
+        /// Uploads the rows [row_begin, row_end) of all layers of a level into a level of an image.
+        void upload(VkCommandBuffer cbo, FrameRingBuffer& staging, VkImage image, uint32_t image_level, uint32_t level, uint32_t row_begin, uint32_t row_end) const;
+
+        /// Copies the resident levels, which are also contained in a new image whose level 0 is level first.
+        void copy_levels(VkCommandBuffer cbo, VkImage dst, uint32_t first) const noexcept;
+
+        /// Moves an image into the list of replaced images of a frame in flight.
+        void retire(unique_handle<Handle>& image, uint32_t frame);
+
+        /// Transitions all levels of an image from one layout to another.
+        static void transition(VkCommandBuffer cbo, VkImage image, uint32_t level_count, uint32_t layer_count, VkImageLayout old_layout, VkImageLayout new_layout, VkAccessFlags src_access, VkAccessFlags dst_access, VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages) noexcept;
+    };
+}
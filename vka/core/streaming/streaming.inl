@@ -0,0 +1,66 @@
+/**
+ * @brief Inline implementation for the streaming texture.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+#include "streaming.h"
+
+constexpr vka::StreamingTexture::StreamingTexture() noexcept :
+    m_properties{},
+    m_create_info{},
+    m_block{ 0, 0 },
+    m_texel_size(0),
+    m_resident(0),
+    m_target(0),
+    m_row(0)
+{}
+
+constexpr vka::StreamingTexture::operator bool() const noexcept
+{
+    return (bool)this->m_image;
+}
+
+constexpr VkDevice vka::StreamingTexture::parent() const noexcept
+{
+    return this->m_image.parent();
+}
+
+constexpr VkImage vka::StreamingTexture::image() const noexcept
+{
+    return this->m_image.get().image;
+}
+
+constexpr VkImageView vka::StreamingTexture::view() const noexcept
+{
+    return this->m_image.get().view;
+}
+
+constexpr uint32_t vka::StreamingTexture::level_count() const noexcept
+{
+    return this->m_create_info.levelCount;
+}
+
+constexpr uint32_t vka::StreamingTexture::resident_level() const noexcept
+{
+    return this->m_resident;
+}
+
+constexpr uint32_t vka::StreamingTexture::target_level() const noexcept
+{
+    return this->m_target;
+}
+
+constexpr bool vka::StreamingTexture::streaming() const noexcept
+{
+    return this->m_target != this->m_resident;
+}
+
+constexpr void vka::StreamingTexture::request_level(uint32_t level) noexcept
+{
+    this->m_target = std::min(level, this->m_create_info.levelCount - 1);
+}
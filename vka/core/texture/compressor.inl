@@ -0,0 +1,110 @@
+/**
+ * @brief Inline implementation for the texture compressor class.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+// ReSharper disable CppRedundantInlineSpecifier
+#pragma once
+
+#include "top.h"
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+vka::TextureCompressor<F>::TextureCompressor(VkExtent2D extent, uint32_t layer_count, const TextureCompressInfo& info) :
+    m_format(info.format),
+    m_extent(extent),
+    m_layer_count(layer_count)
+{
+    if (!detail::texture::is_block_encoder_format(info.format)) [[unlikely]]
+        detail::error::throw_invalid_argument(MSG_UNSUPPORTED);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+vka::TextureCompressor<F>::TextureCompressor(const uint8_t* data, VkExtent2D extent, uint32_t layer_count, const TextureCompressInfo& info) :
+    TextureCompressor(extent, layer_count, info)
+{
+    this->compress(data, info);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+vka::TextureCompressor<F>::TextureCompressor(const TextureLoader<F>& loader, const TextureCompressInfo& info) :
+    TextureCompressor(loader.data(), { loader.extent2D().width, loader.extent2D().height }, loader.layer_count(), info)
+{}
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+vka::TextureCompressor<F>::TextureCompressor(const TextureMipChain<F>& mips, const TextureCompressInfo& info) :
+    TextureCompressor({ mips.extent(0).width, mips.extent(0).height }, mips.layer_count(), info)
+{
+    this->m_levels.reserve(mips.level_count());
+    for (uint32_t level = 0; level < mips.level_count(); level++)
+        this->compress(mips.data(level), info);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+inline VkFormat vka::TextureCompressor<F>::format() const noexcept
+{
+    return this->m_format;
+}
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+inline uint32_t vka::TextureCompressor<F>::level_count() const noexcept
+{
+    return (uint32_t)this->m_levels.size();
+}
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+inline uint32_t vka::TextureCompressor<F>::layer_count() const noexcept
+{
+    return this->m_layer_count;
+}
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+inline VkExtent3D vka::TextureCompressor<F>::extent(uint32_t level) const noexcept
+{
+    return common::mip_extent({ this->m_extent.width, this->m_extent.height, 1 }, level);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+inline const uint8_t* vka::TextureCompressor<F>::data(uint32_t level) const noexcept
+{
+    return this->m_levels[level].get();
+}
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+inline VkDeviceSize vka::TextureCompressor<F>::size(uint32_t level) const noexcept
+{
+    const VkExtent3D extent = this->extent(level);
+    const VkDeviceSize blocks = (VkDeviceSize)((extent.width + 3) / 4) * ((extent.height + 3) / 4);
+    return blocks * this->m_layer_count * format_sizeof(this->m_format);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+void vka::TextureCompressor<F>::compress(const uint8_t* data, const TextureCompressInfo& info)
+{
+    const uint32_t level = (uint32_t)this->m_levels.size();
+    const VkExtent3D extent3 = this->extent(level);
+    const VkExtent2D extent = { extent3.width, extent3.height };
+    const uint32_t block_rows = (extent.height + 3) / 4;
+    const size_t row_size = (size_t)((extent.width + 3) / 4) * format_sizeof(this->m_format);
+    const size_t src_size = (size_t)extent.width * extent.height * format_countof(F);
+
+    // Every row of blocks of every layer is a task.
+    std::unique_ptr<uint8_t[]> blocks(new uint8_t[row_size * block_rows * this->m_layer_count]);
+    const uint32_t task_count = block_rows * this->m_layer_count;
+    std::vector<std::exception_ptr> errors(task_count);
+    detail::texture::parallel_for(task_count, info.threadCount, errors.data(), [&](uint32_t i) {
+        const uint32_t layer = i / block_rows;
+        detail::texture::encode_blocks(
+            blocks.get() + row_size * i,
+            data + src_size * layer,
+            extent,
+            format_countof(F),
+            i % block_rows,
+            this->m_format,
+            info.quality == BlockQuality::HIGH
+        );
+    });
+    this->m_levels.push_back(std::move(blocks));
+}
@@ -0,0 +1,497 @@
+/**
+ * @brief Implementation for the texture container class.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    constexpr size_t KTX2_HEADER_SIZE = 80;
+    constexpr size_t KTX2_LEVEL_SIZE = 24;
+
+    constexpr uint32_t DDS_MAGIC = 0x20534444;          // "DDS "
+    constexpr uint32_t DDS_FOURCC_DX10 = 0x30315844;    // "DX10"
+    constexpr size_t DDS_HEADER_SIZE = 128;
+    constexpr size_t DDS_HEADER_DX10_SIZE = 148;
+    constexpr uint32_t DDS_PF_FOURCC = 0x4;
+    constexpr uint32_t DDS_PF_RGB = 0x40;
+    constexpr uint32_t DDS_CAPS2_CUBEMAP = 0x200;
+    constexpr uint32_t DDS_CAPS2_CUBEMAP_ALL_FACES = 0xFE00;
+    constexpr uint32_t DDS_CAPS2_VOLUME = 0x200000;
+    constexpr uint32_t DDS_DIMENSION_TEXTURE1D = 2;
+    constexpr uint32_t DDS_DIMENSION_TEXTURE3D = 4;
+    constexpr uint32_t DDS_MISC_TEXTURECUBE = 0x4;
+
+    /// Multiplies two sizes. Returns false if the product overflows.
+    constexpr bool checked_mul(uint64_t a, uint64_t b, uint64_t& product) noexcept
+    {
+        if (b != 0 && a > std::numeric_limits<uint64_t>::max() / b)
+            return false;
+        product = a * b;
+        return true;
+    }
+
+    constexpr uint32_t fourcc(const char (&code)[5]) noexcept
+    {
+        return (uint32_t)code[0] | (uint32_t)code[1] << 8 | (uint32_t)code[2] << 16 | (uint32_t)code[3] << 24;
+    }
+
+    /// Maps a file read-only into memory. Returns nullptr if the file could not be mapped.
+    const uint8_t* map_file(const char* path, size_t& size) noexcept
+    {
+#ifdef _WIN32
+        const HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return nullptr;
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return nullptr;
+        }
+        // The view keeps the mapping alive, so both handles can be closed immediately.
+        const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+            return nullptr;
+        const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        size = (size_t)file_size.QuadPart;
+        return (const uint8_t*)view;
+#else
+        const int fd = open(path, O_RDONLY);
+        if (fd < 0)
+            return nullptr;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            close(fd);
+            return nullptr;
+        }
+        // The mapping stays valid after closing the file descriptor.
+        void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED)
+            return nullptr;
+        madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+        size = (size_t)st.st_size;
+        return (const uint8_t*)view;
+#endif
+    }
+}
+
+vka::TextureContainer::TextureContainer(const char* path, uint32_t max_layer_count) :
+    m_file(nullptr),
+    m_file_size(0),
+    m_payload_offset(0),
+    m_payload_size(0),
+    m_format(VK_FORMAT_UNDEFINED),
+    m_extent{},
+    m_layer_count(0),
+    m_level_count(0),
+    m_cube(false),
+    m_contiguous(true)
+{
+    this->m_file = map_file(path, this->m_file_size);
+    if (this->m_file == nullptr) [[unlikely]]
+        detail::error::throw_invalid_argument(MSG_OPEN_FAILED);
+
+    try
+    {
+        if (this->m_file_size >= KTX2_HEADER_SIZE && memcmp(this->m_file, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0)
+            this->parse_ktx2(max_layer_count);
+        else if (this->m_file_size >= DDS_HEADER_SIZE && this->read<uint32_t>(0) == DDS_MAGIC)
+            this->parse_dds(max_layer_count);
+        else
+            detail::error::throw_runtime_error(MSG_INVALID);
+        this->pack();
+    }
+    catch (...)
+    {
+        this->unmap();
+        throw;
+    }
+}
+
+vka::TextureContainer::TextureContainer(TextureContainer&& src) noexcept :
+    m_file(src.m_file),
+    m_file_size(src.m_file_size),
+    m_payload_offset(src.m_payload_offset),
+    m_payload_size(src.m_payload_size),
+    m_format(src.m_format),
+    m_extent(src.m_extent),
+    m_layer_count(src.m_layer_count),
+    m_level_count(src.m_level_count),
+    m_cube(src.m_cube),
+    m_contiguous(src.m_contiguous),
+    m_subresources(std::move(src.m_subresources))
+{
+    src.m_file = nullptr;
+    src.m_file_size = 0;
+}
+
+vka::TextureContainer::~TextureContainer()
+{
+    this->unmap();
+}
+
+vka::TextureContainer& vka::TextureContainer::operator= (TextureContainer&& src) noexcept
+{
+    this->unmap();
+    this->m_file = src.m_file;
+    this->m_file_size = src.m_file_size;
+    this->m_payload_offset = src.m_payload_offset;
+    this->m_payload_size = src.m_payload_size;
+    this->m_format = src.m_format;
+    this->m_extent = src.m_extent;
+    this->m_layer_count = src.m_layer_count;
+    this->m_level_count = src.m_level_count;
+    this->m_cube = src.m_cube;
+    this->m_contiguous = src.m_contiguous;
+    this->m_subresources = std::move(src.m_subresources);
+    src.m_file = nullptr;
+    src.m_file_size = 0;
+    return *this;
+}
+
+std::vector<VkBufferImageCopy> vka::TextureContainer::regions(uint32_t layer, uint32_t level_count) const
+{
+    std::vector<VkBufferImageCopy> regions;
+    regions.reserve(this->m_subresources.size());
+    for (const Subresource& subresource : this->m_subresources)
+    {
+        if (subresource.level >= level_count)
+            continue;
+        regions.push_back({
+            .bufferOffset = subresource.offset,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = subresource.level,
+                .baseArrayLayer = layer + subresource.layer,
+                .layerCount = subresource.layer_count
+            },
+            .imageOffset = { 0, 0, 0 },
+            .imageExtent = common::mip_extent(this->m_extent, subresource.level)
+        });
+    }
+    return regions;
+}
+
+VkExtent2D vka::TextureContainer::block_extent(VkFormat format) noexcept
+{
+    // ASTC block extents in the order of the vulkan formats, every extent has an UNORM and an SRGB format.
+    constexpr VkExtent2D ASTC_EXTENTS[14] = {
+        {4, 4}, {5, 4}, {5, 5}, {6, 5}, {6, 6}, {8, 5}, {8, 6}, {8, 8}, {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12}
+    };
+
+    if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK)
+        return {4, 4};
+    if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+        return ASTC_EXTENTS[(format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2];
+    if (format >= VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK && format <= VK_FORMAT_ASTC_12x12_SFLOAT_BLOCK)
+        return ASTC_EXTENTS[format - VK_FORMAT_ASTC_4x4_SFLOAT_BLOCK];
+    if (format >= VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG && format <= VK_FORMAT_PVRTC2_4BPP_SRGB_BLOCK_IMG)
+        return (format - VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG) % 2 == 0 ? VkExtent2D{8, 4} : VkExtent2D{4, 4};
+    return {1, 1};
+}
+
+void vka::TextureContainer::parse_ktx2(uint32_t max_layer_count)
+{
+    const uint32_t vk_format = this->read<uint32_t>(12);
+    const uint32_t width = this->read<uint32_t>(20);
+    const uint32_t height = this->read<uint32_t>(24);
+    const uint32_t depth = this->read<uint32_t>(28);
+    const uint32_t layers = this->read<uint32_t>(32);
+    const uint32_t faces = this->read<uint32_t>(36);
+    const uint32_t levels = this->read<uint32_t>(40);
+    const uint32_t supercompression = this->read<uint32_t>(44);
+
+    if (supercompression != 0) [[unlikely]]
+        detail::error::throw_runtime_error(MSG_SUPERCOMPRESSED);
+    // Basis Universal payloads have an undefined format and must be transcoded first. Formats unknown to the size
+    // lookup are rejected before querying their size.
+    const bool known = vk_format <= 184 || detail::format::format_lut_offset((VkFormat)vk_format) != 0;
+    if (vk_format == VK_FORMAT_UNDEFINED || !known || format_sizeof((VkFormat)vk_format) == NSIZE) [[unlikely]]
+        detail::error::throw_runtime_error(MSG_UNSUPPORTED);
+    if (width == 0 || (faces != 1 && faces != 6)) [[unlikely]]
+        detail::error::throw_runtime_error(MSG_INVALID);
+
+    // Images cannot have more levels than their extent allows or more layers than the device supports. A level count
+    // of 0 requests the mip-map to be generated, which only leaves the base level in the file.
+    const uint64_t layer_count = (uint64_t)std::max(layers, 1u) * faces;
+    if (layer_count > max_layer_count) [[unlikely]]
+        detail::error::throw_runtime_error(MSG_UNSUPPORTED);
+    this->m_format = (VkFormat)vk_format;
+    this->m_extent = { width, std::max(height, 1u), std::max(depth, 1u) };
+    this->m_layer_count = (uint32_t)layer_count;
+    this->m_level_count = std::max(levels, 1u);
+    this->m_cube = faces == 6;
+    if (this->m_level_count > Texture::level_count(this->m_extent)) [[unlikely]]
+        detail::error::throw_runtime_error(MSG_INVALID);
+    if (KTX2_HEADER_SIZE + (size_t)this->m_level_count * KTX2_LEVEL_SIZE > this->m_file_size) [[unlikely]]
+        detail::error::throw_runtime_error(MSG_INVALID);
+
+    // Within a level the layers, faces and slices are packed in the order expected by vkCmdCopyBufferToImage. A level
+    // may be padded, but must not be smaller than its layers.
+    VkDeviceSize begin = std::numeric_limits<VkDeviceSize>::max();
+    VkDeviceSize end = 0;
+    for (uint32_t level = 0; level < this->m_level_count; level++)
+    {
+        const VkDeviceSize offset = this->read<uint64_t>(KTX2_HEADER_SIZE + level * KTX2_LEVEL_SIZE);
+        const VkDeviceSize length = this->read<uint64_t>(KTX2_HEADER_SIZE + level * KTX2_LEVEL_SIZE + 8);
+        const VkDeviceSize size = this->level_size(level, this->m_layer_count);
+        if (offset > this->m_file_size || length > this->m_file_size - offset || length < size) [[unlikely]]
+            detail::error::throw_runtime_error(MSG_INVALID);
+        begin = std::min(begin, offset);
+        end = std::max(end, offset + length);
+        this->m_subresources.push_back({ 0, offset, size, level, 0, this->m_layer_count });
+    }
+
+    for (Subresource& subresource : this->m_subresources)
+        subresource.source -= begin;
+    this->m_payload_offset = begin;
+    this->m_payload_size = end - begin;
+}
+
+void vka::TextureContainer::parse_dds(uint32_t max_layer_count)
+{
+    const uint32_t height = this->read<uint32_t>(12);
+    const uint32_t width = this->read<uint32_t>(16);
+    const uint32_t depth = this->read<uint32_t>(24);
+    const uint32_t levels = this->read<uint32_t>(28);
+    const uint32_t pf_flags = this->read<uint32_t>(80);
+    const uint32_t pf_fourcc = this->read<uint32_t>(84);
+    const uint32_t pf_bit_count = this->read<uint32_t>(88);
+    const uint32_t caps2 = this->read<uint32_t>(112);
+    uint32_t pf_masks[4];
+    memcpy(pf_masks, this->m_file + 92, sizeof(pf_masks));
+
+    if (this->read<uint32_t>(4) != 124 || width == 0 || height == 0) [[unlikely]]
+        detail::error::throw_runtime_error(MSG_INVALID);
+
+    size_t data_offset = DDS_HEADER_SIZE;
+    bool volume = (caps2 & DDS_CAPS2_VOLUME) != 0;
+    uint32_t layers = 1;
+    if ((pf_flags & DDS_PF_FOURCC) != 0 && pf_fourcc == DDS_FOURCC_DX10)
+    {
+        if (this->m_file_size < DDS_HEADER_DX10_SIZE) [[unlikely]]
+            detail::error::throw_runtime_error(MSG_INVALID);
+        const uint32_t dimension = this->read<uint32_t>(132);
+        const uint32_t misc = this->read<uint32_t>(136);
+        this->m_format = dxgi_format(this->read<uint32_t>(128));
+        this->m_cube = (misc & DDS_MISC_TEXTURECUBE) != 0;
+        volume = dimension == DDS_DIMENSION_TEXTURE3D;
+        const uint64_t layer_count = (uint64_t)std::max(this->read<uint32_t>(140), 1u) * (this->m_cube ? 6 : 1);
+        if (layer_count > max_layer_count) [[unlikely]]
+            detail::error::throw_runtime_error(MSG_UNSUPPORTED);
+        layers = (uint32_t)layer_count;
+        this->m_extent.height = dimension == DDS_DIMENSION_TEXTURE1D ? 1 : height;
+        data_offset = DDS_HEADER_DX10_SIZE;
+    }
+    else
+    {
+        this->m_format = dds_format(pf_flags, pf_fourcc, pf_bit_count, pf_masks);
+        this->m_cube = (caps2 & DDS_CAPS2_CUBEMAP) != 0;
+        // Cube maps with missing faces cannot be represented by a vulkan image.
+        if (this->m_cube && (caps2 & DDS_CAPS2_CUBEMAP_ALL_FACES) != DDS_CAPS2_CUBEMAP_ALL_FACES) [[unlikely]]
+            detail::error::throw_runtime_error(MSG_UNSUPPORTED);
+        layers = this->m_cube ? 6 : 1;
+        this->m_extent.height = height;
+    }
+    if (this->m_format == VK_FORMAT_UNDEFINED) [[unlikely]]
+        detail::error::throw_runtime_error(MSG_UNSUPPORTED);
+
+    this->m_extent.width = width;
+    this->m_extent.depth = volume ? std::max(depth, 1u) : 1;
+    this->m_layer_count = layers;
+    this->m_level_count = std::max(levels, 1u);
+    if (this->m_level_count > Texture::level_count(this->m_extent)) [[unlikely]]
+        detail::error::throw_runtime_error(MSG_INVALID);
+
+    // DDS stores all levels of a layer before the next layer, so that every layer of every level is a subresource.
+    // The sizes are checked against the file before they are summed up, so that the sum cannot overflow.
+    const VkDeviceSize payload_size = this->m_file_size - data_offset;
+    VkDeviceSize offset = 0;
+    for (uint32_t layer = 0; layer < this->m_layer_count; layer++)
+    {
+        for (uint32_t level = 0; level < this->m_level_count; level++)
+        {
+            const VkDeviceSize size = this->level_size(level, 1);
+            if (size > payload_size - offset) [[unlikely]]
+                detail::error::throw_runtime_error(MSG_INVALID);
+            this->m_subresources.push_back({ 0, offset, size, level, layer, 1 });
+            offset += size;
+        }
+    }
+
+    this->m_payload_offset = data_offset;
+    this->m_payload_size = offset;
+}
+
+VkDeviceSize vka::TextureContainer::level_size(uint32_t level, uint32_t layer_count) const
+{
+    const VkExtent2D block = block_extent(this->m_format);
+    const VkExtent3D extent = common::mip_extent(this->m_extent, level);
+    const uint64_t blocks_x = ((uint64_t)extent.width + block.width - 1) / block.width;
+    const uint64_t blocks_y = ((uint64_t)extent.height + block.height - 1) / block.height;
+    uint64_t size = blocks_x;
+    if (!checked_mul(size, blocks_y, size) || !checked_mul(size, extent.depth, size) || !checked_mul(size, layer_count, size) || !checked_mul(size, format_sizeof(this->m_format), size)) [[unlikely]]
+        detail::error::throw_runtime_error(MSG_INVALID);
+    return size;
+}
+
+void vka::TextureContainer::pack()
+{
+    // Buffer offsets of copies must be a multiple of the texel or block size and of 4. If the file already satisfies
+    // this, the payload keeps its layout and is copied in one go. Otherwise, the subresources are packed one after
+    // another with aligned offsets.
+    const VkDeviceSize alignment = std::lcm((VkDeviceSize)format_sizeof(this->m_format), (VkDeviceSize)4);
+    this->m_contiguous = std::ranges::all_of(this->m_subresources, [alignment](const Subresource& subresource) {
+        return subresource.source % alignment == 0;
+    });
+
+    if (this->m_contiguous)
+    {
+        for (Subresource& subresource : this->m_subresources)
+            subresource.offset = subresource.source;
+        return;
+    }
+
+    VkDeviceSize offset = 0;
+    for (Subresource& subresource : this->m_subresources)
+    {
+        subresource.offset = (offset + alignment - 1) / alignment * alignment;
+        offset = subresource.offset + subresource.size;
+    }
+    this->m_payload_size = offset;
+}
+
+void vka::TextureContainer::copy(void* dst) const noexcept
+{
+    const uint8_t* const payload = this->m_file + this->m_payload_offset;
+    if (this->m_contiguous)
+    {
+        memcpy(dst, payload, this->m_payload_size);
+        return;
+    }
+    for (const Subresource& subresource : this->m_subresources)
+        memcpy((uint8_t*)dst + subresource.offset, payload + subresource.source, subresource.size);
+}
+
+void vka::TextureContainer::unmap() noexcept
+{
+    if (this->m_file == nullptr)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(this->m_file);
+#else
+    munmap((void*)this->m_file, this->m_file_size);
+#endif
+    this->m_file = nullptr;
+    this->m_file_size = 0;
+}
+
+VkFormat vka::TextureContainer::dds_format(uint32_t flags, uint32_t fourcc, uint32_t bit_count, const uint32_t* masks) noexcept
+{
+    if ((flags & DDS_PF_FOURCC) != 0)
+    {
+        switch (fourcc)
+        {
+        case ::fourcc("DXT1"): return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+        case ::fourcc("DXT2"):
+        case ::fourcc("DXT3"): return VK_FORMAT_BC2_UNORM_BLOCK;
+        case ::fourcc("DXT4"):
+        case ::fourcc("DXT5"): return VK_FORMAT_BC3_UNORM_BLOCK;
+        case ::fourcc("ATI1"):
+        case ::fourcc("BC4U"): return VK_FORMAT_BC4_UNORM_BLOCK;
+        case ::fourcc("BC4S"): return VK_FORMAT_BC4_SNORM_BLOCK;
+        case ::fourcc("ATI2"):
+        case ::fourcc("BC5U"): return VK_FORMAT_BC5_UNORM_BLOCK;
+        case ::fourcc("BC5S"): return VK_FORMAT_BC5_SNORM_BLOCK;
+        // D3DFORMAT values stored in the fourcc field.
+        case 36:  return VK_FORMAT_R16G16B16A16_UNORM;
+        case 111: return VK_FORMAT_R16_SFLOAT;
+        case 112: return VK_FORMAT_R16G16_SFLOAT;
+        case 113: return VK_FORMAT_R16G16B16A16_SFLOAT;
+        case 114: return VK_FORMAT_R32_SFLOAT;
+        case 115: return VK_FORMAT_R32G32_SFLOAT;
+        case 116: return VK_FORMAT_R32G32B32A32_SFLOAT;
+        default:  return VK_FORMAT_UNDEFINED;
+        }
+    }
+    if ((flags & DDS_PF_RGB) != 0 && bit_count == 32)
+    {
+        if (masks[0] == 0x000000FF && masks[1] == 0x0000FF00 && masks[2] == 0x00FF0000)
+            return VK_FORMAT_R8G8B8A8_UNORM;
+        if (masks[0] == 0x00FF0000 && masks[1] == 0x0000FF00 && masks[2] == 0x000000FF)
+            return VK_FORMAT_B8G8R8A8_UNORM;
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+
+VkFormat vka::TextureContainer::dxgi_format(uint32_t dxgi) noexcept
+{
+    switch (dxgi)
+    {
+    case 2:  return VK_FORMAT_R32G32B32A32_SFLOAT;
+    case 3:  return VK_FORMAT_R32G32B32A32_UINT;
+    case 4:  return VK_FORMAT_R32G32B32A32_SINT;
+    case 6:  return VK_FORMAT_R32G32B32_SFLOAT;
+    case 10: return VK_FORMAT_R16G16B16A16_SFLOAT;
+    case 11: return VK_FORMAT_R16G16B16A16_UNORM;
+    case 12: return VK_FORMAT_R16G16B16A16_UINT;
+    case 13: return VK_FORMAT_R16G16B16A16_SNORM;
+    case 14: return VK_FORMAT_R16G16B16A16_SINT;
+    case 16: return VK_FORMAT_R32G32_SFLOAT;
+    case 24: return VK_FORMAT_A2B10G10R10_UNORM_PACK32;
+    case 26: return VK_FORMAT_B10G11R11_UFLOAT_PACK32;
+    case 28: return VK_FORMAT_R8G8B8A8_UNORM;
+    case 29: return VK_FORMAT_R8G8B8A8_SRGB;
+    case 30: return VK_FORMAT_R8G8B8A8_UINT;
+    case 31: return VK_FORMAT_R8G8B8A8_SNORM;
+    case 32: return VK_FORMAT_R8G8B8A8_SINT;
+    case 34: return VK_FORMAT_R16G16_SFLOAT;
+    case 35: return VK_FORMAT_R16G16_UNORM;
+    case 41: return VK_FORMAT_R32_SFLOAT;
+    case 49: return VK_FORMAT_R8G8_UNORM;
+    case 54: return VK_FORMAT_R16_SFLOAT;
+    case 56: return VK_FORMAT_R16_UNORM;
+    case 61: return VK_FORMAT_R8_UNORM;
+    case 67: return VK_FORMAT_E5B9G9R9_UFLOAT_PACK32;
+    case 71: return VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case 72: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+    case 74: return VK_FORMAT_BC2_UNORM_BLOCK;
+    case 75: return VK_FORMAT_BC2_SRGB_BLOCK;
+    case 77: return VK_FORMAT_BC3_UNORM_BLOCK;
+    case 78: return VK_FORMAT_BC3_SRGB_BLOCK;
+    case 80: return VK_FORMAT_BC4_UNORM_BLOCK;
+    case 81: return VK_FORMAT_BC4_SNORM_BLOCK;
+    case 83: return VK_FORMAT_BC5_UNORM_BLOCK;
+    case 84: return VK_FORMAT_BC5_SNORM_BLOCK;
+    case 87: return VK_FORMAT_B8G8R8A8_UNORM;
+    case 91: return VK_FORMAT_B8G8R8A8_SRGB;
+    case 95: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+    case 96: return VK_FORMAT_BC6H_SFLOAT_BLOCK;
+    case 98: return VK_FORMAT_BC7_UNORM_BLOCK;
+    case 99: return VK_FORMAT_BC7_SRGB_BLOCK;
+    default: return VK_FORMAT_UNDEFINED;
+    }
+}
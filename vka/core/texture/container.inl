@@ -0,0 +1,51 @@
+/**
+ * @brief Inline implementation for the texture container class.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+// ReSharper disable CppRedundantInlineSpecifier
+#pragma once
+
+#include "top.h"
+
+inline VkFormat vka::TextureContainer::format() const noexcept
+{
+    return this->m_format;
+}
+
+inline VkExtent3D vka::TextureContainer::extent() const noexcept
+{
+    return this->m_extent;
+}
+
+inline uint32_t vka::TextureContainer::layer_count() const noexcept
+{
+    return this->m_layer_count;
+}
+
+inline uint32_t vka::TextureContainer::level_count() const noexcept
+{
+    return this->m_level_count;
+}
+
+inline bool vka::TextureContainer::cube() const noexcept
+{
+    return this->m_cube;
+}
+
+inline VkDeviceSize vka::TextureContainer::size() const noexcept
+{
+    return this->m_payload_size;
+}
+
+template<typename T>
+inline T vka::TextureContainer::read(size_t offset) const noexcept
+{
+    // The file is not necessarily aligned for T.
+    T value;
+    memcpy(&value, this->m_file + offset, sizeof(T));
+    return value;
+}
@@ -0,0 +1,113 @@
+/**
+ * @brief Inline implementation for the texture converter class.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+// ReSharper disable CppRedundantInlineSpecifier
+#pragma once
+
+#include "top.h"
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+vka::TextureConverter<F>::TextureConverter(VkExtent3D extent, uint32_t layer_count, const TextureConvertInfo& info) :
+    m_format(info.format),
+    m_extent(extent),
+    m_layer_count(layer_count)
+{
+    if (!detail::texture::is_convert_format(info.format, format_countof(F))) [[unlikely]]
+        detail::error::throw_invalid_argument(MSG_UNSUPPORTED);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+vka::TextureConverter<F>::TextureConverter(const component_t* data, VkExtent2D extent, uint32_t layer_count, const TextureConvertInfo& info) :
+    TextureConverter({ extent.width, extent.height, 1 }, layer_count, info)
+{
+    this->convert(data, info.threadCount);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+vka::TextureConverter<F>::TextureConverter(const TextureLoader<F>& loader, const TextureConvertInfo& info) :
+    TextureConverter(loader.data(), { loader.extent2D().width, loader.extent2D().height }, loader.layer_count(), info)
+{}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+vka::TextureConverter<F>::TextureConverter(const TextureMerger<F>& merger, const TextureConvertInfo& info) :
+    TextureConverter(merger.extent(), 1, info)
+{
+    this->convert(merger.data(), info.threadCount);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+vka::TextureConverter<F>::TextureConverter(const TextureMipChain<F>& mips, const TextureConvertInfo& info) :
+    TextureConverter(mips.extent(0), mips.layer_count(), info)
+{
+    this->m_levels.reserve(mips.level_count());
+    for (uint32_t level = 0; level < mips.level_count(); level++)
+        this->convert(mips.data(level), info.threadCount);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline VkFormat vka::TextureConverter<F>::format() const noexcept
+{
+    return this->m_format;
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline uint32_t vka::TextureConverter<F>::level_count() const noexcept
+{
+    return (uint32_t)this->m_levels.size();
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline uint32_t vka::TextureConverter<F>::layer_count() const noexcept
+{
+    return this->m_layer_count;
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline VkExtent3D vka::TextureConverter<F>::extent(uint32_t level) const noexcept
+{
+    return common::mip_extent(this->m_extent, level);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline const uint8_t* vka::TextureConverter<F>::data(uint32_t level) const noexcept
+{
+    return this->m_levels[level].get();
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline VkDeviceSize vka::TextureConverter<F>::size(uint32_t level) const noexcept
+{
+    const VkExtent3D extent = this->extent(level);
+    return (VkDeviceSize)extent.width * extent.height * extent.depth * this->m_layer_count * format_sizeof(this->m_format);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+void vka::TextureConverter<F>::convert(const component_t* data, uint32_t thread_count)
+{
+    const uint32_t level = (uint32_t)this->m_levels.size();
+    const VkExtent3D extent = this->extent(level);
+    const uint64_t px_count = (uint64_t)extent.width * extent.height * extent.depth * this->m_layer_count;
+    const size_t texel_size = format_sizeof(this->m_format);
+
+    // The layers are tightly packed, so that the level is converted as a single array of pixels.
+    std::unique_ptr<uint8_t[]> pixels(new uint8_t[px_count * texel_size]);
+    const uint32_t task_count = (uint32_t)((px_count + TASK_PIXELS - 1) / TASK_PIXELS);
+    std::vector<std::exception_ptr> errors(task_count);
+    detail::texture::parallel_for(task_count, thread_count, errors.data(), [&](uint32_t i) {
+        const uint64_t begin = i * TASK_PIXELS;
+        detail::texture::convert_texels(
+            pixels.get() + begin * texel_size,
+            data + begin * format_countof(F),
+            detail::texture::format_type_id(F),
+            format_countof(F),
+            std::min(TASK_PIXELS, px_count - begin),
+            this->m_format
+        );
+    });
+    this->m_levels.push_back(std::move(pixels));
+}
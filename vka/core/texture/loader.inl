@@ -5,17 +5,25 @@
 
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 vka::TextureLoader<F>::TextureLoader(VkExtent3D extent) noexcept :
-    m_data(new component_t[alloc_size(extent)]{}),
+    m_data(nullptr),
     m_extent(extent),
-    m_alloc_layers(extent.depth)
-{}
+    m_alloc_layers(0),
+    m_reserved_layers(0),
+    m_external(false)
+{
+    this->allocate({ extent.width, extent.height }, extent.depth);
+}
 
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 vka::TextureLoader<F>::TextureLoader(VkExtent2D extent, uint32_t estimated_layers) noexcept :
-    m_data(new component_t[alloc_size({ extent.width, extent.height, alloc_layers(estimated_layers) })]{}),
+    m_data(nullptr),
     m_extent({ extent.width, extent.height, 0 }),
-    m_alloc_layers(alloc_layers(estimated_layers))
-{}
+    m_alloc_layers(0),
+    m_reserved_layers(0),
+    m_external(false)
+{
+    this->allocate(extent, alloc_layers(estimated_layers));
+}
 
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 vka::TextureLoader<F>::TextureLoader(const component_t* data, VkFormat format, VkExtent2D extent, uint32_t estimated_layers) :
@@ -49,22 +57,34 @@ template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 vka::TextureLoader<F>::TextureLoader(const char* path, uint32_t estimated_layers) :
     m_data(nullptr),
     m_extent{},
-    m_alloc_layers(alloc_layers(estimated_layers))
+    m_alloc_layers(0),
+    m_reserved_layers(0),
+    m_external(false)
 {
     VkExtent2D extent; uint32_t components;
     std::unique_ptr<component_t[]> data =  detail::texture::load<F>(path, extent, components);
-    const VkExtent3D alloc_extent = { extent.width, extent.height, this->m_alloc_layers };
 
-    this->m_data = new component_t[alloc_size(alloc_extent)]{};
     this->m_extent = { extent.width, extent.height, 0 };
+    this->allocate(extent, alloc_layers(estimated_layers));
     this->copy_image2D(data.get(), components);
 }
 
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+vka::TextureLoader<F>::TextureLoader(component_t* storage, VkExtent2D extent, uint32_t layer_capacity) noexcept :
+    m_data(storage),
+    m_extent({ extent.width, extent.height, 0 }),
+    m_alloc_layers(layer_capacity),
+    m_reserved_layers(layer_capacity),
+    m_external(true)
+{}
+
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 inline vka::TextureLoader<F>::TextureLoader(TextureLoader&& src) noexcept :
     m_data(src.m_data),
     m_extent(src.m_extent),
-    m_alloc_layers(src.m_alloc_layers)
+    m_alloc_layers(src.m_alloc_layers),
+    m_reserved_layers(src.m_reserved_layers),
+    m_external(src.m_external)
 {
     src.m_data = nullptr;
 }
@@ -72,16 +92,20 @@ inline vka::TextureLoader<F>::TextureLoader(TextureLoader&& src) noexcept :
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 inline vka::TextureLoader<F>::~TextureLoader()
 {
-    delete[] this->m_data;
+    if (!this->m_external)
+        detail::texture::release_pages(this->m_data, alloc_size({ this->m_extent.width, this->m_extent.height, this->m_reserved_layers }));
 }
 
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 inline vka::TextureLoader<F>& vka::TextureLoader<F>::operator= (TextureLoader&& src) noexcept
 {
-    delete[] this->m_data;
+    if (!this->m_external)
+        detail::texture::release_pages(this->m_data, alloc_size({ this->m_extent.width, this->m_extent.height, this->m_reserved_layers }));
     this->m_data = src.m_data;
     this->m_alloc_layers = src.m_alloc_layers;
+    this->m_reserved_layers = src.m_reserved_layers;
     this->m_extent = src.m_extent;
+    this->m_external = src.m_external;
     src.m_data = nullptr;
     return *this;
 }
@@ -111,7 +135,21 @@ inline uint32_t vka::TextureLoader<F>::layer_count() const noexcept
 }
 
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
-void vka::TextureLoader<F>::load(const component_t* data, VkFormat format) noexcept
+inline bool vka::TextureLoader<F>::external() const noexcept
+{
+    return this->m_external;
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline VkExtent2D vka::TextureLoader<F>::file_extent(const char* path)
+{
+    VkExtent2D extent; uint32_t components;
+    detail::texture::info(path, extent, components);
+    return extent;
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+void vka::TextureLoader<F>::load(const component_t* data, VkFormat format)
 {
     if (this->m_extent.depth == this->m_alloc_layers)
         this->grow();
@@ -119,7 +157,7 @@ void vka::TextureLoader<F>::load(const component_t* data, VkFormat format) noexc
 }
 
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
-void vka::TextureLoader<F>::load(const component_t* color, uint32_t comp) noexcept
+void vka::TextureLoader<F>::load(const component_t* color, uint32_t comp)
 {
     if (this->m_extent.depth == this->m_alloc_layers)
         this->grow();
@@ -139,27 +177,106 @@ void vka::TextureLoader<F>::load(const char* path)
     this->copy_image2D(data.get(), components);
 }
 
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+std::vector<std::exception_ptr> vka::TextureLoader<F>::load_many(std::span<const char* const> paths, uint32_t thread_count)
+{
+    const uint32_t count = static_cast<uint32_t>(paths.size());
+    const uint32_t base = this->m_extent.depth;
+    this->reserve(base + count);
+    this->m_extent.depth += count;
+
+    const uint64_t px_count = (uint64_t)this->m_extent.width * this->m_extent.height;
+    std::vector<std::exception_ptr> errors(count);
+    detail::texture::parallel_for(count, thread_count, errors.data(), [&](uint32_t i) {
+        VkExtent2D extent; uint32_t components;
+        std::unique_ptr<component_t[]> data = detail::texture::load<F>(paths[i], extent, components);
+        if (!detail::common::cmpeq_extent(this->m_extent, extent)) [[unlikely]]
+            detail::error::throw_runtime_error(MSG_EXTENT_MISSMATCH);
+
+        component_t* const layer = this->m_data + format_countof(F) * (base + i) * px_count;
+        this->clear_layer(layer, components);
+        detail::texture::copy_image<F>(layer, data.get(), px_count, components, 0);
+    });
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (errors[i] != nullptr)
+            this->clear_layer(this->m_data + format_countof(F) * (base + i) * px_count, 0);
+    }
+    return errors;
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+void vka::TextureLoader<F>::allocate(VkExtent2D extent, uint32_t layers)
+{
+    uint32_t reserved = reserved_layers(extent, layers);
+    void* data = detail::texture::reserve_pages(alloc_size({ extent.width, extent.height, reserved }));
+
+    // The address space of the process may be limited, e.g. by RLIMIT_AS or on 32-bit targets with multiple loaders,
+    // even though the layers themselves fit.
+    if (data == nullptr && reserved > layers) [[unlikely]]
+    {
+        reserved = layers;
+        data = detail::texture::reserve_pages(alloc_size({ extent.width, extent.height, reserved }));
+    }
+    if (data == nullptr) [[unlikely]]
+        detail::error::throw_bad_alloc();
+    if (!detail::texture::commit_pages(data, alloc_size({ extent.width, extent.height, layers }))) [[unlikely]]
+    {
+        detail::texture::release_pages(data, alloc_size({ extent.width, extent.height, reserved }));
+        detail::error::throw_bad_alloc();
+    }
+
+    this->m_data = static_cast<component_t*>(data);
+    this->m_alloc_layers = layers;
+    this->m_reserved_layers = reserved;
+}
+
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 void vka::TextureLoader<F>::grow()
 {
-    const uint32_t new_layers = this->m_extent.depth + grow_factor(this->m_extent.depth);
-    const size_t old_size = alloc_size(this->m_extent);
-    const size_t new_size = alloc_size({ this->m_extent.width, this->m_extent.height, new_layers });
+    this->reserve(this->m_extent.depth + grow_factor(this->m_extent.depth));
+}
 
-    component_t* const new_data = new component_t[new_size]{};
-    memcpy(new_data, this->m_data, old_size);
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+void vka::TextureLoader<F>::reserve(uint32_t layers)
+{
+    if (layers <= this->m_alloc_layers)
+        return;
+    if (this->m_external) [[unlikely]]
+        detail::error::throw_out_of_range(MSG_STORAGE_FULL);
+
+    // Committing more pages of the reservation keeps the layers in place. Only if the reservation is exhausted, the
+    // layers are moved into a new one.
+    if (layers <= this->m_reserved_layers)
+    {
+        if (!detail::texture::commit_pages(this->m_data, alloc_size({ this->m_extent.width, this->m_extent.height, layers }))) [[unlikely]]
+            detail::error::throw_bad_alloc();
+        this->m_alloc_layers = layers;
+        return;
+    }
 
-    delete[] this->m_data;
-    this->m_data = new_data;
-    this->m_alloc_layers = new_layers;
+    component_t* const old_data = this->m_data;
+    const uint32_t old_reserved = this->m_reserved_layers;
+    this->allocate({ this->m_extent.width, this->m_extent.height }, layers);
+    memcpy(this->m_data, old_data, alloc_size(this->m_extent));
+    detail::texture::release_pages(old_data, alloc_size({ this->m_extent.width, this->m_extent.height, old_reserved }));
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline void vka::TextureLoader<F>::clear_layer(component_t* layer, uint32_t img_comp) const noexcept
+{
+    if (this->m_external && img_comp < format_countof(F))
+        memset(layer, 0, alloc_size(this->extent2D()));
 }
 
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 inline void vka::TextureLoader<F>::copy_image2D(const component_t* data, uint32_t img_comp) noexcept
 {
     const uint64_t px_count = (uint64_t)this->m_extent.width * this->m_extent.height;
-    const size_t offset = format_countof(F) * this->m_extent.depth * px_count;
-    detail::texture::copy_image<F>(this->m_data + offset, data, px_count, img_comp, 0);
+    component_t* const layer = this->m_data + format_countof(F) * this->m_extent.depth * px_count;
+    this->clear_layer(layer, img_comp);
+    detail::texture::copy_image<F>(layer, data, px_count, img_comp, 0);
     ++this->m_extent.depth;
 }
 
@@ -174,8 +291,9 @@ template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 inline void vka::TextureLoader<F>::fill_image2D(const component_t* color, uint32_t img_comp) noexcept
 {
     const uint64_t px_count = (uint64_t)this->m_extent.width * this->m_extent.height;
-    const size_t offset = format_countof(F) * this->m_extent.depth * px_count;
-    detail::texture::fill_image<F>(this->m_data + offset, color, px_count, img_comp, 0);
+    component_t* const layer = this->m_data + format_countof(F) * this->m_extent.depth * px_count;
+    this->clear_layer(layer, img_comp);
+    detail::texture::fill_image<F>(layer, color, px_count, img_comp, 0);
     ++this->m_extent.depth;
 }
 
@@ -198,6 +316,18 @@ inline uint32_t vka::TextureLoader<F>::alloc_layers(uint32_t estimated_layers) n
     return estimated_layers < 1 ? 1 : estimated_layers;
 }
 
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline uint32_t vka::TextureLoader<F>::reserved_layers(VkExtent2D extent, uint32_t layers) noexcept
+{
+    const size_t layer_size = std::max<size_t>(alloc_size({ extent.width, extent.height, 1 }), 1);
+    const size_t limit = std::min<size_t>({
+        (size_t)layers * detail::texture::LOADER_RESERVE_FACTOR,
+        detail::texture::LOADER_RESERVED_LAYERS,
+        detail::texture::LOADER_RESERVED_SIZE / layer_size
+    });
+    return std::max(layers, (uint32_t)limit);
+}
+
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 inline uint32_t vka::TextureLoader<F>::grow_factor(uint32_t layer_count) noexcept
 {
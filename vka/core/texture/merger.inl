@@ -109,6 +109,34 @@ void vka::TextureMerger<F>::load(const char* path)
     }
 }
 
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+std::vector<std::exception_ptr> vka::TextureMerger<F>::load_many(std::span<const char* const> paths, uint32_t thread_count)
+{
+    // The component offset of a file depends on the files before it, therefore only decoding is done concurrently.
+    const uint32_t count = static_cast<uint32_t>(paths.size());
+    std::vector<std::unique_ptr<component_t[]>> images(count);
+    std::vector<uint32_t> components(count);
+    std::vector<std::exception_ptr> errors(count);
+    detail::texture::parallel_for(count, thread_count, errors.data(), [&](uint32_t i) {
+        VkExtent2D extent;
+        images[i] = detail::texture::load<F>(paths[i], extent, components[i]);
+        if (!detail::common::cmpeq_extent(this->m_extent, extent) || this->m_extent.depth != 1) [[unlikely]]
+        {
+            images[i].reset();
+            detail::error::throw_runtime_error(MSG_EXTENT_MISSMATCH);
+        }
+    });
+
+    // The number of components of a failed file is unknown, so skipping it would shift the channels of all following
+    // files. Therefore, nothing is merged if any file failed.
+    if (std::ranges::any_of(errors, [](const std::exception_ptr& error) { return error != nullptr; }))
+        return errors;
+
+    for (uint32_t i = 0; i < count && this->m_component_idx < format_countof(F); i++)
+        this->copy_image(images[i].get(), components[i]);
+    return errors;
+}
+
 template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
 inline void vka::TextureMerger<F>::copy_image(const component_t* data, uint32_t img_comp) noexcept
 {
@@ -0,0 +1,141 @@
+/**
+ * @brief Inline implementation for the texture mip-chain class.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+// ReSharper disable CppRedundantInlineSpecifier
+#pragma once
+
+#include "top.h"
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+vka::TextureMipChain<F>::TextureMipChain(const component_t* data, VkExtent2D extent, uint32_t layer_count, const TextureMipInfo& info) :
+    m_source(data),
+    m_extent(extent),
+    m_layer_count(layer_count)
+{
+    this->generate(info);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+vka::TextureMipChain<F>::TextureMipChain(const TextureLoader<F>& loader, const TextureMipInfo& info) :
+    TextureMipChain(loader.data(), { loader.extent2D().width, loader.extent2D().height }, loader.layer_count(), info)
+{}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline uint32_t vka::TextureMipChain<F>::level_count() const noexcept
+{
+    return (uint32_t)this->m_levels.size() + 1;
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline uint32_t vka::TextureMipChain<F>::layer_count() const noexcept
+{
+    return this->m_layer_count;
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline VkExtent3D vka::TextureMipChain<F>::extent(uint32_t level) const noexcept
+{
+    return common::mip_extent({ this->m_extent.width, this->m_extent.height, 1 }, level);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline const typename vka::TextureMipChain<F>::component_t* vka::TextureMipChain<F>::data(uint32_t level) const noexcept
+{
+    return level == 0 ? this->m_source : this->m_levels[level - 1].get();
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+inline VkDeviceSize vka::TextureMipChain<F>::size(uint32_t level) const noexcept
+{
+    const VkExtent3D extent = this->extent(level);
+    return (VkDeviceSize)extent.width * extent.height * this->m_layer_count * format_sizeof(F);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+void vka::TextureMipChain<F>::generate(const TextureMipInfo& info)
+{
+    constexpr uint32_t C = format_countof(F);
+    const detail::texture::MipParams params = {
+        .kaiser = info.filter == MipFilter::KAISER,
+        .srgb = info.srgb,
+        .normal_map = info.normalMap
+    };
+
+    uint32_t level_count = detail::common::max_ilog2({ this->m_extent.width, this->m_extent.height, 1 }) + 1;
+    if (info.levelCount != 0)
+        level_count = std::min(level_count, info.levelCount);
+    this->m_levels.reserve(level_count - 1);
+
+    float weights[2 * detail::texture::KAISER_RADIUS];
+    detail::texture::kaiser_weights(weights);
+
+    // The previous level is kept as float, so that it is not quantized before computing the next level.
+    std::vector<float> src_levels, dst_levels, rows;
+    for (uint32_t level = 1; level < level_count; level++)
+    {
+        const VkExtent3D src3 = this->extent(level - 1);
+        const VkExtent3D dst3 = this->extent(level);
+        const VkExtent2D src_extent = { src3.width, src3.height };
+        const VkExtent2D dst_extent = { dst3.width, dst3.height };
+        const uint64_t src_size = (uint64_t)src_extent.width * src_extent.height * C;
+        const uint64_t dst_size = (uint64_t)dst_extent.width * dst_extent.height * C;
+        const uint64_t rows_size = (uint64_t)dst_extent.width * src_extent.height * C;
+
+        dst_levels.resize(dst_size * this->m_layer_count);
+        std::unique_ptr<component_t[]> encoded(new component_t[dst_size * this->m_layer_count]);
+
+        const auto encode = [&](uint32_t layer, uint32_t row_begin, uint32_t row_end) {
+            const uint64_t offset = layer * dst_size + (uint64_t)row_begin * dst_extent.width * C;
+            const uint64_t px_count = (uint64_t)(row_end - row_begin) * dst_extent.width;
+            detail::texture::mip_encode<component_t, C>(encoded.get() + offset, dst_levels.data() + offset, px_count, params);
+        };
+
+        if (params.kaiser)
+        {
+            rows.resize(rows_size * this->m_layer_count);
+            this->for_each_band(src_extent.height, info.threadCount, [&](uint32_t layer, uint32_t row_begin, uint32_t row_end) {
+                if (level == 1)
+                    detail::texture::mip_filter_rows<component_t, C>(rows.data() + layer * rows_size, this->m_source + layer * src_size, src_extent, dst_extent.width, row_begin, row_end, weights, params);
+                else
+                    detail::texture::mip_filter_rows<float, C>(rows.data() + layer * rows_size, src_levels.data() + layer * src_size, src_extent, dst_extent.width, row_begin, row_end, weights, params);
+            });
+            this->for_each_band(dst_extent.height, info.threadCount, [&](uint32_t layer, uint32_t row_begin, uint32_t row_end) {
+                detail::texture::mip_filter_columns<C>(dst_levels.data() + layer * dst_size, rows.data() + layer * rows_size, dst_extent.width, src_extent.height, row_begin, row_end, weights);
+                encode(layer, row_begin, row_end);
+            });
+        }
+        else
+        {
+            this->for_each_band(dst_extent.height, info.threadCount, [&](uint32_t layer, uint32_t row_begin, uint32_t row_end) {
+                if (level == 1)
+                    detail::texture::mip_filter_box<component_t, C>(dst_levels.data() + layer * dst_size, this->m_source + layer * src_size, src_extent, dst_extent, row_begin, row_end, params);
+                else
+                    detail::texture::mip_filter_box<float, C>(dst_levels.data() + layer * dst_size, src_levels.data() + layer * src_size, src_extent, dst_extent, row_begin, row_end, params);
+                encode(layer, row_begin, row_end);
+            });
+        }
+
+        this->m_levels.push_back(std::move(encoded));
+        std::swap(src_levels, dst_levels);
+    }
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+template<typename Func>
+void vka::TextureMipChain<F>::for_each_band(uint32_t rows, uint32_t thread_count, const Func& func) const
+{
+    const uint32_t band_count = (rows + detail::texture::MIP_BAND_ROWS - 1) / detail::texture::MIP_BAND_ROWS;
+    const uint32_t task_count = band_count * this->m_layer_count;
+
+    // The filters do not throw, so no error is ever stored.
+    std::vector<std::exception_ptr> errors(task_count);
+    detail::texture::parallel_for(task_count, thread_count, errors.data(), [&](uint32_t i) {
+        const uint32_t row_begin = (i % band_count) * detail::texture::MIP_BAND_ROWS;
+        func(i / band_count, row_begin, std::min(row_begin + detail::texture::MIP_BAND_ROWS, rows));
+    });
+}
@@ -13,6 +13,9 @@
 vka::Texture::Texture(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const TextureCreateInfo& create_info) :
     m_texture(create_texture(device, properties, create_info)),
     m_extent(create_info.imageExtent),
+    m_format(create_info.imageFormat),
+    m_type(create_info.imageType),
+    m_usage(image_usage(create_info.imageUsage)),
     m_layer_count(create_info.imageArrayLayers - 1),
     m_level_count(mip_level_count(create_info))
 {
@@ -39,6 +42,45 @@ void vka::Texture::load(VkCommandBuffer cbo, const Buffer& data, uint32_t layer,
     vkCmdCopyBufferToImage(cbo, data.handle(), this->m_texture.get().image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
 }
 
+void vka::Texture::load(VkCommandBuffer cbo, const Buffer& data, const TextureUploadLayout& layout)
+{
+    const std::vector<VkBufferImageCopy> regions = this->upload_regions(layout);
+    vkCmdCopyBufferToImage(cbo, data.handle(), this->m_texture.get().image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)regions.size(), regions.data());
+}
+
+vka::Buffer vka::Texture::load(VkCommandBuffer cbo, const void* data, const TextureUploadLayout& layout, TextureLoadInfo info)
+{
+    std::vector<VkBufferImageCopy> regions(upload_region_count(layout));
+    const VkDeviceSize size = this->upload_layout(layout, regions.data());
+    Buffer staging = stage(this->m_texture.parent(), data, size, info);
+    vkCmdCopyBufferToImage(cbo, staging.handle(), this->m_texture.get().image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)regions.size(), regions.data());
+    return staging;
+}
+
+VkDeviceSize vka::Texture::upload_size(const TextureUploadLayout& layout) const noexcept
+{
+    return this->upload_layout(layout, nullptr);
+}
+
+std::vector<VkBufferImageCopy> vka::Texture::upload_regions(const TextureUploadLayout& layout) const
+{
+    std::vector<VkBufferImageCopy> regions(upload_region_count(layout));
+    this->upload_layout(layout, regions.data());
+    return regions;
+}
+
+vka::Buffer vka::Texture::load(VkCommandBuffer cbo, const TextureContainer& container, TextureLoadInfo info, uint32_t layer)
+{
+    // If the payload is aligned in the file, the container copies it into the staging buffer in one go.
+    const std::vector<VkBufferImageCopy> regions = container.regions(layer, this->m_level_count);
+    Buffer staging = create_staging(this->m_texture.parent(), container.size(), info);
+    container.copy(staging.map());
+    staging.flush();
+    staging.unmap();
+    vkCmdCopyBufferToImage(cbo, staging.handle(), this->m_texture.get().image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (uint32_t)regions.size(), regions.data());
+    return staging;
+}
+
 // ReSharper disable once CppMemberFunctionMayBeConst
 void vka::Texture::finish(VkCommandBuffer cbo, VkPipelineStageFlags stages) noexcept
 {
@@ -268,7 +310,55 @@ void vka::Texture::create_mipmap(VkCommandBuffer cbo) const noexcept
     }
 }
 
-vka::Buffer vka::Texture::stage(VkDevice device, const void* data, VkDeviceSize size, TextureLoadInfo info)
+VkDeviceSize vka::Texture::upload_layout(const TextureUploadLayout& layout, VkBufferImageCopy* regions) const noexcept
+{
+    // Buffer offsets must be a multiple of the texel or block size and of 4, row pitches of the texel or block size.
+    const VkExtent2D block = TextureContainer::block_extent(this->m_format);
+    const VkDeviceSize block_size = format_sizeof(this->m_format);
+    VkDeviceSize alignment = std::lcm(block_size, (VkDeviceSize)4);
+    if (layout.subresourceAlignment != 0)
+        alignment = std::lcm(alignment, layout.subresourceAlignment);
+    const VkDeviceSize row_alignment = layout.rowPitchAlignment != 0 ? std::lcm(block_size, (VkDeviceSize)layout.rowPitchAlignment) : block_size;
+
+    const bool level_major = layout.order == TextureUploadOrder::LEVEL_MAJOR;
+    const uint32_t outer_count = level_major ? 1 : layout.layerCount;
+    const uint32_t layers_per_region = level_major ? layout.layerCount : 1;
+    VkDeviceSize offset = layout.bufferOffset;
+    uint32_t region = 0;
+    for (uint32_t outer = 0; outer < outer_count; outer++)
+    {
+        for (uint32_t i = 0; i < layout.levelCount; i++)
+        {
+            const uint32_t level = layout.baseLevel + i;
+            const VkExtent3D extent = common::mip_extent(this->m_extent, level);
+            const VkDeviceSize blocks_x = (extent.width + block.width - 1) / block.width;
+            const VkDeviceSize blocks_y = (extent.height + block.height - 1) / block.height;
+            const VkDeviceSize row_pitch = (blocks_x * block_size + row_alignment - 1) / row_alignment * row_alignment;
+
+            offset = (offset + alignment - 1) / alignment * alignment;
+            if (regions != nullptr)
+            {
+                regions[region++] = {
+                    .bufferOffset = offset,
+                    .bufferRowLength = layout.rowPitchAlignment != 0 ? (uint32_t)(row_pitch / block_size * block.width) : 0,
+                    .bufferImageHeight = 0,
+                    .imageSubresource = {
+                        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                        .mipLevel = level,
+                        .baseArrayLayer = layout.baseLayer + outer,
+                        .layerCount = layers_per_region
+                    },
+                    .imageOffset = ZERO_OFFSET,
+                    .imageExtent = extent
+                };
+            }
+            offset += row_pitch * blocks_y * extent.depth * layers_per_region;
+        }
+    }
+    return offset;
+}
+
+vka::Buffer vka::Texture::create_staging(VkDevice device, VkDeviceSize size, TextureLoadInfo info)
 {
     const BufferCreateInfo crate_info = {
         .pBufferNext = nullptr,
@@ -279,10 +369,23 @@ vka::Buffer vka::Texture::stage(VkDevice device, const void* data, VkDeviceSize
         .bufferQueueFamilyIndexCount = 1,
         .bufferQueueFamilyIndices = &info.queueFamilyIndex,
         .pMemoryNext = nullptr,
-        .memoryType = info.memoryPropertyFlags
+        .memoryType = info.memoryPropertyFlags,
+        .memoryTypePreferred = 0,
+        .memoryTypeForbidden = 0,
+        .memoryAllocator = nullptr,
+        .memoryNonCoherentAtomSize = 0,
+        .memoryPersistentMap = false,
+        .memoryTracker = nullptr,
+        .memoryDebugName = nullptr
     };
-    Buffer buffer(device, *info.memoryProperties, crate_info);
+    return Buffer(device, *info.memoryProperties, crate_info);
+}
+
+vka::Buffer vka::Texture::stage(VkDevice device, const void* data, VkDeviceSize size, TextureLoadInfo info)
+{
+    Buffer buffer = create_staging(device, size, info);
     memcpy(buffer.map(), data, size);
+    buffer.flush();
     buffer.unmap();
     return buffer;
 }
@@ -294,7 +397,7 @@ vka::unique_handle<vka::Texture::Handle> vka::Texture::create_texture(VkDevice d
     const VkImageCreateInfo image_create_info = {
         .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
         .pNext = nullptr,
-        .flags = create_info.imageFlags,
+        .flags = image_flags(create_info.imageFlags, create_info.imageFormat, create_info.imageUsage),
         .imageType = create_info.imageType,
         .format = create_info.imageFormat,
         .extent = create_info.imageExtent,
@@ -302,7 +405,7 @@ vka::unique_handle<vka::Texture::Handle> vka::Texture::create_texture(VkDevice d
         .arrayLayers = create_info.imageArrayLayers,
         .samples = VK_SAMPLE_COUNT_1_BIT,
         .tiling = VK_IMAGE_TILING_OPTIMAL,
-        .usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        .usage = image_usage(create_info.imageUsage),
         .sharingMode = create_info.imageQueueFamilyIndexCount > 1 ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
         .queueFamilyIndexCount = create_info.imageQueueFamilyIndexCount,
         .pQueueFamilyIndices = create_info.imageQueueFamilyIndices,
@@ -314,50 +417,30 @@ vka::unique_handle<vka::Texture::Handle> vka::Texture::create_texture(VkDevice d
 
     // query memory requirements
     VkMemoryRequirements requirements;
-    vkGetImageMemoryRequirements(device, image, &requirements);
-
-    // allocate memory
-    const VkMemoryAllocateInfo allocate_info = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+    VkMemoryDedicatedRequirements dedicated_requirements;
+    memory::get_requirements(device, image, requirements, dedicated_requirements);
+    const bool dedicated = memory::use_dedicated(create_info.memoryAllocator, dedicated_requirements, requirements.size);
+    const VkMemoryDedicatedAllocateInfo dedicated_ai = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO,
         .pNext = nullptr,
-        .allocationSize = requirements.size,
-        .memoryTypeIndex = memory::find_type_index(properties, requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+        .image = image,
+        .buffer = VK_NULL_HANDLE
     };
-    VkDeviceMemory memory;
-    check_result(vkAllocateMemory(device, &allocate_info, nullptr, &memory), ALLOC_MEMORY_FAILED);
-    unique_handle memory_guard(device, memory);
-    check_result(vkBindImageMemory(device, image, memory, 0), BIND_MEMORY_FAILED);
 
-    // create sampler
-    const VkSamplerCreateInfo sampler_create_info = {
-        .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
-        .pNext = nullptr,
-        .flags = 0,
-        .magFilter = create_info.samplerMagFilter,
-        .minFilter = create_info.samplerMinFilter,
-        .mipmapMode = create_info.samplerMipmapMode,
-        .addressModeU = create_info.samplerAddressModeU,
-        .addressModeV = create_info.samplerAddressModeV,
-        .addressModeW = create_info.samplerAddressModeW,
-        .mipLodBias = create_info.samplerLodBias,
-        .anisotropyEnable = create_info.samplerAnisotropyEnable,
-        .maxAnisotropy = create_info.samplerMaxAnisotropy,
-        .compareEnable = create_info.samplerCompareEnable,
-        .compareOp = create_info.samplerCompareOp,
-        .minLod = create_info.samplerMinLod,
-        .maxLod = create_info.samplerMaxLod,
-        .borderColor = create_info.samplerBorderColor,
-        .unnormalizedCoordinates = create_info.samplerUnnormalizedCoordinates
-    };
-    VkSampler sampler;
-    check_result(vkCreateSampler(device, &sampler_create_info, nullptr, &sampler), SAMPLER_CREATE_FAILED);
-    unique_handle sampler_guard(device, sampler);
+    // allocate memory
+    detail::memory::Allocation allocation;
+    check_result(memory::allocate(device, properties, create_info.memoryAllocator, requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, 0, true, dedicated ? &dedicated_ai : nullptr, allocation), ALLOC_MEMORY_FAILED);
+    if (create_info.memoryTracker != nullptr)
+        create_info.memoryTracker->track(MemoryObjectType::TEXTURE, create_info.memoryDebugName, dedicated, allocation);
+    unique_handle memory_guard(device, allocation);
+    check_result(vkBindImageMemory(device, image, allocation.memory, allocation.offset), BIND_MEMORY_FAILED);
 
     // create image views
     unique_handle<VkImageView[]> views(device, new VkImageView[create_info.viewCount]{ VK_NULL_HANDLE }, create_info.viewCount);
     for (uint32_t i = 0; i < create_info.viewCount; i++)
     {
         const TextureViewCreateInfo texture_view = create_info.views[i];
+        const VkImageViewUsageCreateInfo view_usage_info = view_usage(create_info.imageUsage, texture_view.format);
         const VkImageSubresourceRange range = {
             .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
             .baseMipLevel = 0,
@@ -367,7 +450,7 @@ vka::unique_handle<vka::Texture::Handle> vka::Texture::create_texture(VkDevice d
         };
         const VkImageViewCreateInfo view_create_info = {
             .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-            .pNext = nullptr,
+            .pNext = &view_usage_info,
             .flags = texture_view.flags,
             .image = image,
             .viewType = texture_view.viewType,
@@ -378,11 +461,39 @@ vka::unique_handle<vka::Texture::Handle> vka::Texture::create_texture(VkDevice d
         check_result(vkCreateImageView(device, &view_create_info, nullptr, views.get() + i), VIEW_CREATE_FAILED);
     }
 
+    // create sampler, last so that a sampler of the cache does not have to be released on failure
+    const VkSamplerCreateInfo sampler_create_info = {
+        .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .magFilter = create_info.samplerMagFilter,
+        .minFilter = create_info.samplerMinFilter,
+        .mipmapMode = create_info.samplerMipmapMode,
+        .addressModeU = create_info.samplerAddressModeU,
+        .addressModeV = create_info.samplerAddressModeV,
+        .addressModeW = create_info.samplerAddressModeW,
+        .mipLodBias = create_info.samplerLodBias,
+        .anisotropyEnable = create_info.samplerAnisotropyEnable,
+        .maxAnisotropy = create_info.samplerMaxAnisotropy,
+        .compareEnable = create_info.samplerCompareEnable,
+        .compareOp = create_info.samplerCompareOp,
+        .minLod = create_info.samplerMinLod,
+        .maxLod = create_info.samplerMaxLod,
+        .borderColor = create_info.samplerBorderColor,
+        .unnormalizedCoordinates = create_info.samplerUnnormalizedCoordinates
+    };
+    VkSampler sampler;
+    if (create_info.samplerCache != nullptr)
+        sampler = create_info.samplerCache->acquire(sampler_create_info);
+    else
+        check_result(vkCreateSampler(device, &sampler_create_info, nullptr, &sampler), SAMPLER_CREATE_FAILED);
+
     const uint32_t view_count = views.count();
     const Handle handle = {
         .image = image_guard.release(),
         .memory = memory_guard.release(),
-        .sampler = sampler_guard.release(),
+        .sampler = sampler,
+        .sampler_cache = create_info.samplerCache,
         .views = views.release(),
         .view_count = view_count
     };
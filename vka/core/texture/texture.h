@@ -2,4 +2,8 @@
 
 #include "merger.inl"
 #include "loader.inl"
+#include "mipchain.inl"
+#include "compressor.inl"
+#include "converter.inl"
+#include "container.inl"
 #include "texture.inl"
\ No newline at end of file
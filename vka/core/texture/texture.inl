@@ -13,6 +13,9 @@
 
 constexpr vka::Texture::Texture() noexcept :
     m_extent{0, 0, 0},
+    m_format(VK_FORMAT_UNDEFINED),
+    m_type(VK_IMAGE_TYPE_2D),
+    m_usage(0),
     m_layer_count(0),
     m_level_count(0)
 {}
@@ -48,6 +51,21 @@ constexpr uint32_t vka::Texture::level_count() const noexcept
     return this->m_level_count;
 }
 
+constexpr VkFormat vka::Texture::format() const noexcept
+{
+    return this->m_format;
+}
+
+constexpr VkImageType vka::Texture::type() const noexcept
+{
+    return this->m_type;
+}
+
+constexpr VkImageUsageFlags vka::Texture::usage() const noexcept
+{
+    return this->m_usage;
+}
+
 inline uint32_t vka::Texture::level_count(VkExtent3D extent) noexcept
 {
     return detail::common::max_ilog2(extent) + 1;
@@ -73,6 +91,11 @@ constexpr VkSampler vka::Texture::sampler() const noexcept
     return this->m_texture.get().sampler;
 }
 
+constexpr VkDeviceSize vka::Texture::memory_size() const noexcept
+{
+    return this->m_texture.get().memory.size;
+}
+
 inline VkImageView vka::Texture::view(uint32_t idx) const
 {
     if (idx >= this->m_texture.get().view_count) [[unlikely]]
@@ -84,6 +107,9 @@ constexpr void vka::Texture::destroy() noexcept
 {
     this->m_texture = VK_NULL_HANDLE;
     this->m_extent = {};
+    this->m_format = VK_FORMAT_UNDEFINED;
+    this->m_type = VK_IMAGE_TYPE_2D;
+    this->m_usage = 0;
     this->m_level_count = this->m_layer_count = 0;
 }
 
@@ -120,7 +146,93 @@ vka::Buffer vka::Texture::load3D(VkCommandBuffer cbo, const TextureLoader<F>& lo
     return staging;
 }
 
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+[[nodiscard]]
+vka::Buffer vka::Texture::load(VkCommandBuffer cbo, const TextureMipChain<F>& mips, TextureLoadInfo info, uint32_t layer)
+{
+    return this->load_levels(cbo, mips, format_sizeof(F), info, layer);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_encoder_format<F>
+[[nodiscard]]
+vka::Buffer vka::Texture::load(VkCommandBuffer cbo, const TextureCompressor<F>& blocks, TextureLoadInfo info, uint32_t layer)
+{
+    return this->load_levels(cbo, blocks, format_sizeof(blocks.format()), info, layer);
+}
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+vka::Buffer vka::Texture::load(VkCommandBuffer cbo, const TextureConverter<F>& pixels, TextureLoadInfo info, uint32_t layer)
+{
+    return this->load_levels(cbo, pixels, format_sizeof(pixels.format()), info, layer);
+}
+
+template<typename Levels>
+vka::Buffer vka::Texture::load_levels(VkCommandBuffer cbo, const Levels& levels, VkDeviceSize texel_size, TextureLoadInfo info, uint32_t layer)
+{
+    // Buffer offsets must be a multiple of the texel size and of 4.
+    const VkDeviceSize alignment = std::lcm(texel_size, (VkDeviceSize)4);
+    const uint32_t level_count = std::min(levels.level_count(), (uint32_t)this->m_level_count);
+
+    std::vector<VkBufferImageCopy> regions(level_count);
+    VkDeviceSize size = 0;
+    for (uint32_t level = 0; level < level_count; level++)
+    {
+        regions[level] = {
+            .bufferOffset = size,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = level,
+                .baseArrayLayer = layer,
+                .layerCount = levels.layer_count()
+            },
+            .imageOffset = ZERO_OFFSET,
+            .imageExtent = levels.extent(level)
+        };
+        size += (levels.size(level) + alignment - 1) / alignment * alignment;
+    }
+
+    Buffer staging = create_staging(this->m_texture.parent(), size, info);
+    uint8_t* const mapped = (uint8_t*)staging.map();
+    for (uint32_t level = 0; level < level_count; level++)
+        memcpy(mapped + regions[level].bufferOffset, levels.data(level), levels.size(level));
+    staging.flush();
+    staging.unmap();
+
+    vkCmdCopyBufferToImage(cbo, staging.handle(), this->m_texture.get().image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, level_count, regions.data());
+    return staging;
+}
+
+constexpr uint32_t vka::Texture::upload_region_count(const TextureUploadLayout& layout) noexcept
+{
+    return layout.order == TextureUploadOrder::LEVEL_MAJOR ? layout.levelCount : layout.levelCount * layout.layerCount;
+}
+
+constexpr VkImageUsageFlags vka::Texture::image_usage(VkImageUsageFlags usage) noexcept
+{
+    return usage | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+}
+
+constexpr VkImageCreateFlags vka::Texture::image_flags(VkImageCreateFlags flags, VkFormat format, VkImageUsageFlags usage) noexcept
+{
+    if ((usage & VK_IMAGE_USAGE_STORAGE_BIT) != 0 && detail::texture::storage_format(format) != format)
+        flags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+    return flags;
+}
+
+constexpr VkImageViewUsageCreateInfo vka::Texture::view_usage(VkImageUsageFlags usage, VkFormat format) noexcept
+{
+    if (detail::texture::storage_format(format) != format)
+        usage &= ~VK_IMAGE_USAGE_STORAGE_BIT;
+    return {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO,
+        .pNext = nullptr,
+        .usage = image_usage(usage)
+    };
+}
+
 inline uint32_t vka::Texture::mip_level_count(const TextureCreateInfo& create_info) noexcept
 {
-    return create_info.generateMipMap ? level_count(create_info.imageExtent) : 1;
+    return create_info.generateMipMap ? level_count(create_info.imageExtent) : std::max(create_info.imageMipLevels, 1u);
 }
\ No newline at end of file
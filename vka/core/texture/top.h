@@ -34,10 +34,24 @@ namespace vka
      * Parameters prefixed with <c>sampler</c> correspond to the parameters of a
      * <a href="https://docs.vulkan.org/refpages/latest/refpages/source/VkSamplerCreateInfo.html">
      * VkSamplerCreateInfo</a>.
+     * - <c>imageUsage</c> -- Additional usage of the image. Transfer and sampled usage are always added. Add
+     * <c>VK_IMAGE_USAGE_STORAGE_BIT</c> to generate the mip-map with a <c>MipGenerator</c>. For sRGB formats, the image
+     * is then created with <c>VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT</c> and <c>VK_IMAGE_CREATE_EXTENDED_USAGE_BIT</c>, so
+     * that it can be written through an UNORM view.
+     * - <c>samplerCache</c> -- Cache from which the sampler is taken, so that textures with the same sampler parameters
+     * share one sampler. If it is <c>nullptr</c>, the texture creates its own sampler. The cache must have been created
+     * with the same device and must outlive the texture.
      * - <c>viewCount</c> -- Number of views created for this texture.
      * - <c>views</c> -- Create-info for the views.
      * - <c>generateMipMap</c> -- Indicates whether mip-maps should be generated.
+     * - <c>imageMipLevels</c> -- Number of mip-map levels if <c>generateMipMap</c> is <c>false</c>, for levels that are
+     * loaded manually, e.g. from a <c>TextureContainer</c>. A value of <c>0</c> is treated as <c>1</c>.
      * - <c>commandBuffer</c> -- Command buffer in which internal operations are recorded.
+     * - <c>memoryAllocator</c> -- Allocator from which the memory is suballocated. If it is <c>nullptr</c>, the texture
+     * gets its own memory. If the driver prefers a dedicated allocation or the texture exceeds the dedicated threshold
+     * of the allocator, the texture gets a dedicated allocation.
+     * - <c>memoryTracker</c> -- Tracker which accounts the memory of the texture, can be <c>nullptr</c>.
+     * - <c>memoryDebugName</c> -- Name of the texture in the registry of the tracker, can be <c>nullptr</c>.
      */
     struct TextureCreateInfo
     {
@@ -46,6 +60,7 @@ namespace vka
         VkFormat                        imageFormat;
         VkExtent3D                      imageExtent;
         uint32_t                        imageArrayLayers;
+        VkImageUsageFlags               imageUsage;
         uint32_t                        imageQueueFamilyIndexCount;
         const uint32_t*                 imageQueueFamilyIndices;
         VkFilter                        samplerMagFilter;
@@ -63,10 +78,15 @@ namespace vka
         float                           samplerMaxLod;
         VkBorderColor                   samplerBorderColor;
         uint32_t                        samplerUnnormalizedCoordinates;
+        SamplerCache*                   samplerCache;
         uint32_t                        viewCount;
         const TextureViewCreateInfo*    views;
         bool                            generateMipMap;
+        uint32_t                        imageMipLevels;
         VkCommandBuffer                 commandBuffer;
+        MemoryAllocator*                memoryAllocator;
+        MemoryTracker*                  memoryTracker;
+        const char*                     memoryDebugName;
     };
 
     /**
@@ -82,6 +102,115 @@ namespace vka
         const VkPhysicalDeviceMemoryProperties* memoryProperties;
     };
 
+    /**
+     * Specifies the order of the subresources in a staging buffer described by a <c>TextureUploadLayout</c>.
+     * - <c>LEVEL_MAJOR</c> -- All layers of a level are stored consecutively, followed by the next level, like KTX2.
+     * Every level is copied with a single region.
+     * - <c>LAYER_MAJOR</c> -- All levels of a layer are stored consecutively, followed by the next layer, like DDS.
+     * Every level of every layer is copied with its own region.
+     */
+    enum class TextureUploadOrder
+    {
+        LEVEL_MAJOR,
+        LAYER_MAJOR
+    };
+
+    /**
+     * Structure describing the layout of a staging buffer that contains multiple levels and layers of a texture,
+     * which are loaded with a single copy. The offsets and row lengths of the subresources are computed from the format
+     * and the extent of the texture, block compressed formats are stored in blocks.
+     * - <c>baseLevel</c> -- First level in the buffer.
+     * - <c>levelCount</c> -- Number of levels in the buffer.
+     * - <c>baseLayer</c> -- First array layer in the buffer.
+     * - <c>layerCount</c> -- Number of array layers in the buffer.
+     * - <c>bufferOffset</c> -- Offset of the first subresource in the buffer.
+     * - <c>order</c> -- Order of the subresources in the buffer.
+     * - <c>subresourceAlignment</c> -- Alignment of the offset of every subresource, which is combined with the
+     * texel or block size and <c>4</c>. If it is <c>0</c>, the subresources are only aligned to the texel or block size
+     * and <c>4</c>. In <c>LEVEL_MAJOR</c> order, only the levels are aligned and the layers of a level are tightly
+     * packed.
+     * - <c>rowPitchAlignment</c> -- Alignment of the rows in bytes, which is combined with the texel or block size. If it
+     * is <c>0</c>, the rows are tightly packed.
+     */
+    struct TextureUploadLayout
+    {
+        uint32_t                baseLevel;
+        uint32_t                levelCount;
+        uint32_t                baseLayer;
+        uint32_t                layerCount;
+        VkDeviceSize            bufferOffset;
+        TextureUploadOrder      order;
+        VkDeviceSize            subresourceAlignment;
+        uint32_t                rowPitchAlignment;
+    };
+
+    /// Specifies the filter with which the levels of a <c>TextureMipChain</c> are downsampled.
+    enum class MipFilter
+    {
+        /// Averages 2x2 pixels. Fast, but tends to blur and alias.
+        BOX,
+        /// Separable Kaiser-windowed sinc filter. Keeps the levels sharper with less aliasing.
+        KAISER
+    };
+
+    /**
+     * Contains information for generating a mip-map chain on the CPU.
+     * - <c>filter</c> -- Specifies the filter used for downsampling.
+     * - <c>srgb</c> -- Specifies whether the color components are sRGB encoded, so that they are averaged in linear
+     * space. The alpha component is always linear. Only affects 8-bit and 16-bit formats.
+     * - <c>normalMap</c> -- Specifies whether the texture is a normal map. The first three components are decoded from
+     * <c>[0, 1]</c> to <c>[-1, 1]</c> for integer formats and renormalized after every level. Takes precedence over
+     * <c>srgb</c>.
+     * - <c>levelCount</c> -- Number of levels including the base level. If it is <c>0</c>, the full chain is generated.
+     * - <c>threadCount</c> -- Maximum number of threads. If it is <c>0</c>, the number of hardware threads is used.
+     */
+    struct TextureMipInfo
+    {
+        MipFilter   filter;
+        bool        srgb;
+        bool        normalMap;
+        uint32_t    levelCount;
+        uint32_t    threadCount;
+    };
+
+    /// Specifies the trade-off between speed and quality of the block encoder of a <c>TextureCompressor</c>.
+    enum class BlockQuality
+    {
+        /// Takes the endpoints from the principal axis of a block.
+        FAST,
+        /// Additionally refines the endpoints with a least-squares fit and searches more endpoint candidates.
+        HIGH
+    };
+
+    /**
+     * Contains information for block compressing textures on the CPU.
+     * - <c>format</c> -- Block compressed format of the result. Supported are <c>VK_FORMAT_BC1_RGB_*</c>,
+     * <c>VK_FORMAT_BC1_RGBA_*</c>, <c>VK_FORMAT_BC3_*</c>, <c>VK_FORMAT_BC4_UNORM_BLOCK</c>,
+     * <c>VK_FORMAT_BC5_UNORM_BLOCK</c> and <c>VK_FORMAT_BC7_*</c>. sRGB formats only change the format of the result.
+     * - <c>quality</c> -- Specifies the quality of the encoder.
+     * - <c>threadCount</c> -- Maximum number of threads. If it is <c>0</c>, the number of hardware threads is used.
+     */
+    struct TextureCompressInfo
+    {
+        VkFormat        format;
+        BlockQuality    quality;
+        uint32_t        threadCount;
+    };
+
+    /**
+     * Contains information for converting textures into another format on the CPU.
+     * - <c>format</c> -- Format of the result. Supported are <c>VK_FORMAT_R8*_UNORM</c>, <c>VK_FORMAT_R8*_SRGB</c>,
+     * <c>VK_FORMAT_R16*_UNORM</c> and <c>VK_FORMAT_R16*_SFLOAT</c> with the same number of components as the source,
+     * and <c>VK_FORMAT_B10G11R11_UFLOAT_PACK32</c> and <c>VK_FORMAT_E5B9G9R9_UFLOAT_PACK32</c> for sources with at
+     * least 3 components.
+     * - <c>threadCount</c> -- Maximum number of threads. If it is <c>0</c>, the number of hardware threads is used.
+     */
+    struct TextureConvertInfo
+    {
+        VkFormat        format;
+        uint32_t        threadCount;
+    };
+
     /**
      * Helper class to load and merge 2D images from a file or 3D images from memory into a single image. Every time
      * <c>load()</c> is called, the components of the current image are appended to the already existing components of
@@ -220,6 +349,19 @@ namespace vka
          */
         void load(const char* path);
 
+        /**
+         * Loads images from files concurrently. The files are decoded on a pool of worker threads and their components
+         * are appended in the order of the paths. If any file fails to load, no file is merged, so that the components
+         * never end up in the wrong channels.
+         * @param paths Paths to the image files.
+         * @param thread_count Optionally specifies the maximum number of threads. If it is <c>0</c>, the number of
+         * hardware threads is used.
+         * @return Returns an exception pointer per file, which is <c>nullptr</c> if the file was loaded. Otherwise, it
+         * holds the exception which <c>load(const char*)</c> would have thrown for the file.
+         * @throw std::bad_alloc Is thrown, if allocating memory failed.
+         */
+        std::vector<std::exception_ptr> load_many(std::span<const char* const> paths, uint32_t thread_count = 0);
+
         // Deleted:
         TextureMerger(const TextureMerger&) = delete;
         TextureMerger& operator= (const TextureMerger&) = delete;
@@ -363,6 +505,18 @@ namespace vka
          */
         explicit TextureLoader(const char* path, uint32_t estimated_layers = 1);
 
+        /**
+         * Initializes the loader on external storage, e.g. a persistently mapped staging buffer. Images are converted
+         * directly into the storage, so that the loader does not allocate any image memory itself. The storage is not
+         * owned by the loader and must outlive it. Use <c>file_extent()</c> to query the extent of an image file before
+         * the storage is created. If the storage is not host-coherent, it must be flushed after loading.
+         * @param storage Storage of the images. Must at least contain
+         * <c>extent.width * extent.height * layer_capacity * format_countof(F)</c> elements.
+         * @param extent Extent of the images. This extent is used as the extent for the generated texture.
+         * @param layer_capacity Maximum number of layers that fit into the storage.
+         */
+        explicit TextureLoader(component_t* storage, VkExtent2D extent, uint32_t layer_capacity) noexcept;
+
         /**
          * Moves a texture loader. The source texture loader becomes invalidated and using to results in undefined
          * behaviour.
@@ -400,47 +554,95 @@ namespace vka
          */
         inline uint32_t layer_count() const noexcept;
 
+        /// @return Returns whether the loader writes into external storage.
+        inline bool external() const noexcept;
+
+        /**
+         * Queries the extent of an image file without decoding it.
+         * @param path Path to the image file.
+         * @return Returns the extent of the image.
+         * @throw std::invalid_argument Is thrown if the file could not be found.
+         */
+        static inline VkExtent2D file_extent(const char* path);
+
         /**
          * Loads a 2D-image from memory. The extent is defined by one of the constructors.
          * @param data Data of the image to load. Must at least contain\n
          * <c>extent.width * extent.height * format_countof(format)</c> elements or\n
          * <c>extent.width * extent.height * format_sizeof(format)</c> bytes.
          * @param format Format of the image expressed in a vulkan <c>VkFormat</c>.
+         * @throw std::out_of_range Is thrown if the external storage is full.
          */
-        void load(const component_t* data, VkFormat format) noexcept;
+        void load(const component_t* data, VkFormat format);
 
         /**
          * Loads a single color into the 2D-image. The extent is defined by one of the constructors.
          * @param color Must at least contain <c>comp</c> elements.
          * @param comp Number of components the color has.
+         * @throw std::out_of_range Is thrown if the external storage is full.
          */
-        void load(const component_t* color, uint32_t comp) noexcept;
+        void load(const component_t* color, uint32_t comp);
 
         /**
          * Loads a 2D-image from a file. The extent is defined by one of the constructors.
          * @param path Path to the image file.
          * @throw std::invalid_argument Is thrown if the file could not be found.
          * @throw std::runtime_error Is thrown if the extent of the image does not match the extent of the texture.
+         * @throw std::out_of_range Is thrown if the external storage is full.
          */
         void load(const char* path);
 
+        /**
+         * Loads 2D-images from files concurrently. A layer is reserved for every file, so that the layer indices
+         * correspond to the order of the paths. The files are decoded on a pool of worker threads, which write directly
+         * into their layers. The layer of a file that fails to load is filled with <c>zeros</c>.
+         * @param paths Paths to the image files.
+         * @param thread_count Optionally specifies the maximum number of threads. If it is <c>0</c>, the number of
+         * hardware threads is used.
+         * @return Returns an exception pointer per file, which is <c>nullptr</c> if the file was loaded. Otherwise, it
+         * holds the exception which <c>load(const char*)</c> would have thrown for the file.
+         * @throw std::bad_alloc Is thrown, if allocating memory failed.
+         * @throw std::out_of_range Is thrown if the external storage cannot hold all files.
+         */
+        std::vector<std::exception_ptr> load_many(std::span<const char* const> paths, uint32_t thread_count = 0);
+
         // Deleted:
         TextureLoader(const TextureLoader&) = delete;
         TextureLoader& operator= (const TextureLoader&) = delete;
 
     private:
         static constexpr const char* MSG_EXTENT_MISSMATCH = "[vka::TextureLoader]: Extent of loaded image does not match the extent of the texture.";
+        static constexpr const char* MSG_STORAGE_FULL = "[vka::TextureLoader]: External storage is full.";
 
         component_t* m_data;
         VkExtent3D m_extent;
         uint32_t m_alloc_layers;
+        uint32_t m_reserved_layers;
+        bool m_external;
 
         /// Initialization constructor.
         explicit TextureLoader(VkExtent3D extent) noexcept;
 
+        /**
+         * Reserves address space for the layers of the image buffer and commits the first layers. The layers are
+         * never moved while they fit into the reservation, so adding a layer neither copies nor zero-fills the
+         * existing ones. If the address space for additional layers cannot be reserved, only the layers themselves
+         * are reserved.
+         */
+        void allocate(VkExtent2D extent, uint32_t layers);
+
         /// Grows the image buffer.
         void grow();
 
+        /// Commits more layers of the image buffer, if it has fewer layers than specified.
+        void reserve(uint32_t layers);
+
+        /**
+         * Zeros a layer of external storage whose image has fewer components than the format, because external
+         * storage is not value-initialized.
+         */
+        inline void clear_layer(component_t* layer, uint32_t img_comp) const noexcept;
+
         /// Copies the 2D-image data to the buffer.
         inline void copy_image2D(const component_t* data, uint32_t img_comp) noexcept;
 
@@ -459,10 +661,535 @@ namespace vka
         /// Calculates the initial number of layers to allocate.
         static inline uint32_t alloc_layers(uint32_t estimated_layers) noexcept;
 
+        /// Calculates the number of layers for which address space is reserved.
+        static inline uint32_t reserved_layers(VkExtent2D extent, uint32_t layers) noexcept;
+
         /// Calculates the growth factor of the image buffer measured in layers.
         static inline uint32_t grow_factor(uint32_t layer_count) noexcept;
     };
 
+    /**
+     * Generates the mip-map levels of an array of 2D-images on the CPU. In contrast to the blit performed by
+     * <c>Texture::finish()</c>, the levels can be filtered with a higher quality filter, averaged in linear space and
+     * renormalized for normal maps. Every level is computed from the previous one, the rows of all layers are filtered
+     * on a pool of worker threads. The result is uploaded with <c>Texture::load()</c> and the texture is finished with
+     * <c>Texture::finish_manual()</c>.
+     *
+     * <b>Default initialization:</b>\n
+     * No default initialization.
+     *
+     * <b>Initialization:</b>\n
+     * See constructor description.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class can be created and used from any thread. However, if you use this class across multiple threads,
+     * actions must be externally synchronized.
+     *
+     * @tparam F Specifies the format of the images. Must be the format of the source images.
+     */
+    template<VkFormat F> requires detail::texture::is_loader_format<F>
+    class TextureMipChain final
+    {
+        using component_t = detail::texture::loader_format_t<F>;
+
+    public:
+        /**
+         * Generates the mip-map levels of images in memory. The base level is not copied.
+         * @param data Data of the base level. Must at least contain
+         * <c>extent.width * extent.height * layer_count * format_countof(F)</c> elements and must outlive the chain.
+         * @param extent Extent of the base level.
+         * @param layer_count Number of array layers.
+         * @param info Specifies how the levels are generated.
+         * @throw std::bad_alloc Is thrown, if allocating memory failed.
+         */
+        explicit TextureMipChain(const component_t* data, VkExtent2D extent, uint32_t layer_count, const TextureMipInfo& info);
+
+        /**
+         * Generates the mip-map levels of the images of a loader. The loader must outlive the chain and must not load
+         * further images.
+         * @param loader <c>TextureLoader</c> whose images are the base level.
+         * @param info Specifies how the levels are generated.
+         * @throw std::bad_alloc Is thrown, if allocating memory failed.
+         */
+        explicit TextureMipChain(const TextureLoader<F>& loader, const TextureMipInfo& info);
+
+        /// @return Returns the number of levels including the base level.
+        inline uint32_t level_count() const noexcept;
+
+        /// @return Returns the number of array layers.
+        inline uint32_t layer_count() const noexcept;
+
+        /**
+         * No range check is performed.
+         * @return Returns the extent of a level. The third component <c>extent.depth</c> is <c>1</c>.
+         */
+        inline VkExtent3D extent(uint32_t level) const noexcept;
+
+        /**
+         * No range check is performed.
+         * @return Returns the data of a level, the layers are tightly packed one after the other.
+         */
+        inline const component_t* data(uint32_t level) const noexcept;
+
+        /**
+         * No range check is performed.
+         * @return Returns the size of a level in bytes including all layers.
+         */
+        inline VkDeviceSize size(uint32_t level) const noexcept;
+
+        // Default:
+        TextureMipChain(TextureMipChain&&) = default;
+        ~TextureMipChain() = default;
+        TextureMipChain& operator= (TextureMipChain&&) = default;
+
+        // Deleted:
+        TextureMipChain(const TextureMipChain&) = delete;
+        TextureMipChain& operator= (const TextureMipChain&) = delete;
+
+    private:
+        const component_t* m_source;
+        VkExtent2D m_extent;
+        uint32_t m_layer_count;
+        std::vector<std::unique_ptr<component_t[]>> m_levels;
+
+        /// Generates the levels following the base level.
+        void generate(const TextureMipInfo& info);
+
+        /// Calls <c>func(layer, row_begin, row_end)</c> for bands of <c>rows</c> rows of every layer in parallel.
+        template<typename Func>
+        void for_each_band(uint32_t rows, uint32_t thread_count, const Func& func) const;
+    };
+
+    /**
+     * Block compresses 8-bit images on the CPU, so that images which only exist as PNG or JPEG get the memory savings
+     * of BCn without an offline asset pipeline. The rows of 4x4 blocks of all layers are encoded on a pool of worker
+     * threads. BC7 is encoded with mode 6 only, which has a single subset. The result is uploaded with
+     * <c>Texture::load()</c> and the texture is finished with <c>Texture::finish_manual()</c>, because compressed
+     * textures cannot be blitted.
+     *
+     * <b>Default initialization:</b>\n
+     * No default initialization.
+     *
+     * <b>Initialization:</b>\n
+     * See constructor description.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class can be created and used from any thread. However, if you use this class across multiple threads,
+     * actions must be externally synchronized.
+     *
+     * @tparam F Specifies the format of the source images, which must be an 8-bit format.
+     */
+    template<VkFormat F> requires detail::texture::is_encoder_format<F>
+    class TextureCompressor final
+    {
+    public:
+        /**
+         * Compresses images in memory.
+         * @param data Data of the images. Must at least contain
+         * <c>extent.width * extent.height * layer_count * format_countof(F)</c> elements.
+         * @param extent Extent of the images.
+         * @param layer_count Number of array layers.
+         * @param info Specifies how the images are compressed.
+         * @throw std::invalid_argument Is thrown if the format of the info is not supported.
+         * @throw std::bad_alloc Is thrown, if allocating memory failed.
+         */
+        explicit TextureCompressor(const uint8_t* data, VkExtent2D extent, uint32_t layer_count, const TextureCompressInfo& info);
+
+        /**
+         * Compresses the images of a loader.
+         * @param loader <c>TextureLoader</c> whose images are compressed.
+         * @param info Specifies how the images are compressed.
+         * @throw std::invalid_argument Is thrown if the format of the info is not supported.
+         * @throw std::bad_alloc Is thrown, if allocating memory failed.
+         */
+        explicit TextureCompressor(const TextureLoader<F>& loader, const TextureCompressInfo& info);
+
+        /**
+         * Compresses every level of a mip-map chain.
+         * @param mips <c>TextureMipChain</c> whose levels are compressed.
+         * @param info Specifies how the images are compressed.
+         * @throw std::invalid_argument Is thrown if the format of the info is not supported.
+         * @throw std::bad_alloc Is thrown, if allocating memory failed.
+         */
+        explicit TextureCompressor(const TextureMipChain<F>& mips, const TextureCompressInfo& info);
+
+        /// @return Returns the block compressed format of the result.
+        inline VkFormat format() const noexcept;
+
+        /// @return Returns the number of levels.
+        inline uint32_t level_count() const noexcept;
+
+        /// @return Returns the number of array layers.
+        inline uint32_t layer_count() const noexcept;
+
+        /**
+         * No range check is performed.
+         * @return Returns the extent of a level in pixels. The third component <c>extent.depth</c> is <c>1</c>.
+         */
+        inline VkExtent3D extent(uint32_t level) const noexcept;
+
+        /**
+         * No range check is performed.
+         * @return Returns the blocks of a level, the layers are tightly packed one after the other.
+         */
+        inline const uint8_t* data(uint32_t level) const noexcept;
+
+        /**
+         * No range check is performed.
+         * @return Returns the size of a level in bytes including all layers.
+         */
+        inline VkDeviceSize size(uint32_t level) const noexcept;
+
+        // Default:
+        TextureCompressor(TextureCompressor&&) = default;
+        ~TextureCompressor() = default;
+        TextureCompressor& operator= (TextureCompressor&&) = default;
+
+        // Deleted:
+        TextureCompressor(const TextureCompressor&) = delete;
+        TextureCompressor& operator= (const TextureCompressor&) = delete;
+
+    private:
+        static constexpr const char* MSG_UNSUPPORTED = "[vka::TextureCompressor]: Format is not supported by the block encoder.";
+
+        VkFormat m_format;
+        VkExtent2D m_extent;
+        uint32_t m_layer_count;
+        std::vector<std::unique_ptr<uint8_t[]>> m_levels;
+
+        /// Initialization constructor.
+        explicit TextureCompressor(VkExtent2D extent, uint32_t layer_count, const TextureCompressInfo& info);
+
+        /// Compresses a level and appends it.
+        void compress(const uint8_t* data, const TextureCompressInfo& info);
+    };
+
+    /**
+     * Converts images of a loader format into a more compact format on the CPU, e.g. float HDR images into half floats
+     * or packed HDR formats, which need 2 to 4 times less memory without any extra work in the shader. Integer sources
+     * are normalized and float sources are linear, which are encoded as sRGB for sRGB formats. Negative values are
+     * clamped to 0 for unsigned formats, values exceeding the range of a format are clamped to its largest value.
+     * Conversions between 8-bit and 16-bit components and to half floats are vectorized. The result is uploaded with
+     * <c>Texture::load()</c> into a texture that was created with the format of the converter.
+     *
+     * <b>Default initialization:</b>\n
+     * No default initialization.
+     *
+     * <b>Initialization:</b>\n
+     * See constructor description.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class can be created and used from any thread. However, if you use this class across multiple threads,
+     * actions must be externally synchronized.
+     *
+     * @tparam F Specifies the format of the source images.
+     */
+    template<VkFormat F> requires detail::texture::is_loader_format<F>
+    class TextureConverter final
+    {
+    public:
+        using component_t = detail::texture::loader_format_t<F>;
+
+        /**
+         * Converts images in memory.
+         * @param data Data of the images. Must at least contain
+         * <c>extent.width * extent.height * layer_count * format_countof(F)</c> elements.
+         * @param extent Extent of the images.
+         * @param layer_count Number of array layers.
+         * @param info Specifies how the images are converted.
+         * @throw std::invalid_argument Is thrown if the format of the info is not supported.
+         * @throw std::bad_alloc Is thrown, if allocating memory failed.
+         */
+        explicit TextureConverter(const component_t* data, VkExtent2D extent, uint32_t layer_count, const TextureConvertInfo& info);
+
+        /**
+         * Converts the images of a loader.
+         * @param loader <c>TextureLoader</c> whose images are converted.
+         * @param info Specifies how the images are converted.
+         * @throw std::invalid_argument Is thrown if the format of the info is not supported.
+         * @throw std::bad_alloc Is thrown, if allocating memory failed.
+         */
+        explicit TextureConverter(const TextureLoader<F>& loader, const TextureConvertInfo& info);
+
+        /**
+         * Converts the image of a merger. 3D-images keep their depth.
+         * @param merger <c>TextureMerger</c> whose image is converted.
+         * @param info Specifies how the image is converted.
+         * @throw std::invalid_argument Is thrown if the format of the info is not supported.
+         * @throw std::bad_alloc Is thrown, if allocating memory failed.
+         */
+        explicit TextureConverter(const TextureMerger<F>& merger, const TextureConvertInfo& info);
+
+        /**
+         * Converts every level of a mip-map chain.
+         * @param mips <c>TextureMipChain</c> whose levels are converted.
+         * @param info Specifies how the images are converted.
+         * @throw std::invalid_argument Is thrown if the format of the info is not supported.
+         * @throw std::bad_alloc Is thrown, if allocating memory failed.
+         */
+        explicit TextureConverter(const TextureMipChain<F>& mips, const TextureConvertInfo& info);
+
+        /// @return Returns the format of the result.
+        inline VkFormat format() const noexcept;
+
+        /// @return Returns the number of levels.
+        inline uint32_t level_count() const noexcept;
+
+        /// @return Returns the number of array layers.
+        inline uint32_t layer_count() const noexcept;
+
+        /**
+         * No range check is performed.
+         * @return Returns the extent of a level in pixels.
+         */
+        inline VkExtent3D extent(uint32_t level) const noexcept;
+
+        /**
+         * No range check is performed.
+         * @return Returns the pixels of a level, the layers are tightly packed one after the other.
+         */
+        inline const uint8_t* data(uint32_t level) const noexcept;
+
+        /**
+         * No range check is performed.
+         * @return Returns the size of a level in bytes including all layers.
+         */
+        inline VkDeviceSize size(uint32_t level) const noexcept;
+
+        // Default:
+        TextureConverter(TextureConverter&&) = default;
+        ~TextureConverter() = default;
+        TextureConverter& operator= (TextureConverter&&) = default;
+
+        // Deleted:
+        TextureConverter(const TextureConverter&) = delete;
+        TextureConverter& operator= (const TextureConverter&) = delete;
+
+    private:
+        static constexpr const char* MSG_UNSUPPORTED = "[vka::TextureConverter]: Format is not supported by the converter.";
+
+        /// Number of pixels that are converted by a single task.
+        static constexpr uint64_t TASK_PIXELS = 1 << 16;
+
+        VkFormat m_format;
+        VkExtent3D m_extent;
+        uint32_t m_layer_count;
+        std::vector<std::unique_ptr<uint8_t[]>> m_levels;
+
+        /// Initialization constructor.
+        explicit TextureConverter(VkExtent3D extent, uint32_t layer_count, const TextureConvertInfo& info);
+
+        /// Converts a level and appends it.
+        void convert(const component_t* data, uint32_t thread_count);
+    };
+
+    /**
+     * Loads a texture from a KTX2 or DDS container file. In contrast to <c>TextureLoader</c>, the payload is not
+     * decoded. Block compressed (BCn, ETC2, ASTC) and uncompressed payloads are uploaded as they are, including all
+     * mip-map levels, array layers and cube faces stored in the file. The file is memory mapped, so that the payload is
+     * only read once while being copied into the staging buffer. Create the texture with the <c>format()</c>,
+     * <c>extent()</c>, <c>layer_count()</c> and <c>level_count()</c> of the container and <c>generateMipMap</c> set to
+     * <c>false</c>, upload it with <c>Texture::load()</c> and finish it with <c>Texture::finish_manual()</c>.
+     *
+     * <b>Default initialization:</b>\n
+     * No default initialization.
+     *
+     * <b>Initialization:</b>\n
+     * See constructor description.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class can be created and used from any thread. However, if you use this class across multiple threads,
+     * actions must be externally synchronized.
+     *
+     * <b>Containers:</b>
+     * - <b>KTX2</b> -- Any <c>VkFormat</c> without supercompression. Basis Universal payloads are not supported.
+     * - <b>DDS</b> -- Legacy <c>DXT1</c>-<c>DXT5</c>, <c>ATI1</c>, <c>ATI2</c>, <c>BC4</c>, <c>BC5</c> and 32-bit RGBA
+     * headers, and <c>DX10</c> headers with BCn or the common uncompressed DXGI formats.
+     */
+    class TextureContainer final
+    {
+    public:
+        /// Default limit of the number of array layers, which is <c>maxImageArrayLayers</c> of common devices.
+        static constexpr uint32_t MAX_LAYER_COUNT = 2048;
+
+        /**
+         * Maps a container file and parses its header. The header is validated against the size of the file, so that
+         * the payload of every level and layer is contained in the file.
+         * @param path Path to the KTX2 or DDS file.
+         * @param max_layer_count Maximum number of array layers, which should be
+         * <c>VkPhysicalDeviceLimits::maxImageArrayLayers</c> of the device.
+         * @throw std::invalid_argument Is thrown if the file could not be opened.
+         * @throw std::runtime_error Is thrown if the file is not a valid container, if its format is not supported, if
+         * it has more layers than allowed or if it is supercompressed.
+         */
+        explicit TextureContainer(const char* path, uint32_t max_layer_count = MAX_LAYER_COUNT);
+
+        /**
+         * Moves a texture container. The source texture container becomes invalidated and using to results in
+         * undefined behaviour.
+         */
+        TextureContainer(TextureContainer&& src) noexcept;
+
+        /// Unmaps the file.
+        ~TextureContainer();
+
+        /**
+         * Moves a texture container. The source texture container becomes invalidated and using to results in
+         * undefined behaviour. The current file is unmapped.
+         */
+        TextureContainer& operator= (TextureContainer&& src) noexcept;
+
+        /// @return Returns the format of the payload.
+        inline VkFormat format() const noexcept;
+
+        /// @return Returns the extent of the base level.
+        inline VkExtent3D extent() const noexcept;
+
+        /// @return Returns the number of array layers. For cube maps, every face is a layer.
+        inline uint32_t layer_count() const noexcept;
+
+        /// @return Returns the number of mip-map levels stored in the file.
+        inline uint32_t level_count() const noexcept;
+
+        /**
+         * @return Returns whether the texture is a cube map or cube map array. The texture must be created with
+         * <c>VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT</c> to be viewed as a cube.
+         */
+        inline bool cube() const noexcept;
+
+        /**
+         * The subresources of the payload are aligned for copies, which may add padding.
+         * @return Returns the size of the payload in bytes.
+         */
+        inline VkDeviceSize size() const noexcept;
+
+        /**
+         * Copies the payload of all levels and layers with the layout described by <c>regions()</c>.
+         * @param dst Destination of the payload, which must have at least <c>size()</c> bytes.
+         */
+        void copy(void* dst) const noexcept;
+
+        /**
+         * Creates the copy regions for the payload. The buffer offsets are relative to the destination of
+         * <c>copy()</c>.
+         * @param layer Target array layer of the first layer in the file.
+         * @param level_count Maximum number of levels, levels exceeding it are skipped.
+         * @return Returns the copy regions.
+         */
+        std::vector<VkBufferImageCopy> regions(uint32_t layer, uint32_t level_count) const;
+
+        /**
+         * Block compressed formats are stored in blocks of multiple pixels.
+         * @return Returns the extent of a block, which is <c>{1, 1}</c> for uncompressed formats.
+         */
+        static VkExtent2D block_extent(VkFormat format) noexcept;
+
+        // Deleted:
+        TextureContainer(const TextureContainer&) = delete;
+        TextureContainer& operator= (const TextureContainer&) = delete;
+
+    private:
+        static constexpr const char* MSG_OPEN_FAILED = "[vka::TextureContainer]: Failed to open or map the file.";
+        static constexpr const char* MSG_INVALID = "[vka::TextureContainer]: File is not a valid KTX2 or DDS container.";
+        static constexpr const char* MSG_UNSUPPORTED = "[vka::TextureContainer]: Format of the container is not supported.";
+        static constexpr const char* MSG_SUPERCOMPRESSED = "[vka::TextureContainer]: Supercompressed KTX2 files are not supported.";
+
+        /// Level of the payload, for all layers or for a single layer.
+        struct Subresource
+        {
+            VkDeviceSize offset;    // offset in the copied payload
+            VkDeviceSize source;    // offset in the payload of the file
+            VkDeviceSize size;
+            uint32_t level;
+            uint32_t layer;
+            uint32_t layer_count;
+        };
+
+        const uint8_t* m_file;
+        size_t m_file_size;
+        VkDeviceSize m_payload_offset;
+        VkDeviceSize m_payload_size;
+        VkFormat m_format;
+        VkExtent3D m_extent;
+        uint32_t m_layer_count;
+        uint32_t m_level_count;
+        bool m_cube;
+        bool m_contiguous;
+        std::vector<Subresource> m_subresources;
+
+        /// Parses a KTX2 file.
+        void parse_ktx2(uint32_t max_layer_count);
+
+        /// Parses a DDS file.
+        void parse_dds(uint32_t max_layer_count);
+
+        /**
+         * @return Returns the size of some layers of a level.
+         * @throw std::runtime_error Is thrown if the size overflows.
+         */
+        VkDeviceSize level_size(uint32_t level, uint32_t layer_count) const;
+
+        /// Computes the offsets of the subresources in the copied payload.
+        void pack();
+
+        /// Reads a value at an offset of the file, the range must have been checked.
+        template<typename T>
+        inline T read(size_t offset) const noexcept;
+
+        /// Unmaps the file.
+        void unmap() noexcept;
+
+        /// Maps a legacy DDS pixel format to a vulkan format.
+        static VkFormat dds_format(uint32_t flags, uint32_t fourcc, uint32_t bit_count, const uint32_t* masks) noexcept;
+
+        /// Maps a DXGI format to a vulkan format.
+        static VkFormat dxgi_format(uint32_t dxgi) noexcept;
+    };
+
     /**
      * Abstraction to simplify the creation of texture images and their mip-map levels. Contains the vulkan
      * <c>VkImage</c>, the corresponding <c>VkSampler</c> and the associated <c>VkImageView</c> handles.
@@ -538,6 +1265,15 @@ namespace vka
         /// @return Returns the number of mip-map levels.
         constexpr uint32_t level_count() const noexcept;
 
+        /// @return Returns the format of the image.
+        constexpr VkFormat format() const noexcept;
+
+        /// @return Returns the type of the image.
+        constexpr VkImageType type() const noexcept;
+
+        /// @return Returns the usage of the image including the usage that is always added.
+        constexpr VkImageUsageFlags usage() const noexcept;
+
         /// @return Returns the number of mip-map levels that can be generated.
         static inline uint32_t level_count(VkExtent3D extent) noexcept;
 
@@ -550,9 +1286,12 @@ namespace vka
         /// @return Returns the vulkan <c>VkImage</c> handle.
         constexpr VkImage image() const noexcept;
 
-        /// @return Returns the vulkan <c>VkSampler</c> handle.
+        /// @return Returns the vulkan <c>VkSampler</c> handle, which is shared, if it was taken from a <c>SamplerCache</c>.
         constexpr VkSampler sampler() const noexcept;
 
+        /// @return Returns the size of the device memory of the texture in bytes.
+        constexpr VkDeviceSize memory_size() const noexcept;
+
         /**
          * Performs a range check on the index.
          * @return Returns the vulkan <c>VkImageView</c> handle at the specified index.
@@ -574,6 +1313,44 @@ namespace vka
          */
         void load(VkCommandBuffer cbo, const Buffer& data, uint32_t layer, uint32_t count = 1, uint32_t level = 0) noexcept;
 
+        /**
+         * Loads multiple levels and layers of a staging buffer into the texture with a single copy. The data of the
+         * subresources must be stored at the offsets returned by <c>upload_regions()</c>.
+         * @param cbo Command buffer in which the load command is recorded.
+         * @param data Buffer which holds the texture data.
+         * @param layout Layout of the data in the buffer. The levels and layers must exist in the texture.
+         * @throw std::bad_alloc Is thrown, if the regions could not be allocated.
+         */
+        void load(VkCommandBuffer cbo, const Buffer& data, const TextureUploadLayout& layout);
+
+        /**
+         * Stages multiple levels and layers into one buffer and loads them into the texture with a single copy.
+         * @param cbo Command buffer in which the load command is recorded.
+         * @param data Texture data, which is stored at the offsets returned by <c>upload_regions()</c>. Its size is
+         * returned by <c>upload_size()</c>.
+         * @param layout Layout of the data. The levels and layers must exist in the texture.
+         * @param info Provides information for the staging buffer.
+         * @return Returns the staging buffer.
+         * @throw std::runtime_error Is thrown, if creating the staging buffer failed.
+         */
+        [[nodiscard]]
+        Buffer load(VkCommandBuffer cbo, const void* data, const TextureUploadLayout& layout, TextureLoadInfo info);
+
+        /**
+         * @param layout Layout of the data in the buffer.
+         * @return Returns the size of a buffer with the specified layout including <c>bufferOffset</c>.
+         */
+        VkDeviceSize upload_size(const TextureUploadLayout& layout) const noexcept;
+
+        /**
+         * Computes the copy regions of a buffer with the specified layout. The buffer offset of a region is the offset
+         * of its first layer, the following layers of a region are tightly packed. If <c>bufferRowLength</c> is not
+         * <c>0</c>, it is the row pitch in texels, otherwise the rows are tightly packed.
+         * @param layout Layout of the data in the buffer.
+         * @return Returns the copy regions in the order of the subresources in the buffer.
+         */
+        std::vector<VkBufferImageCopy> upload_regions(const TextureUploadLayout& layout) const;
+
         /**
          * Loads the data of a <c>TextureMerger</c> object into the texture.
          * @param cbo Command buffer in which the load command is recorded.
@@ -614,9 +1391,68 @@ namespace vka
         [[nodiscard]]
         Buffer load3D(VkCommandBuffer cbo, const TextureLoader<F>& loader, TextureLoadInfo info, uint32_t level = 0);
 
+        /**
+         * Loads all levels of a <c>TextureMipChain</c> object into the texture with a single copy command. Levels
+         * exceeding the texture's level count are not loaded. Finish the texture with <c>finish_manual()</c>, because
+         * <c>finish()</c> would overwrite the levels.
+         * @param cbo Command buffer in which the load command is recorded.
+         * @param mips <c>TextureMipChain</c> whose levels should be uploaded.
+         * @param info Provides information for the staging buffer.
+         * @param layer Target array layer. Range of affected layers:\n
+         * <c>[layer, layer + mips.layer_count() - 1]</c>
+         * @return Returns the staging buffer.
+         */
+        template<VkFormat F> requires detail::texture::is_loader_format<F>
+        [[nodiscard]]
+        Buffer load(VkCommandBuffer cbo, const TextureMipChain<F>& mips, TextureLoadInfo info, uint32_t layer);
+
+        /**
+         * Loads all levels of a <c>TextureCompressor</c> object into the texture with a single copy command. The texture
+         * must have been created with the format of the compressor. Levels exceeding the texture's level count are not
+         * loaded. Finish the texture with <c>finish_manual()</c>.
+         * @param cbo Command buffer in which the load command is recorded.
+         * @param blocks <c>TextureCompressor</c> whose blocks should be uploaded.
+         * @param info Provides information for the staging buffer.
+         * @param layer Target array layer. Range of affected layers:\n
+         * <c>[layer, layer + blocks.layer_count() - 1]</c>
+         * @return Returns the staging buffer.
+         */
+        template<VkFormat F> requires detail::texture::is_encoder_format<F>
+        [[nodiscard]]
+        Buffer load(VkCommandBuffer cbo, const TextureCompressor<F>& blocks, TextureLoadInfo info, uint32_t layer);
+
+        /**
+         * Loads all levels of a <c>TextureConverter</c> object into the texture with a single copy command. The texture
+         * must have been created with the format of the converter. Levels exceeding the texture's level count are not
+         * loaded. If the converter has more than one level, finish the texture with <c>finish_manual()</c>.
+         * @param cbo Command buffer in which the load command is recorded.
+         * @param pixels <c>TextureConverter</c> whose pixels should be uploaded.
+         * @param info Provides information for the staging buffer.
+         * @param layer Target array layer. Range of affected layers:\n
+         * <c>[layer, layer + pixels.layer_count() - 1]</c>
+         * @return Returns the staging buffer.
+         */
+        template<VkFormat F> requires detail::texture::is_loader_format<F>
+        [[nodiscard]]
+        Buffer load(VkCommandBuffer cbo, const TextureConverter<F>& pixels, TextureLoadInfo info, uint32_t layer);
+
+        /**
+         * Loads all levels and layers of a <c>TextureContainer</c> object into the texture with a single copy command.
+         * Levels exceeding the texture's level count are not loaded. Finish the texture with <c>finish_manual()</c>.
+         * @param cbo Command buffer in which the load command is recorded.
+         * @param container <c>TextureContainer</c> whose payload should be uploaded.
+         * @param info Provides information for the staging buffer.
+         * @param layer Target array layer. Range of affected layers:\n
+         * <c>[layer, layer + container.layer_count() - 1]</c>
+         * @return Returns the staging buffer.
+         */
+        [[nodiscard]]
+        Buffer load(VkCommandBuffer cbo, const TextureContainer& container, TextureLoadInfo info, uint32_t layer);
+
         /**
          * Finishes the texture creation and creates the mip-map (if mip-map creation is activated). This operation must
-         * be executed after loading the texture data.
+         * be executed after loading the texture data. The levels are blitted one after another, use
+         * <c>MipGenerator::generate()</c> to create them with a compute shader instead.
          * @param cbo Command buffer in which the finishing commands are recorded.
          * @param stages Pipeline stages in which the texture is used.
          */
@@ -640,6 +1476,8 @@ namespace vka
         Texture& operator= (const Texture&) = delete;
 
     private:
+        friend class MemoryDefragmenter;
+
         static constexpr const char* IMAGE_CREATE_FAILED = "[vka::Texture]: Failed to create image handle.";
         static constexpr const char* ALLOC_MEMORY_FAILED = "[vka::Texture]: Failed to allocate memory.";
         static constexpr const char* BIND_MEMORY_FAILED = "[vka::Texture]: Failed to bind memory to image.";
@@ -650,9 +1488,25 @@ namespace vka
 
         unique_handle<Handle> m_texture;
         VkExtent3D m_extent;
+        VkFormat m_format;
+        VkImageType m_type;
+        VkImageUsageFlags m_usage;
         uint16_t m_layer_count;
         uint16_t m_level_count;
 
+        /// @return Returns the usage of the image, which adds transfer and sampled usage.
+        static constexpr VkImageUsageFlags image_usage(VkImageUsageFlags usage) noexcept;
+
+        /// @return Returns the flags of the image, which allow storage views of sRGB formats.
+        static constexpr VkImageCreateFlags image_flags(VkImageCreateFlags flags, VkFormat format, VkImageUsageFlags usage) noexcept;
+
+        /**
+         * Views of images with storage usage cannot inherit the storage usage, if their format does not support it,
+         * i.e. sRGB views. Other views keep the full usage of the image.
+         * @return Returns the usage of a view of the format, which is chained to its create-info.
+         */
+        static constexpr VkImageViewUsageCreateInfo view_usage(VkImageUsageFlags usage, VkFormat format) noexcept;
+
         /// Calculates the number of mip-map levels.
         static inline uint32_t mip_level_count(const TextureCreateInfo& create_info) noexcept;
 
@@ -668,6 +1522,26 @@ namespace vka
         /// Creates the mip-map levels.
         void create_mipmap(VkCommandBuffer cbo) const noexcept;
 
+        /**
+         * Stages all levels of a mip-map chain or compressor into one buffer and records a single copy with one region
+         * per level. The offset of every level is aligned to the texel or block size.
+         */
+        template<typename Levels>
+        Buffer load_levels(VkCommandBuffer cbo, const Levels& levels, VkDeviceSize texel_size, TextureLoadInfo info, uint32_t layer);
+
+        /**
+         * Computes the layout of a buffer containing multiple levels and layers.
+         * @param regions Receives the copy regions, can be <c>nullptr</c> to only compute the size.
+         * @return Returns the size of the buffer.
+         */
+        VkDeviceSize upload_layout(const TextureUploadLayout& layout, VkBufferImageCopy* regions) const noexcept;
+
+        /// @return Returns the number of copy regions of a buffer layout.
+        static constexpr uint32_t upload_region_count(const TextureUploadLayout& layout) noexcept;
+
+        /// Creates a host-visible staging buffer.
+        static Buffer create_staging(VkDevice device, VkDeviceSize size, TextureLoadInfo info);
+
         /// Creates the staging buffer and loads the image data into the buffer.
         static Buffer stage(VkDevice device, const void* data, VkDeviceSize size, TextureLoadInfo info);
 
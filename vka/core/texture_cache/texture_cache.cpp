@@ -0,0 +1,296 @@
+/**
+ * @brief Implementation for the texture cache.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+namespace
+{
+    constexpr uint32_t SHA256_ROUND_CONSTANTS[64] = {
+        0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+        0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+        0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+        0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+        0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+        0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+        0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+        0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2
+    };
+
+    constexpr size_t SHA256_BLOCK_SIZE = 64;
+
+    /// Processes 64-byte blocks of a message with the SHA-256 compression function.
+    void sha256_blocks(uint32_t (&state)[8], const uint8_t* data, size_t block_count) noexcept
+    {
+        for (size_t block = 0; block < block_count; ++block, data += SHA256_BLOCK_SIZE)
+        {
+            uint32_t w[64];
+            for (uint32_t i = 0; i < 16; ++i)
+                w[i] = (uint32_t)data[4 * i] << 24 | (uint32_t)data[4 * i + 1] << 16 | (uint32_t)data[4 * i + 2] << 8 | (uint32_t)data[4 * i + 3];
+            for (uint32_t i = 16; i < 64; ++i)
+            {
+                const uint32_t s0 = std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                const uint32_t s1 = std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+            }
+
+            uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+            uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+            for (uint32_t i = 0; i < 64; ++i)
+            {
+                const uint32_t t1 = h + (std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_ROUND_CONSTANTS[i] + w[i];
+                const uint32_t t2 = (std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+                h = g;
+                g = f;
+                f = e;
+                e = d + t1;
+                d = c;
+                c = b;
+                b = a;
+                a = t1 + t2;
+            }
+            state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+            state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+        }
+    }
+}
+
+vka::TextureCache::TextureCache() noexcept :
+    m_device(VK_NULL_HANDLE),
+    m_properties{},
+    m_create_info{},
+    m_hits(0),
+    m_misses(0)
+{}
+
+vka::TextureCache::TextureCache(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const TextureCacheCreateInfo& create_info) :
+    m_device(device),
+    m_properties(properties),
+    m_create_info(create_info),
+    m_hits(0),
+    m_misses(0)
+{
+    this->m_entries.reserve(create_info.estimatedCount);
+}
+
+vka::TextureCache::operator bool() const noexcept
+{
+    return this->m_device != VK_NULL_HANDLE;
+}
+
+VkDevice vka::TextureCache::parent() const noexcept
+{
+    return this->m_device;
+}
+
+size_t vka::TextureCache::count() const noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    return this->m_entries.size();
+}
+
+uint64_t vka::TextureCache::hit_count() const noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    return this->m_hits;
+}
+
+uint64_t vka::TextureCache::miss_count() const noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    return this->m_misses;
+}
+
+VkDeviceSize vka::TextureCache::memory_size() const noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    VkDeviceSize size = 0;
+    for (const auto& [key, entry] : this->m_entries)
+        size += entry.memory_size;
+    return size;
+}
+
+size_t vka::TextureCache::purge() noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    return std::erase_if(this->m_entries, [](const auto& item) {
+        const TextureFuture& future = item.second.future;
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready && future.get().use_count() == 1;
+    });
+}
+
+void vka::TextureCache::destroy() noexcept
+{
+    std::lock_guard lock(this->m_mutex);
+    this->m_entries.clear();
+    this->m_digests.clear();
+    this->m_device = VK_NULL_HANDLE;
+    this->m_properties = {};
+    this->m_create_info = {};
+    this->m_hits = 0;
+    this->m_misses = 0;
+}
+
+size_t vka::TextureCache::KeyHash::operator() (const Key& key) const noexcept
+{
+    size_t seed = std::hash<std::string>()(key.path);
+    const auto combine = [&seed](size_t value) {
+        seed ^= value + 0x9E3779B9 + (seed << 6) + (seed >> 2);
+    };
+    uint64_t digest_prefix;
+    std::memcpy(&digest_prefix, key.digest.data(), sizeof(digest_prefix));
+    combine(std::hash<uint64_t>()(key.file_size));
+    combine(std::hash<uint64_t>()(digest_prefix));
+    combine(std::hash<uint32_t>()((uint32_t)key.loader_format));
+    combine(std::hash<uint32_t>()((uint32_t)key.image_format));
+    combine(std::hash<bool>()(key.generate_mipmap));
+    return seed;
+}
+
+vka::TextureCache::Key vka::TextureCache::make_key(const char* path, VkFormat loader_format, const TextureCreateInfo& create_info)
+{
+    Key key = {
+        .path = {},
+        .file_size = 0,
+        .digest = {},
+        .loader_format = loader_format,
+        .image_format = create_info.imageFormat,
+        .generate_mipmap = create_info.generateMipMap
+    };
+
+    // If the path cannot be resolved, loading the file reports the error.
+    std::error_code error;
+    const std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+    std::string canonical_path = error ? std::string(path) : canonical.string();
+
+    if (this->m_create_info.key == TextureCacheKey::CONTENT)
+        this->digest_file(canonical_path, key);
+    else
+        key.path = std::move(canonical_path);
+    return key;
+}
+
+void vka::TextureCache::digest_file(const std::string& path, Key& key)
+{
+    std::error_code size_error, time_error;
+    const uint64_t size = std::filesystem::file_size(path, size_error);
+    const std::filesystem::file_time_type time = std::filesystem::last_write_time(path, time_error);
+    if (size_error || time_error) [[unlikely]]
+        detail::error::throw_invalid_argument(MSG_OPEN_FAILED);
+
+    {
+        std::lock_guard lock(this->m_mutex);
+        const auto it = this->m_digests.find(path);
+        if (it != this->m_digests.end() && it->second.size == size && it->second.time == time)
+        {
+            key.file_size = size;
+            key.digest = it->second.digest;
+            return;
+        }
+    }
+
+    // The file is hashed without holding a lock. The size of the key is the number of hashed bytes, so that a file
+    // that changes while it is read is hashed again by the next load.
+    key.digest = hash_file(path.c_str(), key.file_size);
+    std::lock_guard lock(this->m_mutex);
+    this->m_digests.insert_or_assign(path, FileDigest{ key.file_size, time, key.digest });
+}
+
+std::pair<vka::TextureCache::TextureFuture, bool> vka::TextureCache::find_or_insert(const Key& key, std::promise<std::shared_ptr<const Texture>>& promise)
+{
+    std::lock_guard lock(this->m_mutex);
+    const auto it = this->m_entries.find(key);
+    if (it != this->m_entries.end())
+    {
+        ++this->m_hits;
+        return { it->second.future, false };
+    }
+
+    ++this->m_misses;
+    TextureFuture future = promise.get_future().share();
+    this->m_entries.emplace(key, Entry{ future, 0 });
+    return { std::move(future), true };
+}
+
+std::shared_ptr<const vka::Texture> vka::TextureCache::upload(UploadBatch& batch, const void* data, VkDeviceSize size, VkExtent2D extent, uint32_t layer_count, const TextureCreateInfo& create_info)
+{
+    std::lock_guard lock(this->m_batch_mutex);
+    TextureCreateInfo texture_create_info = create_info;
+    texture_create_info.imageExtent = { extent.width, extent.height, 1 };
+    texture_create_info.imageArrayLayers = layer_count;
+    texture_create_info.commandBuffer = batch.command_buffer();
+
+    std::shared_ptr<Texture> texture = std::make_shared<Texture>(this->m_device, this->m_properties, texture_create_info);
+    batch.upload(*texture, data, size, 0, layer_count);
+    if (create_info.generateMipMap)
+        batch.finish(*texture);
+    else
+        batch.finish_manual(*texture);
+    return texture;
+}
+
+void vka::TextureCache::complete(const Key& key, std::promise<std::shared_ptr<const Texture>>& promise, std::shared_ptr<const Texture> texture)
+{
+    {
+        std::lock_guard lock(this->m_mutex);
+        const auto it = this->m_entries.find(key);
+        if (it != this->m_entries.end())
+            it->second.memory_size = texture->memory_size();
+    }
+    promise.set_value(std::move(texture));
+}
+
+void vka::TextureCache::fail(const Key& key, std::promise<std::shared_ptr<const Texture>>& promise) noexcept
+{
+    {
+        std::lock_guard lock(this->m_mutex);
+        this->m_entries.erase(key);
+    }
+    promise.set_exception(std::current_exception());
+}
+
+vka::TextureCache::Digest vka::TextureCache::hash_file(const char* path, uint64_t& size)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) [[unlikely]]
+        detail::error::throw_invalid_argument(MSG_OPEN_FAILED);
+
+    uint32_t state[8] = { 0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19 };
+    std::vector<uint8_t> buffer(1 << 16);
+    size = 0;
+    size_t count;
+    do
+    {
+        // The buffer is a multiple of the block size, so only the last chunk leaves a partial block.
+        file.read((char*)buffer.data(), (std::streamsize)buffer.size());
+        count = (size_t)file.gcount();
+        size += count;
+        sha256_blocks(state, buffer.data(), count / SHA256_BLOCK_SIZE);
+    }
+    while (count == buffer.size());
+
+    // Padding: a single 1-bit, zeros and the message length in bits as 64-bit big endian integer.
+    uint8_t tail[2 * SHA256_BLOCK_SIZE] = {};
+    const size_t remainder = count % SHA256_BLOCK_SIZE;
+    std::memcpy(tail, buffer.data() + count - remainder, remainder);
+    tail[remainder] = 0x80;
+    const size_t tail_size = remainder < SHA256_BLOCK_SIZE - 8 ? SHA256_BLOCK_SIZE : 2 * SHA256_BLOCK_SIZE;
+    const uint64_t bit_count = size * 8;
+    for (uint32_t i = 0; i < 8; ++i)
+        tail[tail_size - 1 - i] = (uint8_t)(bit_count >> (8 * i));
+    sha256_blocks(state, tail, tail_size / SHA256_BLOCK_SIZE);
+
+    Digest digest;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        digest[4 * i] = (uint8_t)(state[i] >> 24);
+        digest[4 * i + 1] = (uint8_t)(state[i] >> 16);
+        digest[4 * i + 2] = (uint8_t)(state[i] >> 8);
+        digest[4 * i + 3] = (uint8_t)state[i];
+    }
+    return digest;
+}
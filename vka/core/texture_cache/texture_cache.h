@@ -0,0 +1,221 @@
+/**
+ * @brief Cache that shares textures which are loaded from the same file.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+namespace vka
+{
+    /**
+     * Specifies how the files of a texture cache are identified.
+     * - <c>PATH</c> -- Files are identified by their canonical path, so that different spellings of the same path
+     * share a texture.
+     * - <c>CONTENT</c> -- Files are identified by their size and the SHA-256 digest of their content, so that copies of
+     * a file at different paths also share a texture. The digest of a path is computed when it is loaded the first time
+     * and again only when the size or the modification time of the file changed.
+     */
+    enum class TextureCacheKey
+    {
+        PATH,
+        CONTENT
+    };
+
+    /**
+     * Structure specifying the parameters of a newly created texture cache.
+     * - <c>key</c> -- Specifies how the files are identified.
+     * - <c>estimatedCount</c> -- Estimate of the number of textures, which is used for pre-allocation.
+     */
+    struct TextureCacheCreateInfo
+    {
+        TextureCacheKey         key;
+        uint32_t                estimatedCount;
+    };
+
+    /**
+     * Loads textures from image files and shares them between all users of the same file. A texture is identified by
+     * its file, the loader format, the image format and its mip-map settings. Therefore, loading the same file with
+     * different formats or mip-map settings creates different textures. All other parameters of the
+     * <c>TextureCreateInfo</c> are taken from the first load of a texture. The textures are uploaded with an
+     * <c>UploadBatch</c> and are ready to be used, once the batch has been executed.
+     * If multiple threads load the same texture at the same time, the file is decoded only once and all other threads
+     * wait for it. Different textures are decoded in parallel. The cache keeps a reference to each of its textures, so
+     * that they stay loaded when no one else uses them. Call <c>purge()</c> to release the textures that are only
+     * referenced by the cache.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates an <b>empty</b> cache. This empty object is invalid and cannot perform any
+     * actions. Calling <c>parent()</c> returns <c>VK_NULL_HANDLE</c>. Calling <c>destroy()</c> does nothing.
+     *
+     * <b>Initialization:</b>\n
+     * The initialization constructor creates a valid cache without any textures.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * The cache cannot be moved, because it is internally synchronized. Use a <c>std::unique_ptr</c> to transfer its
+     * ownership.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Releases the references of the cache to its textures. Textures which are still referenced elsewhere stay valid.
+     * After destroying the object is an <b>empty</b> cache.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class is internally synchronized and can be used from any thread. The upload batch passed to
+     * <c>load()</c> is only accessed while the cache holds its lock, but it must not be used by other threads or
+     * submitted while loads into it are in progress.
+     *
+     * <b>Actions:</b>
+     * - <b>load</b> -- Invoked by <c>load()</c> returns a cached texture or decodes and uploads it.
+     * - <b>purge</b> -- Invoked by <c>purge()</c> releases textures that are only referenced by the cache.
+     */
+    class TextureCache final
+    {
+    public:
+        /// Creates an empty texture cache. This texture cache is invalid.
+        TextureCache() noexcept;
+
+        /**
+         * Creates the texture cache. The cache is valid if no exception was thrown.
+         * @param device Device with which the textures are created.
+         * @param properties Memory properties of the physical device.
+         * @param create_info Create-info for the texture cache.
+         */
+        explicit TextureCache(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const TextureCacheCreateInfo& create_info);
+
+        /// Releases the references to the textures.
+        ~TextureCache() = default;
+
+        /// @return Returns whether the texture cache is valid.
+        explicit operator bool() const noexcept;
+
+        /// @return Returns the parent handle.
+        VkDevice parent() const noexcept;
+
+        /// @return Returns the number of cached textures including the ones that are still loading.
+        size_t count() const noexcept;
+
+        /// @return Returns the number of loads that were served from the cache.
+        uint64_t hit_count() const noexcept;
+
+        /// @return Returns the number of loads that decoded a file.
+        uint64_t miss_count() const noexcept;
+
+        /// @return Returns the device memory of all cached textures in bytes.
+        VkDeviceSize memory_size() const noexcept;
+
+        /**
+         * Returns the texture of an image file and loads it, if it is not in the cache. A loaded texture is created
+         * with the command buffer of the batch and its data is added to the batch. If mip-map generation is enabled,
+         * the texture is finished with <c>UploadBatch::finish()</c>, otherwise with
+         * <c>UploadBatch::finish_manual()</c>.
+         * @tparam F Format of the loader, which must have the same number of components as the image format.
+         * @param batch Batch which uploads the texture. It is only used, if the texture is not in the cache.
+         * @param path Path to the image file.
+         * @param create_info Create-info of the texture. The fields <c>imageExtent</c>, <c>imageArrayLayers</c> and
+         * <c>commandBuffer</c> are set by the cache.
+         * @return Returns the shared texture.
+         * @throw std::invalid_argument Is thrown if the file could not be found.
+         * @throw std::runtime_error Is thrown, if creating the texture or a staging buffer failed.
+         * @note If loading fails, the exception is also thrown by all loads that waited for it and the texture is not
+         * cached, so that a later load tries again.
+         */
+        template<VkFormat F> requires detail::texture::is_loader_format<F>
+        std::shared_ptr<const Texture> load(UploadBatch& batch, const char* path, const TextureCreateInfo& create_info);
+
+        /**
+         * Releases all textures which are only referenced by the cache. Textures that are still loading are kept.
+         * @return Returns the number of released textures.
+         * @pre Batches into which textures were loaded have been submitted.
+         */
+        size_t purge() noexcept;
+
+        /**
+         * Destroys the texture cache. After destroying the texture cache is empty and therefore invalid.
+         * @pre No load is in progress.
+         */
+        void destroy() noexcept;
+
+        // Deleted:
+        TextureCache(const TextureCache&) = delete;
+        TextureCache& operator= (const TextureCache&) = delete;
+
+    private:
+        static constexpr const char* MSG_OPEN_FAILED = "[vka::TextureCache]: Failed to open file.";
+
+        using TextureFuture = std::shared_future<std::shared_ptr<const Texture>>;
+        using Digest = std::array<uint8_t, 32>;
+
+        struct Key
+        {
+            std::string path;
+            uint64_t file_size;
+            Digest digest;
+            VkFormat loader_format;
+            VkFormat image_format;
+            bool generate_mipmap;
+
+            bool operator== (const Key& other) const noexcept = default;
+        };
+
+        struct KeyHash
+        {
+            size_t operator() (const Key& key) const noexcept;
+        };
+
+        struct Entry
+        {
+            TextureFuture future;
+            VkDeviceSize memory_size;
+        };
+
+        /// Digest of a file, which is valid as long as its size and modification time do not change.
+        struct FileDigest
+        {
+            uint64_t size;
+            std::filesystem::file_time_type time;
+            Digest digest;
+        };
+
+        VkDevice m_device;
+        VkPhysicalDeviceMemoryProperties m_properties;
+        TextureCacheCreateInfo m_create_info;
+        mutable std::mutex m_mutex;
+        std::mutex m_batch_mutex;
+        std::unordered_map<Key, Entry, KeyHash> m_entries;
+        std::unordered_map<std::string, FileDigest> m_digests;
+        uint64_t m_hits;
+        uint64_t m_misses;
+
+        /// Creates the key of an image file.
+        Key make_key(const char* path, VkFormat loader_format, const TextureCreateInfo& create_info);
+
+        /// Sets the size and the digest of a key from the file, which is only read if its digest is not known.
+        void digest_file(const std::string& path, Key& key);
+
+        /**
+         * Looks up a key and inserts a pending entry that waits for the promise, if it is not contained.
+         * @return Returns the future of the entry and whether this call has to load the texture.
+         */
+        std::pair<TextureFuture, bool> find_or_insert(const Key& key, std::promise<std::shared_ptr<const Texture>>& promise);
+
+        /// Creates the texture and adds its upload to the batch.
+        std::shared_ptr<const Texture> upload(UploadBatch& batch, const void* data, VkDeviceSize size, VkExtent2D extent, uint32_t layer_count, const TextureCreateInfo& create_info);
+
+        /// Stores the loaded texture in its entry.
+        void complete(const Key& key, std::promise<std::shared_ptr<const Texture>>& promise, std::shared_ptr<const Texture> texture);
+
+        /// Removes the entry of a texture that failed to load and passes the exception to the waiting loads.
+        void fail(const Key& key, std::promise<std::shared_ptr<const Texture>>& promise) noexcept;
+
+        /// Computes the SHA-256 digest of the content of a file.
+        static Digest hash_file(const char* path, uint64_t& size);
+    };
+}
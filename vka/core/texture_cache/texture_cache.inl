@@ -0,0 +1,37 @@
+/**
+ * @brief Inline implementation for the texture cache.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+#include "texture_cache.h"
+
+template<VkFormat F> requires vka::detail::texture::is_loader_format<F>
+std::shared_ptr<const vka::Texture> vka::TextureCache::load(UploadBatch& batch, const char* path, const TextureCreateInfo& create_info)
+{
+    const Key key = this->make_key(path, F, create_info);
+    std::promise<std::shared_ptr<const Texture>> promise;
+    const auto [future, inserted] = this->find_or_insert(key, promise);
+    if (!inserted)
+        return future.get();
+
+    // The file is decoded without holding a lock, so that other textures are loaded in parallel.
+    try
+    {
+        const TextureLoader<F> loader(path);
+        const VkExtent3D extent = loader.extent2D();
+        const VkDeviceSize size = (VkDeviceSize)extent.width * extent.height * loader.layer_count() * format_sizeof(F);
+        std::shared_ptr<const Texture> texture = this->upload(batch, loader.data(), size, { extent.width, extent.height }, loader.layer_count(), create_info);
+        this->complete(key, promise, texture);
+        return texture;
+    }
+    catch (...)
+    {
+        this->fail(key, promise);
+        throw;
+    }
+}
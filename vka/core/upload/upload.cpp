@@ -0,0 +1,370 @@
+/**
+ * @brief Implementation for the upload batch.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+vka::UploadBatch::UploadBatch(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const UploadBatchCreateInfo& create_info) :
+    m_device(device),
+    m_pool(create_info.commandPool),
+    m_cbo(VK_NULL_HANDLE),
+    m_fence(create_fence(device)),
+    m_properties(properties),
+    m_create_info(create_info),
+    m_current(NPOS),
+    m_offset(0),
+    m_staging_size(0),
+    m_submitted(false)
+{
+    if (this->m_create_info.stagingSize == 0)
+        this->m_create_info.stagingSize = DEFAULT_STAGING_SIZE;
+    this->m_cbo = begin_command_buffer(device, create_info.commandPool);
+}
+
+vka::UploadBatch::UploadBatch(UploadBatch&& src) noexcept :
+    m_device(src.m_device),
+    m_pool(src.m_pool),
+    m_cbo(src.m_cbo),
+    m_fence(std::move(src.m_fence)),
+    m_properties(src.m_properties),
+    m_create_info(src.m_create_info),
+    m_staging(std::move(src.m_staging)),
+    m_current(src.m_current),
+    m_offset(src.m_offset),
+    m_staging_size(src.m_staging_size),
+    m_buffer_copies(std::move(src.m_buffer_copies)),
+    m_image_copies(std::move(src.m_image_copies)),
+    m_image_barriers(std::move(src.m_image_barriers)),
+    m_mipmaps(std::move(src.m_mipmaps)),
+    m_submitted(src.m_submitted)
+{
+    src.m_cbo = VK_NULL_HANDLE;
+    src.m_submitted = false;
+}
+
+vka::UploadBatch::~UploadBatch()
+{
+    this->destroy();
+}
+
+vka::UploadBatch& vka::UploadBatch::operator= (UploadBatch&& src) noexcept
+{
+    this->destroy();
+    this->m_device = src.m_device;
+    this->m_pool = src.m_pool;
+    this->m_cbo = src.m_cbo;
+    this->m_fence = std::move(src.m_fence);
+    this->m_properties = src.m_properties;
+    this->m_create_info = src.m_create_info;
+    this->m_staging = std::move(src.m_staging);
+    this->m_current = src.m_current;
+    this->m_offset = src.m_offset;
+    this->m_staging_size = src.m_staging_size;
+    this->m_buffer_copies = std::move(src.m_buffer_copies);
+    this->m_image_copies = std::move(src.m_image_copies);
+    this->m_image_barriers = std::move(src.m_image_barriers);
+    this->m_mipmaps = std::move(src.m_mipmaps);
+    this->m_submitted = src.m_submitted;
+    src.m_cbo = VK_NULL_HANDLE;
+    src.m_submitted = false;
+    return *this;
+}
+
+void vka::UploadBatch::destroy() noexcept
+{
+    if (this->m_cbo == VK_NULL_HANDLE)
+        return;
+
+    // The command buffer and the staging buffers must not be released while they are still in use.
+    if (this->m_submitted)
+    {
+        const VkFence fence = this->m_fence.get();
+        vkWaitForFences(this->m_device, 1, &fence, VK_TRUE, NO_TIMEOUT);
+    }
+    vkFreeCommandBuffers(this->m_device, this->m_pool, 1, &this->m_cbo);
+    this->release();
+
+    this->m_fence = VK_NULL_HANDLE;
+    this->m_device = VK_NULL_HANDLE;
+    this->m_pool = VK_NULL_HANDLE;
+    this->m_cbo = VK_NULL_HANDLE;
+    this->m_submitted = false;
+}
+
+void vka::UploadBatch::upload(const Buffer& dst, const void* data, VkDeviceSize size, VkDeviceSize offset)
+{
+    const BufferSlice slice = this->stage(data, size, STAGING_ALIGNMENT);
+    this->m_buffer_copies.push_back({
+        .src = slice.buffer,
+        .dst = dst.handle(),
+        .region = { slice.offset, offset, size }
+    });
+}
+
+void vka::UploadBatch::upload(const Texture& dst, const void* data, VkDeviceSize size, uint32_t layer, uint32_t count, uint32_t level)
+{
+    // The buffer offset of a copy to an image must be a multiple of the texel or block size and of 4.
+    const VkDeviceSize alignment = std::lcm((VkDeviceSize)format_sizeof(dst.format()), (VkDeviceSize)4);
+    const BufferSlice slice = this->stage(data, size, alignment);
+    const VkImageSubresourceLayers layers = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .mipLevel = level,
+        .baseArrayLayer = layer,
+        .layerCount = count
+    };
+    this->m_image_copies.push_back({
+        .src = slice.buffer,
+        .dst = dst.image(),
+        .region = {
+            .bufferOffset = slice.offset,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = layers,
+            .imageOffset = { 0, 0, 0 },
+            .imageExtent = common::mip_extent(dst.size(), level)
+        }
+    });
+}
+
+void vka::UploadBatch::finish(Texture& texture)
+{
+    // Generating the mip-map needs its own barriers per level, any other texture only needs the final transition.
+    if (texture.level_count() > 1)
+        this->m_mipmaps.push_back(&texture);
+    else
+        this->finish_manual(texture);
+}
+
+void vka::UploadBatch::finish_manual(const Texture& texture)
+{
+    const VkImageSubresourceRange range = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = texture.level_count(),
+        .baseArrayLayer = 0,
+        .layerCount = texture.layer_count()
+    };
+    this->m_image_barriers.push_back({
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = texture.image(),
+        .subresourceRange = range
+    });
+}
+
+void vka::UploadBatch::submit(VkQueue queue, VkPipelineStageFlags stages)
+{
+    for (Buffer& staging : this->m_staging)
+        staging.flush();
+
+    // Copies from the same staging buffer to the same resource are recorded with a single command, consecutive uploads
+    // are merged into a single region.
+    std::stable_sort(this->m_buffer_copies.begin(), this->m_buffer_copies.end(), [](const BufferCopy& a, const BufferCopy& b) {
+        return a.src != b.src ? a.src < b.src : a.dst < b.dst;
+    });
+    std::vector<VkBufferCopy> buffer_regions;
+    for (size_t i = 0; i < this->m_buffer_copies.size();)
+    {
+        const BufferCopy& first = this->m_buffer_copies[i];
+        buffer_regions.clear();
+        for (; i < this->m_buffer_copies.size() && this->m_buffer_copies[i].src == first.src && this->m_buffer_copies[i].dst == first.dst; i++)
+            buffer_regions.push_back(this->m_buffer_copies[i].region);
+        detail::buffer::merge_copies(buffer_regions);
+        vkCmdCopyBuffer(this->m_cbo, first.src, first.dst, static_cast<uint32_t>(buffer_regions.size()), buffer_regions.data());
+    }
+
+    std::stable_sort(this->m_image_copies.begin(), this->m_image_copies.end(), [](const ImageCopy& a, const ImageCopy& b) {
+        return a.src != b.src ? a.src < b.src : a.dst < b.dst;
+    });
+    std::vector<VkBufferImageCopy> image_regions;
+    for (size_t i = 0; i < this->m_image_copies.size();)
+    {
+        const ImageCopy& first = this->m_image_copies[i];
+        image_regions.clear();
+        for (; i < this->m_image_copies.size() && this->m_image_copies[i].src == first.src && this->m_image_copies[i].dst == first.dst; i++)
+            image_regions.push_back(this->m_image_copies[i].region);
+        vkCmdCopyBufferToImage(this->m_cbo, first.src, first.dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(image_regions.size()), image_regions.data());
+    }
+
+    // All buffers share a single memory barrier and all textures without mip-map generation share the same pipeline
+    // barrier.
+    const VkMemoryBarrier memory_barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext = nullptr,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT
+    };
+    const uint32_t memory_barrier_count = this->m_buffer_copies.empty() ? 0 : 1;
+    if (memory_barrier_count > 0 || !this->m_image_barriers.empty())
+    {
+        vkCmdPipelineBarrier(
+            this->m_cbo,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            stages,
+            0,
+            memory_barrier_count,
+            &memory_barrier,
+            0,
+            nullptr,
+            static_cast<uint32_t>(this->m_image_barriers.size()),
+            this->m_image_barriers.data()
+        );
+    }
+    for (Texture* texture : this->m_mipmaps)
+        texture->finish(this->m_cbo, stages);
+
+    const VkSubmitInfo submit_info = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = nullptr,
+        .waitSemaphoreCount = 0,
+        .pWaitSemaphores = nullptr,
+        .pWaitDstStageMask = nullptr,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &this->m_cbo,
+        .signalSemaphoreCount = 0,
+        .pSignalSemaphores = nullptr
+    };
+    const VkFence fence = this->m_fence.get();
+    check_result(vkEndCommandBuffer(this->m_cbo), MSG_CBO_END_FAILED);
+    check_result(vkQueueSubmit(queue, 1, &submit_info, fence), MSG_SUBMIT_FAILED);
+    this->m_submitted = true;
+
+    // Only the staging buffers are needed until the submission has been executed.
+    this->m_buffer_copies.clear();
+    this->m_image_copies.clear();
+    this->m_image_barriers.clear();
+    this->m_mipmaps.clear();
+}
+
+bool vka::UploadBatch::complete()
+{
+    const VkResult res = vkGetFenceStatus(this->m_device, this->m_fence.get());
+    check_result(res, MSG_FENCE_STATUS_FAILED);
+    if (res != VK_SUCCESS)
+        return false;
+    this->release();
+    return true;
+}
+
+VkResult vka::UploadBatch::wait(uint64_t timeout)
+{
+    const VkFence fence = this->m_fence.get();
+    const VkResult res = vkWaitForFences(this->m_device, 1, &fence, VK_TRUE, timeout);
+    check_result(res, MSG_FENCE_WAIT_FAILED);
+    if (res == VK_SUCCESS)
+        this->release();
+    return res;
+}
+
+vka::BufferSlice vka::UploadBatch::stage(const void* data, VkDeviceSize size, VkDeviceSize alignment)
+{
+    // Uploads that do not fit into a shared staging buffer get their own one, the shared one stays current. The
+    // current index is NPOS until the first shared buffer is created, so that an own buffer never becomes shared.
+    Buffer* staging;
+    // The alignment of texture copies is not necessarily a power of 2.
+    VkDeviceSize offset = (this->m_offset + alignment - 1) / alignment * alignment;
+    if (size > this->m_create_info.stagingSize)
+    {
+        this->m_staging.push_back(this->create_staging(size));
+        staging = &this->m_staging.back();
+        offset = 0;
+    }
+    else
+    {
+        if (this->m_current == NPOS || offset + size > this->m_create_info.stagingSize)
+        {
+            this->m_staging.push_back(this->create_staging(this->m_create_info.stagingSize));
+            this->m_current = this->m_staging.size() - 1;
+            offset = 0;
+        }
+        staging = &this->m_staging[this->m_current];
+        this->m_offset = offset + size;
+    }
+
+    void* const map = staging->map(offset, size);
+    memcpy(map, data, size);
+    this->m_staging_size += size;
+    return { staging->handle(), offset, size, map };
+}
+
+vka::Buffer vka::UploadBatch::create_staging(VkDeviceSize size) const
+{
+    const BufferCreateInfo create_info = {
+        .pBufferNext = nullptr,
+        .bufferFlags = 0,
+        .bufferSize = size,
+        .bufferUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        .bufferSharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .bufferQueueFamilyIndexCount = 1,
+        .bufferQueueFamilyIndices = &this->m_create_info.queueFamilyIndex,
+        .pMemoryNext = nullptr,
+        .memoryType = this->m_create_info.memoryType | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+        .memoryTypePreferred = 0,
+        .memoryTypeForbidden = 0,
+        .memoryAllocator = this->m_create_info.memoryAllocator,
+        .memoryNonCoherentAtomSize = this->m_create_info.memoryNonCoherentAtomSize,
+        .memoryPersistentMap = true,
+        .memoryTracker = this->m_create_info.memoryTracker,
+        .memoryDebugName = "vka::UploadBatch staging"
+    };
+    return Buffer(this->m_device, this->m_properties, create_info);
+}
+
+void vka::UploadBatch::release() noexcept
+{
+    this->m_staging.clear();
+    this->m_buffer_copies.clear();
+    this->m_image_copies.clear();
+    this->m_image_barriers.clear();
+    this->m_mipmaps.clear();
+    this->m_current = NPOS;
+    this->m_offset = 0;
+    this->m_staging_size = 0;
+}
+
+VkCommandBuffer vka::UploadBatch::begin_command_buffer(VkDevice device, VkCommandPool pool)
+{
+    const VkCommandBufferAllocateInfo alloc_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .commandPool = pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+    VkCommandBuffer cbo;
+    check_result(vkAllocateCommandBuffers(device, &alloc_info, &cbo), MSG_CBO_ALLOC_FAILED);
+
+    constexpr VkCommandBufferBeginInfo begin_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = nullptr,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = nullptr
+    };
+    const VkResult res = vkBeginCommandBuffer(cbo, &begin_info);
+    if (is_error(res)) [[unlikely]]
+        vkFreeCommandBuffers(device, pool, 1, &cbo);
+    check_result(res, MSG_CBO_BEGIN_FAILED);
+    return cbo;
+}
+
+vka::unique_handle<VkFence> vka::UploadBatch::create_fence(VkDevice device)
+{
+    constexpr VkFenceCreateInfo create_info = {
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0
+    };
+    VkFence fence;
+    check_result(vkCreateFence(device, &create_info, nullptr, &fence), MSG_FENCE_CREATE_FAILED);
+    return unique_handle(device, fence);
+}
@@ -0,0 +1,262 @@
+/**
+ * @brief Batch that collects many uploads and submits them at once.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+namespace vka
+{
+    /**
+     * Structure specifying the parameters of a newly created upload batch. Parameters prefixed with <c>memory</c>
+     * correspond to the parameters of <c>BufferCreateInfo</c> and are used for the staging buffers.
+     * - <c>commandPool</c> -- Pool from which the command buffer of the batch is allocated.
+     * - <c>queueFamilyIndex</c> -- Queue family of the staging buffers, the same as the one of the command pool.
+     * - <c>memoryType</c> -- Must contain <c>VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT</c>.
+     * - <c>stagingSize</c> -- Size of a single staging buffer. All uploads are packed into the same staging buffer
+     * until it is full. Uploads which are larger than this size get their own staging buffer. If it is <c>0</c>,
+     * <c>UploadBatch::DEFAULT_STAGING_SIZE</c> is used.
+     */
+    struct UploadBatchCreateInfo
+    {
+        VkCommandPool           commandPool;
+        uint32_t                queueFamilyIndex;
+        VkMemoryPropertyFlags   memoryType;
+        MemoryAllocator*        memoryAllocator;
+        VkDeviceSize            memoryNonCoherentAtomSize;
+        MemoryTracker*          memoryTracker;
+        VkDeviceSize            stagingSize;
+    };
+
+    /**
+     * Collects uploads of buffer and texture data and submits them with a single command buffer. The data is copied
+     * into large staging buffers when an upload is added. When the batch is submitted, copies to the same resource are
+     * recorded with a single command and all layout transitions and memory barriers are recorded with a single
+     * pipeline barrier. The staging buffers are released, once the fence of the submission has been signaled.
+     * Textures must be created with <c>command_buffer()</c> as their command buffer, so that they are in the transfer
+     * layout when the copies are executed.
+     *
+     * <b>Default initialization:</b>\n
+     * The default constructor creates an <b>empty</b> batch. This empty object is invalid and cannot perform any
+     * actions. Any member function returning a vulkan handle returns <c>VK_NULL_HANDLE</c>. Calling <c>destroy()</c>
+     * does nothing.
+     *
+     * <b>Initialization:</b>\n
+     * The initialization constructor creates a valid batch whose command buffer is recording, if no exception was
+     * thrown.
+     *
+     * <b>Copy behaviour:</b>\n
+     * The copy constructor and operator are deleted.
+     *
+     * <b>Moving behaviour:</b>\n
+     * When calling the move constructor or operator, the moved object is invalidated and performing any operation on it
+     * is unsafe. This may lead to undefined behaviour or even a crash. If an already valid object is replaced by a
+     * move, the current object is destroyed.
+     *
+     * <b>Destroy behaviour:</b>\n
+     * Waits until a submitted batch has been executed, frees the command buffer, destroys the fence and releases the
+     * staging buffers. After destroying the object is an <b>empty</b> batch.
+     *
+     * <b>Inheritance behaviour:</b>\n
+     * This class is final and cannot be inherited.
+     *
+     * <b>Threading behaviour:</b>\n
+     * This class can be created and used from any thread. However, if you use this class across multiple threads,
+     * actions must be externally synchronized.
+     *
+     * <b>Actions:</b>
+     * - <b>upload</b> -- Invoked by <c>upload()</c> copies data into the staging memory and adds a copy to the batch.
+     * - <b>finishing</b> -- Invoked by <c>finish()</c> or <c>finish_manual()</c> adds the final layout transition of
+     * a texture to the batch.
+     * - <b>submission</b> -- Invoked by <c>submit()</c> records and submits all copies and barriers.
+     * - <b>wait</b> -- Invoked by <c>wait()</c> waits for the submission and releases the staging memory.
+     */
+    class UploadBatch final
+    {
+    public:
+        /// Default size of a staging buffer.
+        static constexpr VkDeviceSize DEFAULT_STAGING_SIZE = 64ull * 1024 * 1024;
+
+        /// Creates an empty batch. This batch is invalid.
+        constexpr UploadBatch() noexcept;
+
+        /**
+         * Creates the batch and begins the recording of its command buffer. The batch is valid if no exception was
+         * thrown.
+         * @param device Device with which the batch is created.
+         * @param properties Memory properties of the physical device.
+         * @param create_info Create-info for the batch.
+         * @throw std::runtime_error Is thrown, if allocating or beginning the command buffer or creating the fence
+         * failed.
+         */
+        explicit UploadBatch(VkDevice device, const VkPhysicalDeviceMemoryProperties& properties, const UploadBatchCreateInfo& create_info);
+
+        /// Moves a batch. The source batch becomes invalidated and using to results in undefined behaviour.
+        UploadBatch(UploadBatch&& src) noexcept;
+
+        /// Waits for a submitted batch and destroys it.
+        ~UploadBatch();
+
+        /**
+         * Moves a batch. The source batch becomes invalidated and using to results in undefined behaviour. An already
+         * created batch is destroyed.
+         */
+        UploadBatch& operator= (UploadBatch&& src) noexcept;
+
+        /// @return Returns whether the batch is valid.
+        explicit constexpr operator bool() const noexcept;
+
+        /// @return Returns the parent handle.
+        constexpr VkDevice parent() const noexcept;
+
+        /**
+         * @return Returns the command buffer of the batch. Textures which are uploaded by the batch are created with
+         * this command buffer. Commands that are recorded by the caller are executed before the copies of the batch.
+         */
+        constexpr VkCommandBuffer command_buffer() const noexcept;
+
+        /// @return Returns the fence which is signaled, when the submission has been executed.
+        constexpr VkFence fence() const noexcept;
+
+        /// @return Returns the number of bytes that are currently used in staging buffers.
+        constexpr VkDeviceSize staging_size() const noexcept;
+
+        /// @return Returns whether the batch has been submitted.
+        constexpr bool submitted() const noexcept;
+
+        /// Destroys the batch. After destroying the batch is empty and therefore invalid.
+        void destroy() noexcept;
+
+        /**
+         * Adds an upload of data into a buffer.
+         * @param dst Destination buffer. Must be created with <c>VK_BUFFER_USAGE_TRANSFER_DST_BIT</c>.
+         * @param data Data to upload.
+         * @param size Number of bytes to upload.
+         * @param offset Offset in bytes in the destination buffer.
+         * @throw std::runtime_error Is thrown, if creating a staging buffer failed.
+         * @pre The batch has not been submitted.
+         */
+        void upload(const Buffer& dst, const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+
+        /**
+         * Adds an upload of image data into a texture. The data is tightly packed.
+         * @param dst Destination texture. Must be in the loading state (see <c>command_buffer()</c>).
+         * @param data Data to upload.
+         * @param size Number of bytes to upload.
+         * @param layer Target array layer.
+         * @param count Number of affected layers. Range of affected layers:\n
+         * <c>[layer, layer + count - 1]</c>.
+         * @param level Target mip-map level.
+         * @throw std::runtime_error Is thrown, if creating a staging buffer failed.
+         * @pre The batch has not been submitted.
+         */
+        void upload(const Texture& dst, const void* data, VkDeviceSize size, uint32_t layer, uint32_t count = 1, uint32_t level = 0);
+
+        /**
+         * Finishes a texture after its data has been uploaded and creates the mip-map (if mip-map creation is
+         * activated). Textures without additional mip-map levels share a single layout transition.
+         * @param texture Texture to finish. It must live until the batch is submitted.
+         * @pre The batch has not been submitted.
+         */
+        void finish(Texture& texture);
+
+        /**
+         * Finishes a texture after its data has been uploaded without creating the mip-map. This operation must be
+         * used, if you specified custom mip-map levels.
+         * @param texture Texture to finish.
+         * @pre The batch has not been submitted.
+         */
+        void finish_manual(const Texture& texture);
+
+        /**
+         * Records all copies and barriers and submits the command buffer.
+         * @param queue Queue to which the batch is submitted.
+         * @param stages Pipeline stages in which the uploaded resources are used.
+         * @throw std::runtime_error Is thrown, if flushing the staging memory, ending the command buffer or submitting
+         * it failed.
+         * @pre The batch has not been submitted.
+         */
+        void submit(VkQueue queue, VkPipelineStageFlags stages);
+
+        /**
+         * Checks whether the submission has been executed. If this is the case, the staging buffers are released.
+         * @return Returns <c>true</c>, if the submission has been executed.
+         * @throw std::runtime_error Is thrown, if querying the fence status failed.
+         * @pre The batch has been submitted.
+         */
+        bool complete();
+
+        /**
+         * Waits until the submission has been executed and releases the staging buffers.
+         * @param timeout Optionally specifies a timeout value in nanoseconds.
+         * @return Only returns success codes like <c>VK_SUCCESS</c> or <c>VK_TIMEOUT</c>.
+         * @throw std::runtime_error Is thrown, if the wait operation failed.
+         * @pre The batch has been submitted.
+         */
+        VkResult wait(uint64_t timeout = NO_TIMEOUT);
+
+        // deleted
+        UploadBatch(const UploadBatch&) = delete;
+        UploadBatch& operator= (const UploadBatch&) = delete;
+
+    private:
+        static constexpr const char* MSG_CBO_ALLOC_FAILED = "[vka::UploadBatch]: Failed to allocate command buffer.";
+        static constexpr const char* MSG_CBO_BEGIN_FAILED = "[vka::UploadBatch]: Failed to begin command buffer recording.";
+        static constexpr const char* MSG_CBO_END_FAILED = "[vka::UploadBatch]: Failed to end command buffer recording.";
+        static constexpr const char* MSG_FENCE_CREATE_FAILED = "[vka::UploadBatch]: Failed to create fence.";
+        static constexpr const char* MSG_FENCE_STATUS_FAILED = "[vka::UploadBatch]: Failed to query fence status.";
+        static constexpr const char* MSG_FENCE_WAIT_FAILED = "[vka::UploadBatch]: Failed to wait for fence.";
+        static constexpr const char* MSG_SUBMIT_FAILED = "[vka::UploadBatch]: Failed to submit command buffer.";
+
+        /// Alignment of staging offsets of buffer copies. Offsets of texture copies are aligned to the texel size.
+        static constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+        struct BufferCopy
+        {
+            VkBuffer src;
+            VkBuffer dst;
+            VkBufferCopy region;
+        };
+
+        struct ImageCopy
+        {
+            VkBuffer src;
+            VkImage dst;
+            VkBufferImageCopy region;
+        };
+
+        VkDevice m_device;
+        VkCommandPool m_pool;
+        VkCommandBuffer m_cbo;
+        unique_handle<VkFence> m_fence;
+        VkPhysicalDeviceMemoryProperties m_properties;
+        UploadBatchCreateInfo m_create_info;
+        std::vector<Buffer> m_staging;
+        size_t m_current;
+        VkDeviceSize m_offset;
+        VkDeviceSize m_staging_size;
+        std::vector<BufferCopy> m_buffer_copies;
+        std::vector<ImageCopy> m_image_copies;
+        std::vector<VkImageMemoryBarrier> m_image_barriers;
+        std::vector<Texture*> m_mipmaps;
+        bool m_submitted;
+
+        /// Copies data into the staging memory at an offset that is a multiple of the alignment.
+        BufferSlice stage(const void* data, VkDeviceSize size, VkDeviceSize alignment);
+
+        /// Creates a staging buffer.
+        Buffer create_staging(VkDeviceSize size) const;
+
+        /// Releases the staging buffers and the recorded uploads.
+        void release() noexcept;
+
+        /// Allocates and begins the command buffer.
+        static VkCommandBuffer begin_command_buffer(VkDevice device, VkCommandPool pool);
+
+        /// Creates the fence.
+        static unique_handle<VkFence> create_fence(VkDevice device);
+    };
+}
@@ -0,0 +1,53 @@
+/**
+ * @brief Inline implementation for the upload batch.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+#include "upload.h"
+
+constexpr vka::UploadBatch::UploadBatch() noexcept :
+    m_device(VK_NULL_HANDLE),
+    m_pool(VK_NULL_HANDLE),
+    m_cbo(VK_NULL_HANDLE),
+    m_properties{},
+    m_create_info{},
+    m_current(NPOS),
+    m_offset(0),
+    m_staging_size(0),
+    m_submitted(false)
+{}
+
+constexpr vka::UploadBatch::operator bool() const noexcept
+{
+    return this->m_cbo != VK_NULL_HANDLE;
+}
+
+constexpr VkDevice vka::UploadBatch::parent() const noexcept
+{
+    return this->m_device;
+}
+
+constexpr VkCommandBuffer vka::UploadBatch::command_buffer() const noexcept
+{
+    return this->m_cbo;
+}
+
+constexpr VkFence vka::UploadBatch::fence() const noexcept
+{
+    return this->m_fence.get();
+}
+
+constexpr VkDeviceSize vka::UploadBatch::staging_size() const noexcept
+{
+    return this->m_staging_size;
+}
+
+constexpr bool vka::UploadBatch::submitted() const noexcept
+{
+    return this->m_submitted;
+}
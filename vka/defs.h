@@ -14,6 +14,19 @@
 #include <stdexcept>
 #include <memory>
 #include <fstream>
+#include <filesystem>
+#include <mutex>
+#include <atomic>
+#include <bit>
+#include <algorithm>
+#include <utility>
+#include <future>
+#include <thread>
+#include <span>
+#include <exception>
+#include <cmath>
+#include <limits>
+#include <numeric>
 #include <vulkan/vulkan.h>
 #include "../lib/stb/stb.h"
 
@@ -38,12 +51,46 @@
     #define VKA_X86
 #endif
 
+/// detects SSE2 support, which is part of the X86 64-bit baseline
+#if defined(VKA_X86_64) || (defined(VKA_X86) && defined(__SSE2__))
+    #define VKA_SSE2
+#endif
+
+/// detects SSE4.1 support, requires a compiler flag like -msse4.1 or -march=native
+#if defined(VKA_X86) && defined(__SSE4_1__)
+    #define VKA_SSE4_1
+#endif
+
+/// detects AVX2 support, requires a compiler flag like -mavx2 or -march=native
+#if defined(VKA_X86) && defined(__AVX2__)
+    #define VKA_AVX2
+#endif
+
+/// detects F16C support, requires a compiler flag like -mf16c or -march=native
+#if defined(VKA_X86) && defined(__F16C__)
+    #define VKA_F16C
+#endif
+
+/// detects ARM 64-bit architecture
+#if defined(__aarch64__) || defined(_M_ARM64)
+    #define VKA_ARM64
+#endif
+
+/// detects NEON support, only on ARM 64-bit architecture which always supports NEON
+#ifdef VKA_ARM64
+    #define VKA_NEON
+#endif
+
 /// ---------------------------------------- Hardware feature dependent includes ---------------------------------------
 
 #ifdef VKA_X86
     #include <x86intrin.h>
 #endif
 
+#ifdef VKA_NEON
+    #include <arm_neon.h>
+#endif
+
 /// --------------------------------------------------- User defines ---------------------------------------------------
 
 /**
@@ -5,7 +5,7 @@ namespace vka::detail::attachment
     struct Handle
     {
         VkImage image;
-        VkDeviceMemory memory;
+        memory::Allocation memory;
         VkImageView view;
 
         explicit constexpr operator bool() const noexcept { return this->image != VK_NULL_HANDLE; }
@@ -5,6 +5,6 @@
 inline void vka::detail::attachment::destroy(VkDevice device, const Handle& handle, const VkAllocationCallbacks* allocator)
 {
     vkDestroyImageView(device, handle.view, allocator);
-    vkFreeMemory(device, handle.memory, allocator);
     vkDestroyImage(device, handle.image, allocator);
+    memory::free(device, handle.memory, allocator);
 }
\ No newline at end of file
@@ -6,11 +6,18 @@ namespace vka::detail::buffer
     struct Handle
     {
         VkBuffer buffer;
-        VkDeviceMemory memory;
+        memory::Allocation memory;
 
         explicit constexpr operator bool() const noexcept { return this->buffer != VK_NULL_HANDLE; }
     };
 
     /// Destroys the buffer and frees the memory.
     inline void destroy(VkDevice device, Handle handle, const VkAllocationCallbacks* allocator);
+
+    /**
+     * Sorts copy regions and merges regions which are adjacent or overlapping in both, the source and the destination
+     * buffer. Such regions have the same distance between their source and destination offsets.
+     * @param regions Regions to merge. Contains the merged regions afterwards.
+     */
+    inline void merge_copies(std::vector<VkBufferCopy>& regions);
 }
\ No newline at end of file
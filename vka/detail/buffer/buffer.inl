@@ -4,6 +4,35 @@
 
 inline void vka::detail::buffer::destroy(VkDevice device, Handle handle, const VkAllocationCallbacks* allocator)
 {
-    vkFreeMemory(device, handle.memory, allocator);
     vkDestroyBuffer(device, handle.buffer, allocator);
-}
\ No newline at end of file
+    memory::free(device, handle.memory, allocator);
+}
+
+inline void vka::detail::buffer::merge_copies(std::vector<VkBufferCopy>& regions)
+{
+    // Regions that can be merged have the same delta and are neighbours after sorting by the destination offset.
+    // The delta wraps around, which still identifies equal deltas.
+    std::sort(regions.begin(), regions.end(), [](const VkBufferCopy& a, const VkBufferCopy& b) {
+        const VkDeviceSize delta_a = a.srcOffset - a.dstOffset;
+        const VkDeviceSize delta_b = b.srcOffset - b.dstOffset;
+        return delta_a != delta_b ? delta_a < delta_b : a.dstOffset < b.dstOffset;
+    });
+
+    size_t count = 0;
+    for (const VkBufferCopy& region : regions)
+    {
+        if (region.size == 0)
+            continue;
+        if (count > 0)
+        {
+            VkBufferCopy& last = regions[count - 1];
+            if (last.srcOffset - last.dstOffset == region.srcOffset - region.dstOffset && region.dstOffset <= last.dstOffset + last.size)
+            {
+                last.size = std::max(last.size, region.dstOffset + region.size - last.dstOffset);
+                continue;
+            }
+        }
+        regions[count++] = region;
+    }
+    regions.resize(count);
+}
@@ -14,6 +14,7 @@ namespace vka::detail::descriptor
     {
         VkDevice device;
         VkDescriptorPool pool;
+        bool free_sets;     // false, if the sets are released by resetting the pool
     };
 
     struct Handle
@@ -24,7 +25,7 @@ namespace vka::detail::descriptor
         explicit constexpr operator bool() const noexcept { return this->sets != nullptr; }
     };
 
-    /// Frees the descriptor sets.
+    /// Frees the descriptor sets, unless they are released by resetting the pool.
     inline void destroy(Parent parent, Handle handle, const VkAllocationCallbacks* allocator);
 
     /**
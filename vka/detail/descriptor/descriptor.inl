@@ -12,7 +12,8 @@
 
 inline void vka::detail::descriptor::destroy(Parent parent, Handle handle, const VkAllocationCallbacks* allocator)
 {
-    vkFreeDescriptorSets(parent.device, parent.pool, handle.count, handle.sets);
+    if (parent.free_sets)
+        vkFreeDescriptorSets(parent.device, parent.pool, handle.count, handle.sets);
     delete[] handle.sets;
 }
 
@@ -14,6 +14,7 @@
 #include "instance/instance.h"
 #include "device/device.h"
 #include "queue/queue.inl"
+#include "memory/memory.inl"
 #include "buffer/buffer.inl"
 #include "attachment/attachment.inl"
 #include "texture/texture.inl"
@@ -179,6 +179,7 @@ namespace vka::detail::handle
     template<> struct destroy_func<VkAccelerationStructureKHR>      { static constexpr auto func = vkDestroyAccelerationStructureKHR;       };
 
     // custom handles
+    template<> struct destroy_func<memory::Allocation>              { static constexpr auto func = memory::free;                            };
     template<> struct destroy_func<buffer::Handle>                  { static constexpr auto func = buffer::destroy;                         };
     template<> struct destroy_func<attachment::Handle>              { static constexpr auto func = attachment::destroy;                     };
     template<> struct destroy_func<texture::Handle>                 { static constexpr auto func = texture::destroy;                        };
@@ -0,0 +1,305 @@
+/**
+ * @brief Implementation details for device memory and the memory allocator.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+vka::detail::memory::Block::Block(Pool* pool, VkDeviceMemory memory, VkDeviceSize size) :
+    m_pool(pool),
+    m_memory(memory),
+    m_size(size),
+    m_used(0),
+    m_allocation_count(0),
+    m_map_count(0),
+    m_map(nullptr),
+    m_fl_bitmap(0),
+    m_sl_bitmap{}
+{
+    for (uint32_t fl = 0; fl < FL_COUNT; fl++)
+    {
+        for (uint32_t sl = 0; sl < SL_COUNT; sl++)
+            this->m_heads[fl][sl] = NPOS;
+    }
+    this->m_nodes.reserve(16);
+    this->m_unused.reserve(16);
+    this->insert_free(this->create_node(0, size, NPOS, NPOS));
+}
+
+uint32_t vka::detail::memory::Block::allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+{
+    // An allocation splits a free region into at most 3 regions. Reserve the nodes in advance, so that the free lists
+    // are never left in an inconsistent state if reserving throws.
+    if (this->m_unused.size() < 2 && this->m_nodes.size() + 2 > this->m_nodes.capacity())
+    {
+        this->m_nodes.reserve(2 * this->m_nodes.capacity());
+        this->m_unused.reserve(this->m_nodes.capacity());
+    }
+
+    // The first free region that is found may be too small after aligning its offset. In that case, a region is
+    // searched which is large enough for any alignment.
+    uint32_t n = this->find_free(size);
+    if (n != NPOS && align_up(this->m_nodes[n].offset, alignment) + size > this->m_nodes[n].offset + this->m_nodes[n].size)
+        n = this->find_free(size + alignment - 1);
+    if (n == NPOS)
+        return NPOS;
+    this->remove_free(n);
+
+    // Split off the padding in front of the aligned offset. The previous region must be in use, because free regions
+    // are always merged.
+    const VkDeviceSize aligned = align_up(this->m_nodes[n].offset, alignment);
+    const VkDeviceSize padding = aligned - this->m_nodes[n].offset;
+    if (padding > 0)
+    {
+        const uint32_t prev = this->m_nodes[n].prev_phys;
+        const uint32_t p = this->create_node(this->m_nodes[n].offset, padding, prev, n);
+        if (prev != NPOS)
+            this->m_nodes[prev].next_phys = p;
+        this->m_nodes[n].prev_phys = p;
+        this->m_nodes[n].offset = aligned;
+        this->m_nodes[n].size -= padding;
+        this->insert_free(p);
+    }
+
+    // Split off the remaining space behind the allocation.
+    const VkDeviceSize remaining = this->m_nodes[n].size - size;
+    if (remaining > 0)
+    {
+        const uint32_t next = this->m_nodes[n].next_phys;
+        const uint32_t r = this->create_node(aligned + size, remaining, n, next);
+        if (next != NPOS)
+            this->m_nodes[next].prev_phys = r;
+        this->m_nodes[n].next_phys = r;
+        this->m_nodes[n].size = size;
+        this->insert_free(r);
+    }
+
+    this->m_used += size;
+    this->m_allocation_count++;
+    offset = aligned;
+    return n;
+}
+
+void vka::detail::memory::Block::free(uint32_t node) noexcept
+{
+    this->m_used -= this->m_nodes[node].size;
+    this->m_allocation_count--;
+
+    // merge with the previous region
+    const uint32_t prev = this->m_nodes[node].prev_phys;
+    if (prev != NPOS && this->m_nodes[prev].free)
+    {
+        this->remove_free(prev);
+        const uint32_t next = this->m_nodes[node].next_phys;
+        this->m_nodes[prev].size += this->m_nodes[node].size;
+        this->m_nodes[prev].next_phys = next;
+        if (next != NPOS)
+            this->m_nodes[next].prev_phys = prev;
+        this->release_node(node);
+        node = prev;
+    }
+
+    // merge with the next region
+    const uint32_t next = this->m_nodes[node].next_phys;
+    if (next != NPOS && this->m_nodes[next].free)
+    {
+        this->remove_free(next);
+        const uint32_t after = this->m_nodes[next].next_phys;
+        this->m_nodes[node].size += this->m_nodes[next].size;
+        this->m_nodes[node].next_phys = after;
+        if (after != NPOS)
+            this->m_nodes[after].prev_phys = node;
+        this->release_node(next);
+    }
+
+    this->insert_free(node);
+}
+
+VkResult vka::detail::memory::Block::map(VkDevice device, void** data) noexcept
+{
+    if (this->m_map_count == 0)
+    {
+        const VkResult result = vkMapMemory(device, this->m_memory, 0, VK_WHOLE_SIZE, 0, &this->m_map);
+        if (result != VK_SUCCESS) [[unlikely]]
+            return result;
+    }
+    this->m_map_count++;
+    *data = this->m_map;
+    return VK_SUCCESS;
+}
+
+void vka::detail::memory::Block::unmap(VkDevice device) noexcept
+{
+    if (this->m_map_count > 0 && --this->m_map_count == 0)
+    {
+        vkUnmapMemory(device, this->m_memory);
+        this->m_map = nullptr;
+    }
+}
+
+uint32_t vka::detail::memory::Block::create_node(VkDeviceSize offset, VkDeviceSize size, uint32_t prev_phys, uint32_t next_phys)
+{
+    const Node node = {
+        .offset = offset,
+        .size = size,
+        .prev_phys = prev_phys,
+        .next_phys = next_phys,
+        .prev_free = NPOS,
+        .next_free = NPOS,
+        .free = false
+    };
+
+    if (!this->m_unused.empty())
+    {
+        const uint32_t idx = this->m_unused.back();
+        this->m_unused.pop_back();
+        this->m_nodes[idx] = node;
+        return idx;
+    }
+    this->m_nodes.push_back(node);
+    return static_cast<uint32_t>(this->m_nodes.size() - 1);
+}
+
+void vka::detail::memory::Block::release_node(uint32_t node) noexcept
+{
+    // The capacity of the unused list is always at least the capacity of the node list, so this never reallocates.
+    this->m_unused.push_back(node);
+}
+
+void vka::detail::memory::Block::insert_free(uint32_t node) noexcept
+{
+    uint32_t fl, sl;
+    mapping(this->m_nodes[node].size, fl, sl);
+
+    const uint32_t head = this->m_heads[fl][sl];
+    this->m_nodes[node].free = true;
+    this->m_nodes[node].prev_free = NPOS;
+    this->m_nodes[node].next_free = head;
+    if (head != NPOS)
+        this->m_nodes[head].prev_free = node;
+    this->m_heads[fl][sl] = node;
+
+    this->m_sl_bitmap[fl] |= 1u << sl;
+    this->m_fl_bitmap |= 1ull << fl;
+}
+
+void vka::detail::memory::Block::remove_free(uint32_t node) noexcept
+{
+    uint32_t fl, sl;
+    mapping(this->m_nodes[node].size, fl, sl);
+
+    const uint32_t prev = this->m_nodes[node].prev_free;
+    const uint32_t next = this->m_nodes[node].next_free;
+    if (prev != NPOS)
+        this->m_nodes[prev].next_free = next;
+    else
+        this->m_heads[fl][sl] = next;
+    if (next != NPOS)
+        this->m_nodes[next].prev_free = prev;
+    this->m_nodes[node].free = false;
+
+    if (this->m_heads[fl][sl] == NPOS)
+    {
+        this->m_sl_bitmap[fl] &= ~(1u << sl);
+        if (this->m_sl_bitmap[fl] == 0)
+            this->m_fl_bitmap &= ~(1ull << fl);
+    }
+}
+
+uint32_t vka::detail::memory::Block::find_free(VkDeviceSize size) const noexcept
+{
+    if (size > this->m_size) [[unlikely]]
+        return NPOS;
+
+    // Round the size up to the next list, so that every region in the found list is large enough.
+    if (size >= SL_COUNT)
+        size += (1ull << (std::bit_width(size) - 1 - SL_LOG2)) - 1;
+
+    uint32_t fl, sl;
+    mapping(size, fl, sl);
+    if (fl >= FL_COUNT) [[unlikely]]
+        return NPOS;
+
+    // search in the current first-level list, otherwise take the smallest non-empty larger first-level list
+    uint32_t sl_map = this->m_sl_bitmap[fl] & (~0u << sl);
+    if (sl_map == 0)
+    {
+        const uint64_t fl_map = fl + 1 < 64 ? this->m_fl_bitmap & (~0ull << (fl + 1)) : 0;
+        if (fl_map == 0)
+            return NPOS;
+        fl = std::countr_zero(fl_map);
+        sl_map = this->m_sl_bitmap[fl];
+    }
+    return this->m_heads[fl][std::countr_zero(sl_map)];
+}
+
+void vka::detail::memory::free(VkDevice device, const Allocation& allocation, const VkAllocationCallbacks* allocator) noexcept
+{
+    if (allocation.tracker != nullptr)
+        allocation.tracker->untrack(allocation);
+
+    if (allocation.block == nullptr)
+    {
+        vkFreeMemory(device, allocation.memory, allocator);
+        if (allocation.pool != nullptr)
+        {
+            std::lock_guard lock(allocation.pool->mutex);
+            allocation.pool->dedicated_count--;
+        }
+        return;
+    }
+
+    Pool* pool = allocation.pool;
+    std::lock_guard lock(pool->mutex);
+    allocation.block->free(allocation.node);
+
+    // One empty block is kept per pool, so that allocating and releasing in a loop does not allocate and free device
+    // memory every time.
+    if (allocation.block->empty())
+    {
+        uint32_t empty_count = 0;
+        for (const std::unique_ptr<Block>& block : pool->blocks)
+            empty_count += block->empty() ? 1 : 0;
+
+        if (empty_count > 1)
+        {
+            for (auto it = pool->blocks.begin(); it != pool->blocks.end(); ++it)
+            {
+                if (it->get() == allocation.block)
+                {
+                    vkFreeMemory(device, allocation.block->memory(), allocator);
+                    pool->blocks.erase(it);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+VkResult vka::detail::memory::map(VkDevice device, const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size, void** data) noexcept
+{
+    if (allocation.block == nullptr)
+        return vkMapMemory(device, allocation.memory, allocation.offset + offset, size, 0, data);
+
+    std::lock_guard lock(allocation.pool->mutex);
+    void* base;
+    const VkResult result = allocation.block->map(device, &base);
+    if (result == VK_SUCCESS) [[likely]]
+        *data = common::add_vp(base, allocation.offset + offset);
+    return result;
+}
+
+void vka::detail::memory::unmap(VkDevice device, const Allocation& allocation) noexcept
+{
+    if (allocation.block == nullptr)
+    {
+        vkUnmapMemory(device, allocation.memory);
+        return;
+    }
+
+    std::lock_guard lock(allocation.pool->mutex);
+    allocation.block->unmap(device);
+}
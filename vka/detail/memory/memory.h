@@ -0,0 +1,184 @@
+/**
+ * @brief Includes implementation details for device memory and the memory allocator.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+namespace vka
+{
+    class MemoryTracker;
+}
+
+namespace vka::detail::memory
+{
+    struct Pool;
+
+    /// Number of second-level lists per first-level list in log2.
+    constexpr uint32_t SL_LOG2 = 5;
+
+    /// Number of second-level lists per first-level list.
+    constexpr uint32_t SL_COUNT = 1 << SL_LOG2;
+
+    /// Number of first-level lists. Sizes below SL_COUNT share list 0, every further power of 2 gets its own list.
+    constexpr uint32_t FL_COUNT = 65 - SL_LOG2;
+
+    /// Region of a memory block which is either free or used by an allocation.
+    struct Node
+    {
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        uint32_t prev_phys;
+        uint32_t next_phys;
+        uint32_t prev_free;
+        uint32_t next_free;
+        bool free;
+    };
+
+    /**
+     * A single <c>VkDeviceMemory</c> which is suballocated with a two-level segregated-fit (TLSF) strategy. Finding
+     * and releasing a region is done in constant time. Free neighbouring regions are merged on release.
+     */
+    class Block final
+    {
+    public:
+        /// Creates a block with a single free region that spans the whole memory.
+        Block(Pool* pool, VkDeviceMemory memory, VkDeviceSize size);
+
+        /**
+         * Suballocates a region from the block.
+         * @param size Size of the region.
+         * @param alignment Alignment of the region's offset, must be a power of 2.
+         * @param offset Returns the offset of the region.
+         * @return Returns the node of the region or <c>vka::NPOS</c>, if there is no free region that is large enough.
+         */
+        uint32_t allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+
+        /// Releases a region that was previously returned by <c>allocate()</c>.
+        void free(uint32_t node) noexcept;
+
+        /// @return Returns the pool to which the block belongs.
+        constexpr Pool* pool() const noexcept;
+
+        /// @return Returns the memory of the block.
+        constexpr VkDeviceMemory memory() const noexcept;
+
+        /// @return Returns the size of the block.
+        constexpr VkDeviceSize size() const noexcept;
+
+        /// @return Returns the number of used bytes.
+        constexpr VkDeviceSize used() const noexcept;
+
+        /// @return Returns the number of regions currently allocated from the block.
+        constexpr uint32_t allocation_count() const noexcept;
+
+        /// @return Returns whether no region is allocated from the block.
+        constexpr bool empty() const noexcept;
+
+        /// Maps the whole block, if not already mapped and increments the map counter.
+        VkResult map(VkDevice device, void** data) noexcept;
+
+        /// Decrements the map counter and unmaps the block if it is no longer used.
+        void unmap(VkDevice device) noexcept;
+
+    private:
+        Pool* m_pool;
+        VkDeviceMemory m_memory;
+        VkDeviceSize m_size;
+        VkDeviceSize m_used;
+        uint32_t m_allocation_count;
+        uint32_t m_map_count;
+        void* m_map;
+        uint64_t m_fl_bitmap;
+        uint32_t m_sl_bitmap[FL_COUNT];
+        uint32_t m_heads[FL_COUNT][SL_COUNT];
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_unused;
+
+        /// Maps a size to its first- and second-level list.
+        static constexpr void mapping(VkDeviceSize size, uint32_t& fl, uint32_t& sl) noexcept;
+
+        /// Creates a new node or recycles an unused one.
+        uint32_t create_node(VkDeviceSize offset, VkDeviceSize size, uint32_t prev_phys, uint32_t next_phys);
+
+        /// Marks a node as unused.
+        void release_node(uint32_t node) noexcept;
+
+        /// Inserts a node into its free list.
+        void insert_free(uint32_t node) noexcept;
+
+        /// Removes a node from its free list.
+        void remove_free(uint32_t node) noexcept;
+
+        /// Finds a free node that is at least as large as the size or returns NPOS.
+        uint32_t find_free(VkDeviceSize size) const noexcept;
+    };
+
+    /// Blocks of the same memory type that are shared between allocations.
+    struct Pool
+    {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Block>> blocks;
+        VkDevice device;
+        VkDeviceSize block_size;
+        uint32_t type_index;
+        uint32_t dedicated_count;
+    };
+
+    /**
+     * Describes a region of device memory. The memory is either suballocated from a block, owned exclusively by the
+     * allocation (dedicated) or owned exclusively without being tracked by an allocator.
+     * Used as a custom handle in <c>unique_handle</c>. Parent: <c>VkDevice</c>.
+     */
+    struct Allocation
+    {
+        VkDeviceMemory memory;
+        VkDeviceSize offset;
+        VkDeviceSize size;
+        Pool* pool;         // nullptr, if not created by an allocator
+        Block* block;       // nullptr, if not suballocated
+        uint32_t node;
+        uint32_t type_index;
+        MemoryTracker* tracker;  // nullptr, if not tracked
+
+        explicit constexpr operator bool() const noexcept { return this->memory != VK_NULL_HANDLE; }
+    };
+
+    /// Aligns an offset up to a power of 2 alignment.
+    constexpr VkDeviceSize align_up(VkDeviceSize offset, VkDeviceSize alignment) noexcept;
+
+    /**
+     * Creates the range of an allocation which is flushed or invalidated. The range is extended to multiples of the
+     * atom size and clamped to the size of the memory.
+     * @param offset Offset relative to the start of the allocation.
+     * @param size Size of the range.
+     * @param atom_size <c>VkPhysicalDeviceLimits::nonCoherentAtomSize</c>. If it is <c>0</c>, the whole memory is
+     * used.
+     */
+    constexpr VkMappedMemoryRange make_range(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size, VkDeviceSize atom_size) noexcept;
+
+    /**
+     * Scores how well a memory type matches the requested flags. Every preferred flag weighs more than all unrequested
+     * flags together, e.g. <c>VK_MEMORY_PROPERTY_HOST_CACHED_BIT</c> is only chosen if it is requested or there is no
+     * other choice. Protected memory is never used, unless it is requested.
+     * @param flags Property flags of the memory type.
+     * @return Returns the score of the memory type or <c>-1</c>, if it is unsuitable.
+     */
+    constexpr int32_t score_type(VkMemoryPropertyFlags flags, VkMemoryPropertyFlags req_flags, VkMemoryPropertyFlags pref_flags, VkMemoryPropertyFlags forb_flags) noexcept;
+
+    /// Releases an allocation. Suballocations are returned to their block, any other memory is freed.
+    void free(VkDevice device, const Allocation& allocation, const VkAllocationCallbacks* allocator) noexcept;
+
+    /**
+     * Maps a region of an allocation. Blocks are mapped as a whole and shared between all their allocations.
+     * @param offset Offset relative to the start of the allocation.
+     * @param size Size of the region to map.
+     */
+    VkResult map(VkDevice device, const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size, void** data) noexcept;
+
+    /// Unmaps an allocation that has been mapped by <c>map()</c>.
+    void unmap(VkDevice device, const Allocation& allocation) noexcept;
+}
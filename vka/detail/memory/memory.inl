@@ -0,0 +1,95 @@
+/**
+ * @brief Inline implementation details for device memory and the memory allocator.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#pragma once
+
+#include "memory.h"
+
+constexpr vka::detail::memory::Pool* vka::detail::memory::Block::pool() const noexcept
+{
+    return this->m_pool;
+}
+
+constexpr VkDeviceMemory vka::detail::memory::Block::memory() const noexcept
+{
+    return this->m_memory;
+}
+
+constexpr VkDeviceSize vka::detail::memory::Block::size() const noexcept
+{
+    return this->m_size;
+}
+
+constexpr VkDeviceSize vka::detail::memory::Block::used() const noexcept
+{
+    return this->m_used;
+}
+
+constexpr uint32_t vka::detail::memory::Block::allocation_count() const noexcept
+{
+    return this->m_allocation_count;
+}
+
+constexpr bool vka::detail::memory::Block::empty() const noexcept
+{
+    return this->m_allocation_count == 0;
+}
+
+constexpr void vka::detail::memory::Block::mapping(VkDeviceSize size, uint32_t& fl, uint32_t& sl) noexcept
+{
+    if (size < SL_COUNT)
+    {
+        fl = 0;
+        sl = static_cast<uint32_t>(size);
+    }
+    else
+    {
+        // The first level is the position of the highest set bit, the second level are the next SL_LOG2 bits.
+        const uint32_t l = std::bit_width(size) - 1;
+        fl = l - SL_LOG2 + 1;
+        sl = static_cast<uint32_t>(size >> (l - SL_LOG2)) ^ SL_COUNT;
+    }
+}
+
+constexpr VkDeviceSize vka::detail::memory::align_up(VkDeviceSize offset, VkDeviceSize alignment) noexcept
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+constexpr VkMappedMemoryRange vka::detail::memory::make_range(const Allocation& allocation, VkDeviceSize offset, VkDeviceSize size, VkDeviceSize atom_size) noexcept
+{
+    VkMappedMemoryRange range = {
+        .sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+        .pNext = nullptr,
+        .memory = allocation.memory,
+        .offset = 0,
+        .size = VK_WHOLE_SIZE
+    };
+    if (atom_size == 0)
+        return range;
+
+    // A range must either end at a multiple of the atom size or at the end of the memory.
+    const VkDeviceSize memory_size = allocation.block != nullptr ? allocation.block->size() : allocation.offset + allocation.size;
+    const VkDeviceSize begin = (allocation.offset + offset) & ~(atom_size - 1);
+    const VkDeviceSize end = align_up(allocation.offset + offset + size, atom_size);
+    range.offset = begin;
+    range.size = (end < memory_size ? end : memory_size) - begin;
+    return range;
+}
+
+constexpr int32_t vka::detail::memory::score_type(VkMemoryPropertyFlags flags, VkMemoryPropertyFlags req_flags, VkMemoryPropertyFlags pref_flags, VkMemoryPropertyFlags forb_flags) noexcept
+{
+    if ((req_flags & VK_MEMORY_PROPERTY_PROTECTED_BIT) == 0 && (pref_flags & VK_MEMORY_PROPERTY_PROTECTED_BIT) == 0)
+        forb_flags |= VK_MEMORY_PROPERTY_PROTECTED_BIT;
+    if ((flags & req_flags) != req_flags || (flags & forb_flags) != 0)
+        return -1;
+
+    const int32_t preferred = std::popcount(flags & pref_flags);
+    const int32_t unrequested = std::popcount(flags & ~(req_flags | pref_flags));
+    return preferred * 64 + (32 - unrequested);
+}
@@ -0,0 +1,1181 @@
+/**
+ * @brief Implementation details for textures, contains the destruction of texture handles, the block encoders and
+ * the loader's page reservation.
+ * @author GitHub: R-Michi
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <vka/vka.h>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+#endif
+
+namespace
+{
+    /// Pixels of a 4x4 block in structure-of-arrays layout, one array per RGBA channel.
+    struct BlockPixels
+    {
+        alignas(16) float c[4][16];
+    };
+
+    /// Palette of a block with up to 16 RGBA entries.
+    struct BlockPalette
+    {
+        float c[16][4];
+        uint32_t count;
+    };
+
+    /// Interpolation weights of BC7 with 4-bit indices, in 1/64.
+    constexpr int32_t BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    /// Number of least-squares refinements of the endpoints in high quality mode.
+    constexpr uint32_t REFINE_ITERATIONS = 2;
+
+    /**
+     * Selects the nearest palette entry for every pixel, only the channels <c>[first, last)</c> are compared.
+     * @return Returns the summed squared error.
+     */
+    float select_indices(const BlockPixels& px, const BlockPalette& pal, uint32_t first, uint32_t last, uint8_t* indices) noexcept
+    {
+        float total = 0.0f;
+#if defined(VKA_SSE2)
+        for (uint32_t i = 0; i < 16; i += 4)
+        {
+            __m128 best = _mm_set1_ps(std::numeric_limits<float>::max());
+            __m128i best_idx = _mm_setzero_si128();
+            for (uint32_t e = 0; e < pal.count; e++)
+            {
+                __m128 d = _mm_setzero_ps();
+                for (uint32_t c = first; c < last; c++)
+                {
+                    const __m128 diff = _mm_sub_ps(_mm_load_ps(px.c[c] + i), _mm_set1_ps(pal.c[e][c]));
+                    d = _mm_add_ps(d, _mm_mul_ps(diff, diff));
+                }
+                const __m128i mask = _mm_castps_si128(_mm_cmplt_ps(d, best));
+                best = _mm_min_ps(d, best);
+                best_idx = _mm_or_si128(_mm_and_si128(mask, _mm_set1_epi32((int32_t)e)), _mm_andnot_si128(mask, best_idx));
+            }
+            alignas(16) int32_t idx[4];
+            alignas(16) float err[4];
+            _mm_store_si128((__m128i*)idx, best_idx);
+            _mm_store_ps(err, best);
+            for (uint32_t k = 0; k < 4; k++)
+            {
+                indices[i + k] = (uint8_t)idx[k];
+                total += err[k];
+            }
+        }
+#elif defined(VKA_NEON)
+        for (uint32_t i = 0; i < 16; i += 4)
+        {
+            float32x4_t best = vdupq_n_f32(std::numeric_limits<float>::max());
+            uint32x4_t best_idx = vdupq_n_u32(0);
+            for (uint32_t e = 0; e < pal.count; e++)
+            {
+                float32x4_t d = vdupq_n_f32(0.0f);
+                for (uint32_t c = first; c < last; c++)
+                {
+                    const float32x4_t diff = vsubq_f32(vld1q_f32(px.c[c] + i), vdupq_n_f32(pal.c[e][c]));
+                    d = vmlaq_f32(d, diff, diff);
+                }
+                const uint32x4_t mask = vcltq_f32(d, best);
+                best = vminq_f32(d, best);
+                best_idx = vbslq_u32(mask, vdupq_n_u32(e), best_idx);
+            }
+            uint32_t idx[4];
+            float err[4];
+            vst1q_u32(idx, best_idx);
+            vst1q_f32(err, best);
+            for (uint32_t k = 0; k < 4; k++)
+            {
+                indices[i + k] = (uint8_t)idx[k];
+                total += err[k];
+            }
+        }
+#else
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            float best = std::numeric_limits<float>::max();
+            for (uint32_t e = 0; e < pal.count; e++)
+            {
+                float d = 0.0f;
+                for (uint32_t c = first; c < last; c++)
+                    d += (px.c[c][i] - pal.c[e][c]) * (px.c[c][i] - pal.c[e][c]);
+                if (d < best)
+                {
+                    best = d;
+                    indices[i] = (uint8_t)e;
+                }
+            }
+            total += best;
+        }
+#endif
+        return total;
+    }
+
+    /// Computes the endpoints along the principal axis of the channels <c>[first, last)</c>.
+    void principal_endpoints(const BlockPixels& px, uint32_t first, uint32_t last, float* e0, float* e1) noexcept
+    {
+        float mean[4] = {};
+        for (uint32_t c = first; c < last; c++)
+        {
+            for (uint32_t i = 0; i < 16; i++)
+                mean[c] += px.c[c][i];
+            mean[c] *= 1.0f / 16.0f;
+        }
+
+        float cov[4][4] = {};
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            for (uint32_t a = first; a < last; a++)
+            {
+                for (uint32_t b = first; b < last; b++)
+                    cov[a][b] += (px.c[a][i] - mean[a]) * (px.c[b][i] - mean[b]);
+            }
+        }
+
+        // Power iteration, starting at the row of the channel with the largest variance.
+        uint32_t max_c = first;
+        for (uint32_t c = first; c < last; c++)
+            max_c = cov[c][c] > cov[max_c][max_c] ? c : max_c;
+        float axis[4] = {};
+        for (uint32_t c = first; c < last; c++)
+            axis[c] = cov[max_c][c];
+        for (uint32_t it = 0; it < 8; it++)
+        {
+            float next[4] = {};
+            float length = 0.0f;
+            for (uint32_t a = first; a < last; a++)
+            {
+                for (uint32_t b = first; b < last; b++)
+                    next[a] += cov[a][b] * axis[b];
+                length += next[a] * next[a];
+            }
+            length = std::sqrt(length);
+            for (uint32_t c = first; c < last; c++)
+                axis[c] = length > 1e-12f ? next[c] / length : 0.0f;
+        }
+
+        float t_min = 0.0f, t_max = 0.0f;
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            float t = 0.0f;
+            for (uint32_t c = first; c < last; c++)
+                t += (px.c[c][i] - mean[c]) * axis[c];
+            t_min = std::min(t_min, t);
+            t_max = std::max(t_max, t);
+        }
+        for (uint32_t c = first; c < last; c++)
+        {
+            e0[c] = std::clamp(mean[c] + t_min * axis[c], 0.0f, 255.0f);
+            e1[c] = std::clamp(mean[c] + t_max * axis[c], 0.0f, 255.0f);
+        }
+    }
+
+    /**
+     * Computes the endpoints which minimize the squared error for the given indices, <c>weights[index]</c> is the
+     * interpolation weight of the second endpoint.
+     * @return Returns false, if the system is degenerate and the endpoints are unchanged.
+     */
+    bool refine_endpoints(const BlockPixels& px, const uint8_t* indices, const float* weights, uint32_t first, uint32_t last, float* e0, float* e1) noexcept
+    {
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float xa[4] = {}, xb[4] = {};
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            const float w = weights[indices[i]];
+            aa += (1.0f - w) * (1.0f - w);
+            ab += (1.0f - w) * w;
+            bb += w * w;
+            for (uint32_t c = first; c < last; c++)
+            {
+                xa[c] += (1.0f - w) * px.c[c][i];
+                xb[c] += w * px.c[c][i];
+            }
+        }
+        const float det = aa * bb - ab * ab;
+        if (std::abs(det) < 1e-6f)
+            return false;
+        for (uint32_t c = first; c < last; c++)
+        {
+            e0[c] = std::clamp((bb * xa[c] - ab * xb[c]) / det, 0.0f, 255.0f);
+            e1[c] = std::clamp((aa * xb[c] - ab * xa[c]) / det, 0.0f, 255.0f);
+        }
+        return true;
+    }
+
+    inline uint16_t pack565(const float* c) noexcept
+    {
+        const uint32_t r = (uint32_t)(c[0] * (31.0f / 255.0f) + 0.5f);
+        const uint32_t g = (uint32_t)(c[1] * (63.0f / 255.0f) + 0.5f);
+        const uint32_t b = (uint32_t)(c[2] * (31.0f / 255.0f) + 0.5f);
+        return (uint16_t)(r << 11 | g << 5 | b);
+    }
+
+    inline void unpack565(uint16_t v, float* c) noexcept
+    {
+        const uint32_t r = v >> 11 & 0x1F, g = v >> 5 & 0x3F, b = v & 0x1F;
+        c[0] = (float)(r << 3 | r >> 2);
+        c[1] = (float)(g << 2 | g >> 4);
+        c[2] = (float)(b << 3 | b >> 2);
+        c[3] = 0.0f;
+    }
+
+    /// Writes <c>count</c> indices of <c>bits</c> bits each, little endian.
+    inline void write_indices(uint8_t* dst, const uint8_t* indices, uint32_t bits) noexcept
+    {
+        uint64_t packed = 0;
+        for (uint32_t i = 0; i < 16; i++)
+            packed |= (uint64_t)indices[i] << (i * bits);
+        for (uint32_t i = 0; i < 2 * bits; i++)
+            dst[i] = (uint8_t)(packed >> (8 * i));
+    }
+
+    /**
+     * Encodes the color of a BC1 block. In 4-color mode the first endpoint is greater than the second one. In
+     * punch-through mode, pixels with an alpha below 128 get the transparent index 3 of the 3-color mode.
+     */
+    void encode_bc1(uint8_t* dst, const BlockPixels& block, bool punch_through, bool high_quality) noexcept
+    {
+        BlockPixels px = block;
+        uint32_t transparent = 0;
+        if (punch_through)
+        {
+            // Transparent pixels are moved to the mean of the opaque ones, so that they do not affect the endpoints.
+            float mean[3] = {};
+            uint32_t opaque = 0;
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                if (px.c[3][i] >= 128.0f)
+                {
+                    for (uint32_t c = 0; c < 3; c++)
+                        mean[c] += px.c[c][i];
+                    opaque++;
+                }
+            }
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                if (px.c[3][i] < 128.0f)
+                {
+                    for (uint32_t c = 0; c < 3; c++)
+                        px.c[c][i] = opaque > 0 ? mean[c] / (float)opaque : 0.0f;
+                    transparent |= 1u << i;
+                }
+            }
+        }
+        const bool three_color = transparent != 0;
+
+        // Weights of the second endpoint per index.
+        static constexpr float WEIGHTS4[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        static constexpr float WEIGHTS3[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+        uint16_t best_c0 = 0, best_c1 = 0;
+        uint8_t best_idx[16] = {};
+        float best_err = std::numeric_limits<float>::max();
+        const auto evaluate = [&](const float* a, const float* b) {
+            uint16_t c0 = pack565(a), c1 = pack565(b);
+            if (three_color ? c0 > c1 : c0 < c1)
+                std::swap(c0, c1);
+            BlockPalette pal;
+            unpack565(c0, pal.c[0]);
+            unpack565(c1, pal.c[1]);
+            for (uint32_t c = 0; c < 3; c++)
+            {
+                pal.c[2][c] = three_color ? (pal.c[0][c] + pal.c[1][c]) * 0.5f : (2.0f * pal.c[0][c] + pal.c[1][c]) / 3.0f;
+                pal.c[3][c] = (pal.c[0][c] + 2.0f * pal.c[1][c]) / 3.0f;
+            }
+            // Equal endpoints select the 3-color mode, where only the first entries are valid.
+            pal.count = three_color ? 3 : (c0 == c1 ? 1 : 4);
+            uint8_t idx[16];
+            const float err = select_indices(px, pal, 0, 3, idx);
+            if (err < best_err)
+            {
+                best_err = err;
+                best_c0 = c0;
+                best_c1 = c1;
+                memcpy(best_idx, idx, sizeof(idx));
+            }
+        };
+
+        float e0[4], e1[4];
+        principal_endpoints(px, 0, 3, e0, e1);
+        evaluate(e1, e0);
+        for (uint32_t it = 0; high_quality && it < REFINE_ITERATIONS; it++)
+        {
+            float a[4], b[4];
+            unpack565(best_c0, a);
+            unpack565(best_c1, b);
+            if (!refine_endpoints(px, best_idx, three_color ? WEIGHTS3 : WEIGHTS4, 0, 3, a, b))
+                break;
+            evaluate(a, b);
+        }
+
+        if (transparent == 0xFFFF)
+            best_c0 = best_c1 = 0;
+        for (uint32_t i = 0; i < 16; i++)
+            best_idx[i] = (transparent >> i & 1) != 0 ? 3 : best_idx[i];
+        dst[0] = (uint8_t)best_c0;
+        dst[1] = (uint8_t)(best_c0 >> 8);
+        dst[2] = (uint8_t)best_c1;
+        dst[3] = (uint8_t)(best_c1 >> 8);
+        write_indices(dst + 4, best_idx, 2);
+    }
+
+    /// Encodes a single channel of a block into a BC4 block.
+    void encode_bc4(uint8_t* dst, const BlockPixels& px, uint32_t channel, bool high_quality) noexcept
+    {
+        float lo = 255.0f, hi = 0.0f, lo_inner = 255.0f, hi_inner = 0.0f;
+        for (uint32_t i = 0; i < 16; i++)
+        {
+            const float v = px.c[channel][i];
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+            if (v > 0.0f && v < 255.0f)
+            {
+                lo_inner = std::min(lo_inner, v);
+                hi_inner = std::max(hi_inner, v);
+            }
+        }
+
+        uint8_t best_r0 = 0, best_r1 = 0;
+        uint8_t best_idx[16] = {};
+        float best_err = std::numeric_limits<float>::max();
+        const auto evaluate = [&](int32_t r0, int32_t r1) {
+            BlockPalette pal;
+            pal.c[0][channel] = (float)r0;
+            pal.c[1][channel] = (float)r1;
+            if (r0 > r1)
+            {
+                for (uint32_t i = 2; i < 8; i++)
+                    pal.c[i][channel] = ((float)(8 - i) * (float)r0 + (float)(i - 1) * (float)r1) / 7.0f;
+                pal.count = 8;
+            }
+            else
+            {
+                for (uint32_t i = 2; i < 6; i++)
+                    pal.c[i][channel] = ((float)(6 - i) * (float)r0 + (float)(i - 1) * (float)r1) / 5.0f;
+                pal.c[6][channel] = 0.0f;
+                pal.c[7][channel] = 255.0f;
+                pal.count = 8;
+            }
+            uint8_t idx[16];
+            const float err = select_indices(px, pal, channel, channel + 1, idx);
+            if (err < best_err)
+            {
+                best_err = err;
+                best_r0 = (uint8_t)r0;
+                best_r1 = (uint8_t)r1;
+                memcpy(best_idx, idx, sizeof(idx));
+            }
+        };
+
+        const int32_t r_hi = (int32_t)(hi + 0.5f), r_lo = (int32_t)(lo + 0.5f);
+        if (r_hi == r_lo)
+        {
+            // Both endpoints are equal, so that the 6-value mode with index 0 reproduces the value.
+            evaluate(r_hi, r_lo);
+        }
+        else if (!high_quality)
+        {
+            evaluate(r_hi, r_lo);
+        }
+        else
+        {
+            // Insetting the endpoints reduces the error of the interpolated values.
+            for (int32_t d0 = 0; d0 < 4; d0++)
+            {
+                for (int32_t d1 = 0; d1 < 4; d1++)
+                {
+                    if (r_hi - d0 > r_lo + d1)
+                        evaluate(r_hi - d0, r_lo + d1);
+                }
+            }
+            // The 6-value mode represents 0 and 255 exactly, which suits blocks with extreme values.
+            if (lo_inner <= hi_inner && (lo == 0.0f || hi == 255.0f))
+                evaluate((int32_t)(lo_inner + 0.5f), (int32_t)(hi_inner + 0.5f));
+        }
+
+        dst[0] = best_r0;
+        dst[1] = best_r1;
+        write_indices(dst + 2, best_idx, 3);
+    }
+
+    /**
+     * Encodes a block with BC7 mode 6, which has a single subset with 7-bit RGBA endpoints, a p-bit per endpoint and
+     * 4-bit indices.
+     */
+    void encode_bc7(uint8_t* dst, const BlockPixels& px, bool high_quality) noexcept
+    {
+        static constexpr float WEIGHTS[16] = {
+            0.0f / 64.0f, 4.0f / 64.0f, 9.0f / 64.0f, 13.0f / 64.0f, 17.0f / 64.0f, 21.0f / 64.0f, 26.0f / 64.0f, 30.0f / 64.0f,
+            34.0f / 64.0f, 38.0f / 64.0f, 43.0f / 64.0f, 47.0f / 64.0f, 51.0f / 64.0f, 55.0f / 64.0f, 60.0f / 64.0f, 64.0f / 64.0f
+        };
+
+        uint8_t best_q[2][4] = {};
+        uint8_t best_p[2] = {};
+        uint8_t best_idx[16] = {};
+        float best_err = std::numeric_limits<float>::max();
+        const auto evaluate = [&](const float* a, const float* b) {
+            // Every combination of p-bits is tried, because they are shared by all channels of an endpoint.
+            for (uint32_t p = 0; p < 4; p++)
+            {
+                const uint8_t pbit[2] = { (uint8_t)(p & 1), (uint8_t)(p >> 1) };
+                uint8_t q[2][4];
+                int32_t end[2][4];
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    q[0][c] = (uint8_t)std::clamp((int32_t)((a[c] - pbit[0]) * 0.5f + 0.5f), 0, 127);
+                    q[1][c] = (uint8_t)std::clamp((int32_t)((b[c] - pbit[1]) * 0.5f + 0.5f), 0, 127);
+                    end[0][c] = q[0][c] << 1 | pbit[0];
+                    end[1][c] = q[1][c] << 1 | pbit[1];
+                }
+                BlockPalette pal;
+                pal.count = 16;
+                for (uint32_t i = 0; i < 16; i++)
+                {
+                    for (uint32_t c = 0; c < 4; c++)
+                        pal.c[i][c] = (float)(((64 - BC7_WEIGHTS[i]) * end[0][c] + BC7_WEIGHTS[i] * end[1][c] + 32) >> 6);
+                }
+                uint8_t idx[16];
+                const float err = select_indices(px, pal, 0, 4, idx);
+                if (err < best_err)
+                {
+                    best_err = err;
+                    memcpy(best_q, q, sizeof(q));
+                    best_p[0] = pbit[0];
+                    best_p[1] = pbit[1];
+                    memcpy(best_idx, idx, sizeof(idx));
+                }
+            }
+        };
+
+        float e0[4], e1[4];
+        principal_endpoints(px, 0, 4, e0, e1);
+        evaluate(e0, e1);
+        for (uint32_t it = 0; high_quality && it < REFINE_ITERATIONS; it++)
+        {
+            if (!refine_endpoints(px, best_idx, WEIGHTS, 0, 4, e0, e1))
+                break;
+            evaluate(e0, e1);
+        }
+
+        // The most significant index bit of the first pixel is implicitly 0, which is achieved by swapping endpoints.
+        if (best_idx[0] >= 8)
+        {
+            for (uint32_t c = 0; c < 4; c++)
+                std::swap(best_q[0][c], best_q[1][c]);
+            std::swap(best_p[0], best_p[1]);
+            for (uint8_t& idx : best_idx)
+                idx = (uint8_t)(15 - idx);
+        }
+
+        uint64_t bits[2] = {};
+        uint32_t pos = 0;
+        const auto put = [&](uint64_t value, uint32_t count) {
+            for (uint32_t i = 0; i < count; i++, pos++)
+                bits[pos / 64] |= (value >> i & 1) << (pos % 64);
+        };
+        put(1 << 6, 7);
+        for (uint32_t c = 0; c < 4; c++)
+        {
+            put(best_q[0][c], 7);
+            put(best_q[1][c], 7);
+        }
+        put(best_p[0], 1);
+        put(best_p[1], 1);
+        put(best_idx[0], 3);
+        for (uint32_t i = 1; i < 16; i++)
+            put(best_idx[i], 4);
+        for (uint32_t i = 0; i < 16; i++)
+            dst[i] = (uint8_t)(bits[i / 8] >> (8 * (i % 8)));
+    }
+
+    /// Gathers a 4x4 block, pixels outside the image replicate the edge. Missing components are 0, alpha is 255.
+    void gather_block(BlockPixels& px, const uint8_t* src, VkExtent2D extent, uint32_t components, uint32_t bx, uint32_t by) noexcept
+    {
+        for (uint32_t y = 0; y < 4; y++)
+        {
+            const uint32_t sy = std::min(by * 4 + y, extent.height - 1);
+            for (uint32_t x = 0; x < 4; x++)
+            {
+                const uint32_t sx = std::min(bx * 4 + x, extent.width - 1);
+                const uint8_t* const p = src + ((size_t)sy * extent.width + sx) * components;
+                for (uint32_t c = 0; c < 4; c++)
+                    px.c[c][y * 4 + x] = c < components ? (float)p[c] : (c == 3 ? 255.0f : 0.0f);
+            }
+        }
+    }
+
+    /// Kinds of target formats of the texel conversion.
+    enum class ConvertKind
+    {
+        NONE,
+        UNORM8,
+        SRGB8,
+        UNORM16,
+        HALF,
+        B10G11R11,
+        E5B9G9R9
+    };
+
+    /// Target format of the texel conversion and its number of components.
+    struct ConvertTarget
+    {
+        ConvertKind kind;
+        uint32_t components;
+    };
+
+    /// Number of pixels which are converted through the float intermediate at once.
+    constexpr uint32_t CONVERT_CHUNK = 1024;
+
+    /// @return Returns the target of a format, whose kind is <c>NONE</c> if the format is not supported.
+    ConvertTarget convert_target(VkFormat format) noexcept
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R8_UNORM:                    return { ConvertKind::UNORM8, 1 };
+        case VK_FORMAT_R8G8_UNORM:                  return { ConvertKind::UNORM8, 2 };
+        case VK_FORMAT_R8G8B8_UNORM:                return { ConvertKind::UNORM8, 3 };
+        case VK_FORMAT_R8G8B8A8_UNORM:              return { ConvertKind::UNORM8, 4 };
+        case VK_FORMAT_R8_SRGB:                     return { ConvertKind::SRGB8, 1 };
+        case VK_FORMAT_R8G8_SRGB:                   return { ConvertKind::SRGB8, 2 };
+        case VK_FORMAT_R8G8B8_SRGB:                 return { ConvertKind::SRGB8, 3 };
+        case VK_FORMAT_R8G8B8A8_SRGB:               return { ConvertKind::SRGB8, 4 };
+        case VK_FORMAT_R16_UNORM:                   return { ConvertKind::UNORM16, 1 };
+        case VK_FORMAT_R16G16_UNORM:                return { ConvertKind::UNORM16, 2 };
+        case VK_FORMAT_R16G16B16_UNORM:             return { ConvertKind::UNORM16, 3 };
+        case VK_FORMAT_R16G16B16A16_UNORM:          return { ConvertKind::UNORM16, 4 };
+        case VK_FORMAT_R16_SFLOAT:                  return { ConvertKind::HALF, 1 };
+        case VK_FORMAT_R16G16_SFLOAT:               return { ConvertKind::HALF, 2 };
+        case VK_FORMAT_R16G16B16_SFLOAT:            return { ConvertKind::HALF, 3 };
+        case VK_FORMAT_R16G16B16A16_SFLOAT:         return { ConvertKind::HALF, 4 };
+        case VK_FORMAT_B10G11R11_UFLOAT_PACK32:     return { ConvertKind::B10G11R11, 3 };
+        case VK_FORMAT_E5B9G9R9_UFLOAT_PACK32:      return { ConvertKind::E5B9G9R9, 3 };
+        default:                                    return { ConvertKind::NONE, 0 };
+        }
+    }
+
+    /// Converts a float to a half float with round-to-nearest-even, NaN and infinity are preserved.
+    uint16_t float_to_half(float v) noexcept
+    {
+        constexpr uint32_t F16_MAX = (127 + 16) << 23;
+        constexpr uint32_t MIN_NORMAL = (127 - 14) << 23;
+        constexpr uint32_t SUBNORMAL_MAGIC = ((127 - 15) + (23 - 10) + 1) << 23;
+
+        uint32_t f = std::bit_cast<uint32_t>(v);
+        const uint32_t sign = f & 0x80000000u;
+        f ^= sign;
+
+        uint32_t h;
+        if (f >= F16_MAX)
+        {
+            h = f > 0x7F800000u ? 0x7E00u : 0x7C00u;
+        }
+        else if (f < MIN_NORMAL)
+        {
+            // The addition shifts the mantissa into place and rounds it.
+            h = std::bit_cast<uint32_t>(std::bit_cast<float>(f) + std::bit_cast<float>(SUBNORMAL_MAGIC)) - SUBNORMAL_MAGIC;
+        }
+        else
+        {
+            const uint32_t mantissa_odd = (f >> 13) & 1;
+            h = (f + (0xFFFu - ((127u - 15u) << 23)) + mantissa_odd) >> 13;
+        }
+        return (uint16_t)(h | (sign >> 16));
+    }
+
+#if defined(VKA_SSE2)
+    /// Vectorized <c>float_to_half()</c> of 4 floats, the results are in the lower 16 bits sign extended to 32 bits.
+    __m128i float_to_half_sse2(__m128 v) noexcept
+    {
+        const __m128i f16_max = _mm_set1_epi32((127 + 16) << 23);
+        const __m128i min_normal = _mm_set1_epi32((127 - 14) << 23);
+        const __m128i subnormal_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+        const __m128i normal_bias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+        const __m128 sign = _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32((int32_t)0x80000000u)));
+        const __m128 abs = _mm_xor_ps(v, sign);
+        const __m128i abs_int = _mm_castps_si128(abs);
+
+        // NaN and infinity
+        const __m128i is_regular = _mm_cmpgt_epi32(f16_max, abs_int);
+        const __m128i nan_bit = _mm_and_si128(_mm_castps_si128(_mm_cmpunord_ps(abs, abs)), _mm_set1_epi32(0x200));
+        const __m128i special = _mm_or_si128(nan_bit, _mm_set1_epi32(0x7C00));
+
+        // subnormal and normal results
+        const __m128i is_subnormal = _mm_cmpgt_epi32(min_normal, abs_int);
+        const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(abs, _mm_castsi128_ps(subnormal_magic))), subnormal_magic);
+        const __m128i mantissa_odd = _mm_srai_epi32(_mm_slli_epi32(abs_int, 31 - 13), 31);
+        const __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(abs_int, normal_bias), mantissa_odd), 13);
+
+        const __m128i regular = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal), _mm_andnot_si128(is_subnormal, normal));
+        const __m128i joined = _mm_or_si128(_mm_and_si128(is_regular, regular), _mm_andnot_si128(is_regular, special));
+
+        // The arithmetic shift sign extends, so that the results can be packed with signed saturation.
+        return _mm_or_si128(joined, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+    }
+#endif
+
+    /// Converts <c>count</c> floats to half floats.
+    void floats_to_halfs(uint16_t* dst, const float* src, uint64_t count) noexcept
+    {
+        uint64_t i = 0;
+#if defined(VKA_F16C)
+        for (; i + 8 <= count; i += 8)
+            _mm_storeu_si128((__m128i*)(dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+#elif defined(VKA_SSE2)
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m128i lo = float_to_half_sse2(_mm_loadu_ps(src + i));
+            const __m128i hi = float_to_half_sse2(_mm_loadu_ps(src + i + 4));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(lo, hi));
+        }
+#elif defined(VKA_NEON)
+        for (; i + 4 <= count; i += 4)
+            vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+#endif
+        for (; i < count; i++)
+            dst[i] = float_to_half(src[i]);
+    }
+
+    /// Expands 8-bit to 16-bit unsigned normalized components, which is a multiplication by 257.
+    void expand_unorm8(uint16_t* dst, const uint8_t* src, uint64_t count) noexcept
+    {
+        uint64_t i = 0;
+#if defined(VKA_SSE2)
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_unpacklo_epi8(v, v));
+            _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_unpackhi_epi8(v, v));
+        }
+#elif defined(VKA_NEON)
+        for (; i + 16 <= count; i += 16)
+        {
+            const uint8x16_t v = vld1q_u8(src + i);
+            vst1q_u8((uint8_t*)(dst + i), vzip1q_u8(v, v));
+            vst1q_u8((uint8_t*)(dst + i + 8), vzip2q_u8(v, v));
+        }
+#endif
+        for (; i < count; i++)
+            dst[i] = (uint16_t)(src[i] * 257u);
+    }
+
+    /// Narrows 16-bit to 8-bit unsigned normalized components with rounding.
+    void narrow_unorm16(uint8_t* dst, const uint16_t* src, uint64_t count) noexcept
+    {
+        // The division by 65535 is exact as (y + (y >> 16) + 1) >> 16 for every y = x * 255 + 32767.
+        uint64_t i = 0;
+#if defined(VKA_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i bias = _mm_set1_epi32(32767);
+        const __m128i one = _mm_set1_epi32(1);
+        const auto narrow = [&](__m128i x) {
+            const __m128i y = _mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(x, 8), x), bias);
+            return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(y, _mm_srli_epi32(y, 16)), one), 16);
+        };
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i a = _mm_loadu_si128((const __m128i*)(src + i));
+            const __m128i b = _mm_loadu_si128((const __m128i*)(src + i + 8));
+            const __m128i lo = _mm_packs_epi32(narrow(_mm_unpacklo_epi16(a, zero)), narrow(_mm_unpackhi_epi16(a, zero)));
+            const __m128i hi = _mm_packs_epi32(narrow(_mm_unpacklo_epi16(b, zero)), narrow(_mm_unpackhi_epi16(b, zero)));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(lo, hi));
+        }
+#elif defined(VKA_NEON)
+        const uint32x4_t bias = vdupq_n_u32(32767);
+        const auto narrow = [&](uint16x4_t x) {
+            const uint32x4_t y = vmlaq_n_u32(bias, vmovl_u16(x), 255);
+            return vmovn_u32(vshrq_n_u32(vaddq_u32(vaddq_u32(y, vshrq_n_u32(y, 16)), vdupq_n_u32(1)), 16));
+        };
+        for (; i + 8 <= count; i += 8)
+        {
+            const uint16x8_t x = vld1q_u16(src + i);
+            vst1_u8(dst + i, vmovn_u16(vcombine_u16(narrow(vget_low_u16(x)), narrow(vget_high_u16(x)))));
+        }
+#endif
+        for (; i < count; i++)
+            dst[i] = (uint8_t)((src[i] * 255u + 32767u) / 65535u);
+    }
+
+    /// Converts components of the loader type to normalized floats.
+    void decode_floats(float* dst, const void* src, uint8_t src_type, uint64_t count) noexcept
+    {
+        if (src_type == 0)
+        {
+            const uint8_t* const s = static_cast<const uint8_t*>(src);
+            for (uint64_t i = 0; i < count; i++)
+                dst[i] = (float)s[i] * (1.0f / 255.0f);
+        }
+        else if (src_type == 1)
+        {
+            const uint16_t* const s = static_cast<const uint16_t*>(src);
+            for (uint64_t i = 0; i < count; i++)
+                dst[i] = (float)s[i] * (1.0f / 65535.0f);
+        }
+        else
+        {
+            std::memcpy(dst, src, count * sizeof(float));
+        }
+    }
+
+    /// Rounds and clamps normalized floats to unsigned normalized integers. NaN becomes 0.
+    template<typename T>
+    void encode_unorm(T* dst, const float* src, uint64_t count) noexcept
+    {
+        constexpr float scale = (float)std::numeric_limits<T>::max();
+        uint64_t i = 0;
+#if defined(VKA_SSE2)
+        // The maximum returns its second operand for NaN. 16-bit results are biased into the signed range, because
+        // SSE2 can only pack 32-bit integers with signed saturation.
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 max = _mm_set1_ps(1.0f);
+        const __m128 scale_v = _mm_set1_ps(scale);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const auto encode = [&](const float* p) {
+            const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(p), zero), max);
+            return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale_v), half));
+        };
+        for (; i + 8 <= count; i += 8)
+        {
+            if constexpr (sizeof(T) == 1)
+            {
+                const __m128i packed = _mm_packs_epi32(encode(src + i), encode(src + i + 4));
+                _mm_storel_epi64((__m128i*)(dst + i), _mm_packus_epi16(packed, packed));
+            }
+            else
+            {
+                const __m128i bias = _mm_set1_epi32(32768);
+                const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(encode(src + i), bias), _mm_sub_epi32(encode(src + i + 4), bias));
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(packed, _mm_set1_epi16((int16_t)0x8000)));
+            }
+        }
+#elif defined(VKA_NEON)
+        // The number variants of the minimum and maximum return the number for NaN.
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t max = vdupq_n_f32(1.0f);
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        const auto encode = [&](const float* p) {
+            const float32x4_t v = vminnmq_f32(vmaxnmq_f32(vld1q_f32(p), zero), max);
+            return vmovn_u32(vcvtq_u32_f32(vmlaq_n_f32(half, v, scale)));
+        };
+        for (; i + 8 <= count; i += 8)
+        {
+            const uint16x8_t packed = vcombine_u16(encode(src + i), encode(src + i + 4));
+            if constexpr (sizeof(T) == 1)
+                vst1_u8((uint8_t*)(dst + i), vmovn_u16(packed));
+            else
+                vst1q_u16((uint16_t*)(dst + i), packed);
+        }
+#endif
+        for (; i < count; i++)
+        {
+            const float v = src[i] > 0.0f ? std::min(src[i], 1.0f) : 0.0f;
+            dst[i] = (T)(v * scale + 0.5f);
+        }
+    }
+
+    /// Encodes linear floats as sRGB, the fourth component is alpha and stays linear.
+    void encode_srgb8(uint8_t* dst, const float* src, uint64_t px_count, uint32_t components) noexcept
+    {
+        for (uint64_t i = 0; i < px_count * components; i++)
+        {
+            const float v = std::clamp(src[i], 0.0f, 1.0f);
+            dst[i] = (uint8_t)((i % components == 3 ? v : vka::detail::texture::linear_to_srgb(v)) * 255.0f + 0.5f);
+        }
+    }
+
+#if defined(VKA_SSE2)
+    /// Loads the first 3 components of 4 pixels with 3 or 4 components, one vector per component.
+    void load_rgb_sse2(const float* src, uint32_t components, __m128& r, __m128& g, __m128& b) noexcept
+    {
+        if (components == 4)
+        {
+            __m128 a0 = _mm_loadu_ps(src), a1 = _mm_loadu_ps(src + 4), a2 = _mm_loadu_ps(src + 8), a3 = _mm_loadu_ps(src + 12);
+            _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+            r = a0; g = a1; b = a2;
+            return;
+        }
+
+        // r0 g0 b0 r1 | g1 b1 r2 g2 | b2 r3 g3 b3
+        const __m128 a0 = _mm_loadu_ps(src), a1 = _mm_loadu_ps(src + 4), a2 = _mm_loadu_ps(src + 8);
+        r = _mm_shuffle_ps(_mm_shuffle_ps(a0, a0, _MM_SHUFFLE(3, 3, 0, 0)), _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+        g = _mm_shuffle_ps(_mm_shuffle_ps(a0, a1, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        b = _mm_shuffle_ps(_mm_shuffle_ps(a0, a1, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(a2, a2, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    }
+
+    /// Converts 4 non-negative floats to half floats in the lower 16 bits of 32-bit lanes.
+    __m128i halfs_sse2(__m128 v) noexcept
+    {
+#if defined(VKA_F16C)
+        return _mm_unpacklo_epi16(_mm_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT), _mm_setzero_si128());
+#else
+        return float_to_half_sse2(v);
+#endif
+    }
+#elif defined(VKA_NEON)
+    /// Loads the first 3 components of 4 pixels with 3 or 4 components, one vector per component.
+    void load_rgb_neon(const float* src, uint32_t components, float32x4_t& r, float32x4_t& g, float32x4_t& b) noexcept
+    {
+        if (components == 4)
+        {
+            const float32x4x4_t px = vld4q_f32(src);
+            r = px.val[0]; g = px.val[1]; b = px.val[2];
+        }
+        else
+        {
+            const float32x4x3_t px = vld3q_f32(src);
+            r = px.val[0]; g = px.val[1]; b = px.val[2];
+        }
+    }
+
+    /// Converts 4 floats to half floats in the lower 16 bits of 32-bit lanes.
+    uint32x4_t halfs_neon(float32x4_t v) noexcept
+    {
+        return vmovl_u16(vreinterpret_u16_f16(vcvt_f16_f32(v)));
+    }
+#endif
+
+    /// Packs pixels into <c>VK_FORMAT_B10G11R11_UFLOAT_PACK32</c>, the components are rounded from half floats.
+    void encode_b10g11r11(uint32_t* dst, const float* src, uint64_t px_count, uint32_t components) noexcept
+    {
+        // Clamping to the largest finite values avoids overflows to infinity while rounding, NaN becomes 0. The
+        // mantissas are rounded to nearest even.
+        constexpr float MAX_11 = 65024.0f;
+        constexpr float MAX_10 = 64512.0f;
+        uint64_t i = 0;
+#if defined(VKA_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128i one = _mm_set1_epi32(1);
+        const auto round11 = [&](__m128 v) {
+            const __m128i h = halfs_sse2(_mm_min_ps(_mm_max_ps(v, zero), _mm_set1_ps(MAX_11)));
+            return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(h, _mm_set1_epi32(0x7)), _mm_and_si128(_mm_srli_epi32(h, 4), one)), 4);
+        };
+        for (; i + 4 <= px_count; i += 4)
+        {
+            __m128 r, g, b;
+            load_rgb_sse2(src + i * components, components, r, g, b);
+            const __m128i h = halfs_sse2(_mm_min_ps(_mm_max_ps(b, zero), _mm_set1_ps(MAX_10)));
+            const __m128i b10 = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(h, _mm_set1_epi32(0xF)), _mm_and_si128(_mm_srli_epi32(h, 5), one)), 5);
+            const __m128i packed = _mm_or_si128(_mm_or_si128(round11(r), _mm_slli_epi32(round11(g), 11)), _mm_slli_epi32(b10, 22));
+            _mm_storeu_si128((__m128i*)(dst + i), packed);
+        }
+#elif defined(VKA_NEON)
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const uint32x4_t one = vdupq_n_u32(1);
+        const auto round11 = [&](float32x4_t v) {
+            const uint32x4_t h = halfs_neon(vminnmq_f32(vmaxnmq_f32(v, zero), vdupq_n_f32(MAX_11)));
+            return vshrq_n_u32(vaddq_u32(vaddq_u32(h, vdupq_n_u32(0x7)), vandq_u32(vshrq_n_u32(h, 4), one)), 4);
+        };
+        for (; i + 4 <= px_count; i += 4)
+        {
+            float32x4_t r, g, b;
+            load_rgb_neon(src + i * components, components, r, g, b);
+            const uint32x4_t h = halfs_neon(vminnmq_f32(vmaxnmq_f32(b, zero), vdupq_n_f32(MAX_10)));
+            const uint32x4_t b10 = vshrq_n_u32(vaddq_u32(vaddq_u32(h, vdupq_n_u32(0xF)), vandq_u32(vshrq_n_u32(h, 5), one)), 5);
+            vst1q_u32(dst + i, vorrq_u32(vorrq_u32(round11(r), vshlq_n_u32(round11(g), 11)), vshlq_n_u32(b10, 22)));
+        }
+#endif
+        for (; i < px_count; i++)
+        {
+            uint32_t h[3];
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                const float v = src[i * components + k];
+                h[k] = float_to_half(std::min(v > 0.0f ? v : 0.0f, k == 2 ? MAX_10 : MAX_11));
+            }
+            const uint32_t r11 = (h[0] + 0x7 + ((h[0] >> 4) & 1)) >> 4;
+            const uint32_t g11 = (h[1] + 0x7 + ((h[1] >> 4) & 1)) >> 4;
+            const uint32_t b10 = (h[2] + 0xF + ((h[2] >> 5) & 1)) >> 5;
+            dst[i] = r11 | (g11 << 11) | (b10 << 22);
+        }
+    }
+
+    /// Packs pixels into <c>VK_FORMAT_E5B9G9R9_UFLOAT_PACK32</c> as specified by the Vulkan specification.
+    void encode_e5b9g9r9(uint32_t* dst, const float* src, uint64_t px_count, uint32_t components) noexcept
+    {
+        constexpr int32_t N = 9;
+        constexpr int32_t B = 15;
+        constexpr float SHARED_MAX = 65408.0f; // (2^N - 1) / 2^N * 2^(31 - B)
+
+        // The scale 2^-(shared - B - N) is built from its exponent bits. floor(log2(max)) is the exponent of the
+        // float, which is at most -127 for 0 and subnormals.
+        uint64_t i = 0;
+#if defined(VKA_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 shared_max = _mm_set1_ps(SHARED_MAX);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128i min_exponent = _mm_set1_epi32(-B - 1);
+        const auto scale_of = [](__m128i shared) {
+            return _mm_castsi128_ps(_mm_slli_epi32(_mm_sub_epi32(_mm_set1_epi32(127 + B + N), shared), 23));
+        };
+        for (; i + 4 <= px_count; i += 4)
+        {
+            __m128 r, g, b;
+            load_rgb_sse2(src + i * components, components, r, g, b);
+            r = _mm_min_ps(_mm_max_ps(r, zero), shared_max);
+            g = _mm_min_ps(_mm_max_ps(g, zero), shared_max);
+            b = _mm_min_ps(_mm_max_ps(b, zero), shared_max);
+
+            const __m128 max = _mm_max_ps(r, _mm_max_ps(g, b));
+            __m128i exponent = _mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(max), 23), _mm_set1_epi32(127));
+            const __m128i below = _mm_cmpgt_epi32(min_exponent, exponent);
+            exponent = _mm_or_si128(_mm_and_si128(below, min_exponent), _mm_andnot_si128(below, exponent));
+            __m128i shared = _mm_add_epi32(exponent, _mm_set1_epi32(1 + B));
+
+            // The shared exponent is increased, if the maximum rounds up to 2^N. The comparison mask is -1.
+            const __m128i max_rounded = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(max, scale_of(shared)), half));
+            shared = _mm_sub_epi32(shared, _mm_cmpeq_epi32(max_rounded, _mm_set1_epi32(1 << N)));
+
+            const __m128 scale = scale_of(shared);
+            const __m128i r9 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(r, scale), half));
+            const __m128i g9 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(g, scale), half));
+            const __m128i b9 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(b, scale), half));
+            const __m128i packed = _mm_or_si128(_mm_or_si128(r9, _mm_slli_epi32(g9, 9)), _mm_or_si128(_mm_slli_epi32(b9, 18), _mm_slli_epi32(shared, 27)));
+            _mm_storeu_si128((__m128i*)(dst + i), packed);
+        }
+#elif defined(VKA_NEON)
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t shared_max = vdupq_n_f32(SHARED_MAX);
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        const auto scale_of = [](int32x4_t shared) {
+            return vreinterpretq_f32_s32(vshlq_n_s32(vsubq_s32(vdupq_n_s32(127 + B + N), shared), 23));
+        };
+        for (; i + 4 <= px_count; i += 4)
+        {
+            float32x4_t r, g, b;
+            load_rgb_neon(src + i * components, components, r, g, b);
+            r = vminnmq_f32(vmaxnmq_f32(r, zero), shared_max);
+            g = vminnmq_f32(vmaxnmq_f32(g, zero), shared_max);
+            b = vminnmq_f32(vmaxnmq_f32(b, zero), shared_max);
+
+            const float32x4_t max = vmaxq_f32(r, vmaxq_f32(g, b));
+            const int32x4_t exponent = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_f32(max), 23)), vdupq_n_s32(127));
+            int32x4_t shared = vaddq_s32(vmaxq_s32(exponent, vdupq_n_s32(-B - 1)), vdupq_n_s32(1 + B));
+
+            // The shared exponent is increased, if the maximum rounds up to 2^N. The comparison mask is -1.
+            const uint32x4_t max_rounded = vcvtq_u32_f32(vaddq_f32(vmulq_f32(max, scale_of(shared)), half));
+            shared = vsubq_s32(shared, vreinterpretq_s32_u32(vceqq_u32(max_rounded, vdupq_n_u32(1u << N))));
+
+            const float32x4_t scale = scale_of(shared);
+            const uint32x4_t r9 = vcvtq_u32_f32(vaddq_f32(vmulq_f32(r, scale), half));
+            const uint32x4_t g9 = vcvtq_u32_f32(vaddq_f32(vmulq_f32(g, scale), half));
+            const uint32x4_t b9 = vcvtq_u32_f32(vaddq_f32(vmulq_f32(b, scale), half));
+            const uint32x4_t e5 = vshlq_n_u32(vreinterpretq_u32_s32(shared), 27);
+            vst1q_u32(dst + i, vorrq_u32(vorrq_u32(r9, vshlq_n_u32(g9, 9)), vorrq_u32(vshlq_n_u32(b9, 18), e5)));
+        }
+#endif
+        const auto pow2 = [](int32_t e) { return std::bit_cast<float>((uint32_t)(127 + e) << 23); };
+        for (; i < px_count; i++)
+        {
+            float c[3];
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                const float v = src[i * components + k];
+                c[k] = std::min(v > 0.0f ? v : 0.0f, SHARED_MAX);
+            }
+
+            const float max = std::max(c[0], std::max(c[1], c[2]));
+            const int32_t exponent = (int32_t)(std::bit_cast<uint32_t>(max) >> 23) - 127;
+            int32_t shared = std::max(-B - 1, exponent) + 1 + B;
+            if ((uint32_t)(max * pow2(-(shared - B - N)) + 0.5f) == (1u << N))
+                shared++;
+
+            const float scale = pow2(-(shared - B - N));
+            const uint32_t r = (uint32_t)(c[0] * scale + 0.5f);
+            const uint32_t g = (uint32_t)(c[1] * scale + 0.5f);
+            const uint32_t b = (uint32_t)(c[2] * scale + 0.5f);
+            dst[i] = r | (g << 9) | (b << 18) | ((uint32_t)shared << 27);
+        }
+    }
+}
+
+void vka::detail::texture::destroy(VkDevice device, const Handle& handle, const VkAllocationCallbacks* allocator)
+{
+    for (uint32_t i = 0; i < handle.view_count; i++)
+        vkDestroyImageView(device, handle.views[i], allocator);
+    delete[] handle.views;
+
+    if (handle.sampler_cache != nullptr)
+        handle.sampler_cache->release(handle.sampler);
+    else
+        vkDestroySampler(device, handle.sampler, allocator);
+    vkDestroyImage(device, handle.image, allocator);
+    memory::free(device, handle.memory, allocator);
+}
+
+void* vka::detail::texture::reserve_pages(size_t size) noexcept
+{
+    size = std::max<size_t>(size, 1);
+#ifdef _WIN32
+    return VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* const reservation = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return reservation == MAP_FAILED ? nullptr : reservation;
+#endif
+}
+
+bool vka::detail::texture::commit_pages(void* reservation, size_t size) noexcept
+{
+    if (size == 0)
+        return true;
+#ifdef _WIN32
+    return VirtualAlloc(reservation, size, MEM_COMMIT, PAGE_READWRITE) != nullptr;
+#else
+    return mprotect(reservation, size, PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+void vka::detail::texture::release_pages(void* reservation, size_t size) noexcept
+{
+    if (reservation == nullptr)
+        return;
+#ifdef _WIN32
+    (void)size;
+    VirtualFree(reservation, 0, MEM_RELEASE);
+#else
+    munmap(reservation, std::max<size_t>(size, 1));
+#endif
+}
+
+bool vka::detail::texture::is_block_encoder_format(VkFormat format) noexcept
+{
+    switch (format)
+    {
+    case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+    case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+    case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+    case VK_FORMAT_BC3_UNORM_BLOCK:
+    case VK_FORMAT_BC3_SRGB_BLOCK:
+    case VK_FORMAT_BC4_UNORM_BLOCK:
+    case VK_FORMAT_BC5_UNORM_BLOCK:
+    case VK_FORMAT_BC7_UNORM_BLOCK:
+    case VK_FORMAT_BC7_SRGB_BLOCK:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void vka::detail::texture::encode_blocks(uint8_t* dst, const uint8_t* src, VkExtent2D extent, uint32_t components, uint32_t block_row, VkFormat format, bool high_quality) noexcept
+{
+    const uint32_t block_count = (extent.width + 3) / 4;
+    const size_t block_size = format_sizeof(format);
+    BlockPixels px;
+    for (uint32_t bx = 0; bx < block_count; bx++)
+    {
+        gather_block(px, src, extent, components, bx, block_row);
+        uint8_t* const block = dst + bx * block_size;
+        switch (format)
+        {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            encode_bc1(block, px, false, high_quality);
+            break;
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            encode_bc1(block, px, true, high_quality);
+            break;
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+            // The color block of BC3 is always decoded in 4-color mode.
+            encode_bc4(block, px, 3, high_quality);
+            encode_bc1(block + 8, px, false, high_quality);
+            break;
+        case VK_FORMAT_BC4_UNORM_BLOCK:
+            encode_bc4(block, px, 0, high_quality);
+            break;
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+            encode_bc4(block, px, 0, high_quality);
+            encode_bc4(block + 8, px, 1, high_quality);
+            break;
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            encode_bc7(block, px, high_quality);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+bool vka::detail::texture::is_convert_format(VkFormat format, uint32_t src_components) noexcept
+{
+    const ConvertTarget target = convert_target(format);
+    switch (target.kind)
+    {
+    case ConvertKind::NONE:
+        return false;
+    case ConvertKind::B10G11R11:
+    case ConvertKind::E5B9G9R9:
+        return src_components >= 3;
+    default:
+        return src_components == target.components;
+    }
+}
+
+void vka::detail::texture::convert_texels(void* dst, const void* src, uint8_t src_type, uint32_t components, uint64_t px_count, VkFormat format) noexcept
+{
+    const ConvertTarget target = convert_target(format);
+    const uint64_t count = px_count * components;
+
+    // Integer conversions do not need the float intermediate. Integer sources are stored with the transfer function
+    // of the target, so that they are not encoded as sRGB again.
+    const bool unorm8 = target.kind == ConvertKind::UNORM8 || target.kind == ConvertKind::SRGB8;
+    if ((unorm8 && src_type == 0) || (target.kind == ConvertKind::UNORM16 && src_type == 1))
+    {
+        std::memcpy(dst, src, count * (src_type == 0 ? 1 : 2));
+        return;
+    }
+    if (unorm8 && src_type == 1)
+    {
+        narrow_unorm16(static_cast<uint8_t*>(dst), static_cast<const uint16_t*>(src), count);
+        return;
+    }
+    if (target.kind == ConvertKind::UNORM16 && src_type == 0)
+    {
+        expand_unorm8(static_cast<uint16_t*>(dst), static_cast<const uint8_t*>(src), count);
+        return;
+    }
+
+    const size_t src_size = src_type == 0 ? 1 : (src_type == 1 ? 2 : 4);
+    float floats[CONVERT_CHUNK * 4];
+    for (uint64_t begin = 0; begin < px_count; begin += CONVERT_CHUNK)
+    {
+        const uint64_t chunk = std::min<uint64_t>(CONVERT_CHUNK, px_count - begin);
+        const uint64_t offset = begin * components;
+        decode_floats(floats, static_cast<const uint8_t*>(src) + offset * src_size, src_type, chunk * components);
+
+        switch (target.kind)
+        {
+        case ConvertKind::UNORM8:
+            encode_unorm(static_cast<uint8_t*>(dst) + offset, floats, chunk * components);
+            break;
+        case ConvertKind::SRGB8:
+            encode_srgb8(static_cast<uint8_t*>(dst) + offset, floats, chunk, components);
+            break;
+        case ConvertKind::UNORM16:
+            encode_unorm(static_cast<uint16_t*>(dst) + offset, floats, chunk * components);
+            break;
+        case ConvertKind::HALF:
+            floats_to_halfs(static_cast<uint16_t*>(dst) + offset, floats, chunk * components);
+            break;
+        case ConvertKind::B10G11R11:
+            encode_b10g11r11(static_cast<uint32_t*>(dst) + begin, floats, chunk, components);
+            break;
+        case ConvertKind::E5B9G9R9:
+            encode_e5b9g9r9(static_cast<uint32_t*>(dst) + begin, floats, chunk, components);
+            break;
+        default:
+            break;
+        }
+    }
+}
@@ -9,6 +9,11 @@
 // ReSharper disable CppRedundantInlineSpecifier
 #pragma once
 
+namespace vka
+{
+    class SamplerCache;
+}
+
 namespace vka::detail::texture
 {
     /// Maps from format type-ID to the format type.
@@ -61,6 +66,10 @@ namespace vka::detail::texture
                                 is_format_contained(F, LOADER_FORMAT_U16, 4)    ||
                                 is_format_contained(F, LOADER_FORMAT_FLOAT, 4);
 
+    /// Concept whether images of the format can be block compressed, which requires 8-bit components.
+    template<VkFormat F>
+    concept is_encoder_format = is_format_contained(F, LOADER_FORMAT_U8, 4);
+
     /// Data-type of the format.
     template<VkFormat F>
     using loader_format_t = loader_format_type<format_type_id(F)>::type;
@@ -73,21 +82,75 @@ namespace vka::detail::texture
     struct Handle
     {
         VkImage image;
-        VkDeviceMemory memory;
+        memory::Allocation memory;
         VkSampler sampler;
+        SamplerCache* sampler_cache;    // nullptr, if the sampler is owned by the texture
         const VkImageView* views;
         uint32_t view_count;
 
         explicit constexpr operator bool() const noexcept { return image != VK_NULL_HANDLE; }
     };
 
-    /// Destroys the texture handle.
-    inline void destroy(VkDevice device, const Handle& handle, const VkAllocationCallbacks* allocator);
+    /// Destroys the texture handle. A sampler of a cache is released to the cache.
+    void destroy(VkDevice device, const Handle& handle, const VkAllocationCallbacks* allocator);
+
+    /// Queries the extent and the number of components of an image file without decoding it.
+    inline void info(const char* path, VkExtent2D& extent, uint32_t& components);
 
     /// Loads an image from a file.
     template<VkFormat F>
     inline std::unique_ptr<loader_format_t<F>[]> load(const char* path, VkExtent2D& extent, uint32_t& components);
 
+    /**
+     * Byte-shuffle that packs 16 bytes of source pixels into 16 bytes of destination pixels. Destination bytes
+     * whose blend mask is 0 keep their value.
+     */
+    struct ShuffleMask
+    {
+        uint8_t index[16];
+        uint8_t blend[16];
+        bool full;
+    };
+
+    /// Function which copies or fills the components of pixels.
+    template<typename T>
+    using pixel_kernel_t = void(*)(T*, const T*, uint64_t) noexcept;
+
+    /// Whether pixels with STRIDE source and DST destination components can be packed by a byte-shuffle.
+    template<typename T, uint32_t STRIDE, uint32_t DST>
+    consteval bool has_shuffle() noexcept;
+
+    /**
+     * Creates the shuffle for pixels whose components are <c>STRIDE</c> elements apart in the source. The first
+     * <c>COUNT</c> components of the source are written to the destination, starting at component <c>OFFSET</c>.
+     */
+    template<typename T, uint32_t STRIDE, uint32_t DST, uint32_t OFFSET, uint32_t COUNT>
+    consteval ShuffleMask shuffle_mask() noexcept;
+
+    /// Packs as many pixels as possible with SIMD instructions. @return Returns the number of packed pixels.
+    template<typename T, uint32_t STRIDE, uint32_t DST, uint32_t OFFSET, uint32_t COUNT>
+    uint64_t shuffle_pixels(T* dst, const T* src, uint64_t px_count) noexcept;
+
+    /// Copies pixels with SRC components into pixels with DST components, starting at component OFFSET.
+    template<typename T, uint32_t SRC, uint32_t DST, uint32_t OFFSET>
+    void copy_pixels(T* dst, const T* src, uint64_t px_count) noexcept;
+
+    /// Fills pixels with DST components with a color of COUNT components, starting at component OFFSET.
+    template<typename T, uint32_t COUNT, uint32_t DST, uint32_t OFFSET>
+    void fill_pixels(T* dst, const T* color, uint64_t px_count) noexcept;
+
+    /// Creates the table of kernels indexed by <c>offset * 4 + components - 1</c>.
+    template<typename T, uint32_t DST, bool FILL, size_t... I>
+    consteval std::array<pixel_kernel_t<T>, sizeof...(I)> pixel_kernels(std::index_sequence<I...>) noexcept;
+
+    /**
+     * Calls <c>func(i)</c> for every index in <c>[0, count)</c> on a pool of worker threads, including the calling
+     * thread. An exception thrown for an index is stored in <c>errors[i]</c>.
+     * @param thread_count Maximum number of threads. If it is <c>0</c>, the number of hardware threads is used.
+     */
+    template<typename Func>
+    void parallel_for(uint32_t count, uint32_t thread_count, std::exception_ptr* errors, const Func& func);
+
     /// Copies image data from src to dst.
     template<VkFormat F>
     void copy_image(loader_format_t<F>* dst, const loader_format_t<F>* src, uint64_t px_count, uint32_t img_comp, uint32_t comp_offset) noexcept;
@@ -95,4 +158,112 @@ namespace vka::detail::texture
     /// Fills the image with a single color.
     template<VkFormat F>
     void fill_image(loader_format_t<F>* dst, const loader_format_t<F>* color, uint64_t px_count, uint32_t img_comp, uint32_t comp_offset) noexcept;
+
+    /// Radius of the Kaiser filter in source pixels.
+    constexpr int32_t KAISER_RADIUS = 6;
+
+    /// Shape parameter of the Kaiser window.
+    constexpr float KAISER_ALPHA = 4.0f;
+
+    /// Number of destination rows which are filtered by a single task.
+    constexpr uint32_t MIP_BAND_ROWS = 32;
+
+    /// Parameters of the mip-map generation, which are shared by all levels.
+    struct MipParams
+    {
+        bool kaiser;
+        bool srgb;
+        bool normal_map;
+    };
+
+    /// Converts an sRGB encoded value to linear space.
+    inline float srgb_to_linear(float v) noexcept;
+
+    /// Converts a linear value to sRGB encoding.
+    inline float linear_to_srgb(float v) noexcept;
+
+    /// @return Returns the UNORM format with which an sRGB format is written in shaders, other formats are returned as is.
+    constexpr VkFormat storage_format(VkFormat format) noexcept;
+
+    /// Computes the weights of the Kaiser filter for a downsampling of 2. Weights has <c>2 * KAISER_RADIUS</c> elements.
+    inline void kaiser_weights(float* weights) noexcept;
+
+    /**
+     * Converts a component to a linear float. Integer components are normalized and optionally decoded from sRGB or
+     * from the unsigned normal encoding. Float components are returned unchanged.
+     */
+    template<typename T>
+    inline float decode_component(T v, uint32_t comp, const MipParams& params) noexcept;
+
+    /// Inverse of <c>decode_component()</c>, integer components are rounded and clamped.
+    template<typename T>
+    inline T encode_component(float v, uint32_t comp, const MipParams& params) noexcept;
+
+    /// Downsamples the rows <c>[row_begin, row_end)</c> of a destination level with a 2x2 box filter.
+    template<typename S, uint32_t C>
+    void mip_filter_box(float* dst, const S* src, VkExtent2D src_extent, VkExtent2D dst_extent, uint32_t row_begin, uint32_t row_end, const MipParams& params) noexcept;
+
+    /// Horizontal pass of the Kaiser filter for the source rows <c>[row_begin, row_end)</c>.
+    template<typename S, uint32_t C>
+    void mip_filter_rows(float* dst, const S* src, VkExtent2D src_extent, uint32_t dst_width, uint32_t row_begin, uint32_t row_end, const float* weights, const MipParams& params) noexcept;
+
+    /// Vertical pass of the Kaiser filter for the destination rows <c>[row_begin, row_end)</c>.
+    template<uint32_t C>
+    void mip_filter_columns(float* dst, const float* src, uint32_t width, uint32_t src_height, uint32_t row_begin, uint32_t row_end, const float* weights) noexcept;
+
+    /// Renormalizes normal vectors in place and encodes <c>px_count</c> pixels into the level.
+    template<typename T, uint32_t C>
+    void mip_encode(T* dst, float* src, uint64_t px_count, const MipParams& params) noexcept;
+
+    /// A texture loader reserves address space for this multiple of its layers up front.
+    constexpr uint32_t LOADER_RESERVE_FACTOR = 8;
+
+    /// Maximum number of layers for which a texture loader reserves address space up front.
+    constexpr uint32_t LOADER_RESERVED_LAYERS = 2048;
+
+    /// Upper bound of the address space reserved by a texture loader in bytes.
+    constexpr size_t LOADER_RESERVED_SIZE = sizeof(size_t) >= 8 ? (size_t)1 << 40 : (size_t)1 << 29;
+
+    /**
+     * Reserves address space without backing it with memory.
+     * @return Returns the beginning of the reservation, which is page aligned, or <c>nullptr</c> on failure.
+     */
+    void* reserve_pages(size_t size) noexcept;
+
+    /**
+     * Backs the first <c>size</c> bytes of a reservation with memory. Newly committed pages are zeroed by the system
+     * on first access, already committed pages keep their content.
+     * @return Returns whether committing succeeded.
+     */
+    bool commit_pages(void* reservation, size_t size) noexcept;
+
+    /// Releases a reservation of <c>size</c> bytes including all committed pages.
+    void release_pages(void* reservation, size_t size) noexcept;
+
+    /// @return Returns whether <c>encode_blocks()</c> supports the block compressed format.
+    bool is_block_encoder_format(VkFormat format) noexcept;
+
+    /**
+     * Encodes a row of 4x4 blocks of an 8-bit image. Blocks exceeding the image replicate its edge pixels.
+     * @param dst Destination of the row, must hold <c>ceil(extent.width / 4) * format_sizeof(format)</c> bytes.
+     * @param src Image with <c>components</c> components per pixel, missing components are 0 and alpha is 255.
+     * @param block_row Index of the row of blocks.
+     * @param high_quality Refines the endpoints with a least-squares fit and searches more endpoint candidates.
+     */
+    void encode_blocks(uint8_t* dst, const uint8_t* src, VkExtent2D extent, uint32_t components, uint32_t block_row, VkFormat format, bool high_quality) noexcept;
+
+    /**
+     * @return Returns whether <c>convert_texels()</c> supports the format for images with <c>src_components</c>
+     * components. Packed formats require at least 3 components, all other formats the same number of components.
+     */
+    bool is_convert_format(VkFormat format, uint32_t src_components) noexcept;
+
+    /**
+     * Converts pixels of a loader format into another format. Integer sources are normalized, float sources are
+     * linear and are encoded as sRGB for sRGB formats, except for alpha.
+     * @param dst Destination of the pixels, must hold <c>px_count * format_sizeof(format)</c> bytes.
+     * @param src Pixels with <c>components</c> components of the loader type <c>src_type</c>, 0 for 8-bit, 1 for
+     * 16-bit and 2 for float components.
+     */
+    void convert_texels(void* dst, const void* src, uint8_t src_type, uint32_t components, uint64_t px_count, VkFormat format) noexcept;
 }
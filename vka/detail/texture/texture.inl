@@ -3,17 +3,6 @@
 // ReSharper disable CppRedundantInlineSpecifier
 #include "texture.h"
 
-inline void vka::detail::texture::destroy(VkDevice device, const Handle& handle, const VkAllocationCallbacks* allocator)
-{
-    for (uint32_t i = 0; i < handle.view_count; i++)
-        vkDestroyImageView(device, handle.views[i], allocator);
-    delete[] handle.views;
-
-    vkDestroySampler(device, handle.sampler, allocator);
-    vkFreeMemory(device, handle.memory, allocator);
-    vkDestroyImage(device, handle.image, allocator);
-}
-
 consteval bool vka::detail::texture::is_format_contained(VkFormat format, const VkFormat* formats, uint32_t count) noexcept
 {
     for (uint32_t i = 0; i < count; i++)
@@ -32,6 +21,16 @@ consteval uint8_t vka::detail::texture::format_type_id(VkFormat format) noexcept
     return 0xFF;
 }
 
+inline void vka::detail::texture::info(const char* path, VkExtent2D& extent, uint32_t& components)
+{
+    int32_t width, height, comp;
+    if (stbi_info(path, &width, &height, &comp) == 0) [[unlikely]]
+        error::throw_invalid_argument("[vka::detail::texture::info]: Cannot find path to the image file");
+
+    extent = { (uint32_t)width, (uint32_t)height };
+    components = (uint32_t)comp;
+}
+
 template<VkFormat F>
 inline std::unique_ptr<vka::detail::texture::loader_format_t<F>[]> vka::detail::texture::load(const char* path, VkExtent2D& extent, uint32_t& components)
 {
@@ -45,29 +44,378 @@ inline std::unique_ptr<vka::detail::texture::loader_format_t<F>[]> vka::detail::
     return std::unique_ptr<loader_format_t<F>[]>(data);
 }
 
-template<VkFormat F>
-void vka::detail::texture::copy_image(loader_format_t<F>* dst, const loader_format_t<F>* src, uint64_t px_count, uint32_t img_comp, uint32_t comp_offset) noexcept
+template<typename Func>
+void vka::detail::texture::parallel_for(uint32_t count, uint32_t thread_count, std::exception_ptr* errors, const Func& func)
 {
-    constexpr size_t max_comp = format::format_countof(F);
-    const uint32_t rem_comp = max_comp - comp_offset;
-    for (uint64_t i = 0; i < px_count; i++)
+    std::atomic<uint32_t> next = 0;
+    const auto worker = [&]() {
+        for (uint32_t i = next.fetch_add(1, std::memory_order_relaxed); i < count; i = next.fetch_add(1, std::memory_order_relaxed))
+        {
+            try
+            {
+                func(i);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    // If a thread cannot be created, the remaining work is done by the threads which already exist.
+    if (thread_count == 0)
+        thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    thread_count = std::min(thread_count, count);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 1; t < thread_count; t++)
+    {
+        try
+        {
+            threads.emplace_back(worker);
+        }
+        catch (const std::system_error&)
+        {
+            break;
+        }
+    }
+    worker();
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+template<typename T, uint32_t STRIDE, uint32_t DST>
+consteval bool vka::detail::texture::has_shuffle() noexcept
+{
+#if defined(VKA_SSE4_1) || defined(VKA_NEON)
+    return STRIDE <= DST && 16 % (DST * sizeof(T)) == 0;
+#else
+    return false;
+#endif
+}
+
+template<typename T, uint32_t STRIDE, uint32_t DST, uint32_t OFFSET, uint32_t COUNT>
+consteval vka::detail::texture::ShuffleMask vka::detail::texture::shuffle_mask() noexcept
+{
+    // An index of 0xFF writes a zero for both pshufb and tbl, these bytes are never blended.
+    ShuffleMask mask = {};
+    mask.full = OFFSET == 0 && COUNT == DST;
+    for (uint32_t b = 0; b < 16; b++)
+    {
+        const uint32_t pixel = b / (DST * sizeof(T));
+        const uint32_t comp = b / sizeof(T) % DST;
+        const uint32_t byte = b % sizeof(T);
+        const bool written = comp >= OFFSET && comp - OFFSET < COUNT;
+        mask.index[b] = written ? static_cast<uint8_t>((pixel * STRIDE + comp - OFFSET) * sizeof(T) + byte) : 0xFF;
+        mask.blend[b] = written ? 0xFF : 0x00;
+    }
+    return mask;
+}
+
+template<typename T, uint32_t STRIDE, uint32_t DST, uint32_t OFFSET, uint32_t COUNT>
+uint64_t vka::detail::texture::shuffle_pixels(T* dst, const T* src, uint64_t px_count) noexcept
+{
+    // A 16-byte load must not read behind the source. With a stride of 0 (fill) the source is a 16-byte pattern.
+    constexpr ShuffleMask mask = shuffle_mask<T, STRIDE, DST, OFFSET, COUNT>();
+    constexpr uint64_t vec_px = 16 / (DST * sizeof(T));
+    constexpr uint64_t load_px = STRIDE == 0 ? 0 : (16 + STRIDE * sizeof(T) - 1) / (STRIDE * sizeof(T));
+    constexpr uint64_t reach = std::max(vec_px, load_px);
+    uint64_t i = 0;
+
+#if defined(VKA_AVX2)
+    const __m256i index256 = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.index)));
+    const __m256i blend256 = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.blend)));
+    for (; i + vec_px + reach <= px_count; i += 2 * vec_px)
     {
-        const uint64_t offset_src = i * img_comp;
-        const uint64_t offset_dst = i * max_comp + comp_offset;
-        for (uint32_t c = 0; c < img_comp && c < rem_comp; c++)
-            dst[offset_dst + c] = src[offset_src + c];
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * STRIDE));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (i + vec_px) * STRIDE));
+        __m256i* const p = reinterpret_cast<__m256i*>(dst + i * DST);
+        __m256i v = _mm256_shuffle_epi8(_mm256_set_m128i(hi, lo), index256);
+        if constexpr (!mask.full)
+            v = _mm256_blendv_epi8(_mm256_loadu_si256(p), v, blend256);
+        _mm256_storeu_si256(p, v);
     }
+#endif
+
+#if defined(VKA_SSE4_1)
+    const __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.index));
+    const __m128i blend = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask.blend));
+    for (; i + reach <= px_count; i += vec_px)
+    {
+        __m128i* const p = reinterpret_cast<__m128i*>(dst + i * DST);
+        __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * STRIDE)), index);
+        if constexpr (!mask.full)
+            v = _mm_blendv_epi8(_mm_loadu_si128(p), v, blend);
+        _mm_storeu_si128(p, v);
+    }
+#elif defined(VKA_NEON)
+    const uint8x16_t index = vld1q_u8(mask.index);
+    const uint8x16_t blend = vld1q_u8(mask.blend);
+    for (; i + reach <= px_count; i += vec_px)
+    {
+        uint8_t* const p = reinterpret_cast<uint8_t*>(dst + i * DST);
+        uint8x16_t v = vqtbl1q_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(src + i * STRIDE)), index);
+        if constexpr (!mask.full)
+            v = vbslq_u8(blend, v, vld1q_u8(p));
+        vst1q_u8(p, v);
+    }
+#endif
+    return i;
+}
+
+template<typename T, uint32_t SRC, uint32_t DST, uint32_t OFFSET>
+void vka::detail::texture::copy_pixels(T* dst, const T* src, uint64_t px_count) noexcept
+{
+    constexpr uint32_t count = std::min(SRC, DST - OFFSET);
+    if constexpr (SRC == DST && OFFSET == 0)
+    {
+        memcpy(dst, src, px_count * DST * sizeof(T));
+        return;
+    }
+
+    // The remaining pixels are copied with a fixed-size memcpy, which compiles to plain loads and stores.
+    uint64_t i = 0;
+    if constexpr (has_shuffle<T, SRC, DST>())
+        i = shuffle_pixels<T, SRC, DST, OFFSET, count>(dst, src, px_count);
+    for (; i < px_count; i++)
+        memcpy(dst + i * DST + OFFSET, src + i * SRC, count * sizeof(T));
+}
+
+template<typename T, uint32_t COUNT, uint32_t DST, uint32_t OFFSET>
+void vka::detail::texture::fill_pixels(T* dst, const T* color, uint64_t px_count) noexcept
+{
+    constexpr uint32_t count = std::min(COUNT, DST - OFFSET);
+    uint64_t i = 0;
+    if constexpr (has_shuffle<T, 0, DST>())
+    {
+        T pattern[16 / sizeof(T)] = {};
+        std::copy(color, color + count, pattern);
+        i = shuffle_pixels<T, 0, DST, OFFSET, count>(dst, pattern, px_count);
+    }
+    for (; i < px_count; i++)
+        memcpy(dst + i * DST + OFFSET, color, count * sizeof(T));
+}
+
+template<typename T, uint32_t DST, bool FILL, size_t... I>
+consteval std::array<vka::detail::texture::pixel_kernel_t<T>, sizeof...(I)> vka::detail::texture::pixel_kernels(std::index_sequence<I...>) noexcept
+{
+    // Offsets behind the last component have no kernel.
+    constexpr auto kernel = []<uint32_t COMP, uint32_t OFFSET>() -> pixel_kernel_t<T> {
+        if constexpr (OFFSET >= DST)
+            return nullptr;
+        else if constexpr (FILL)
+            return &fill_pixels<T, COMP, DST, OFFSET>;
+        else
+            return &copy_pixels<T, COMP, DST, OFFSET>;
+    };
+    return { kernel.template operator()<I % 4 + 1, I / 4>()... };
+}
+
+template<VkFormat F>
+void vka::detail::texture::copy_image(loader_format_t<F>* dst, const loader_format_t<F>* src, uint64_t px_count, uint32_t img_comp, uint32_t comp_offset) noexcept
+{
+    // The kernel is specialized for the number of source components and the component offset.
+    constexpr uint32_t max_comp = format::format_countof(F);
+    static constexpr auto kernels = pixel_kernels<loader_format_t<F>, max_comp, false>(std::make_index_sequence<16>());
+    if (comp_offset < max_comp && img_comp >= 1 && img_comp <= 4)
+        kernels[comp_offset * 4 + img_comp - 1](dst, src, px_count);
 }
 
 template<VkFormat F>
 void vka::detail::texture::fill_image(loader_format_t<F>* dst, const loader_format_t<F>* color, uint64_t px_count, uint32_t img_comp, uint32_t comp_offset) noexcept
 {
-    constexpr size_t max_comp = format::format_countof(F);
-    const uint32_t rem_comp = max_comp - comp_offset;
+    constexpr uint32_t max_comp = format::format_countof(F);
+    static constexpr auto kernels = pixel_kernels<loader_format_t<F>, max_comp, true>(std::make_index_sequence<16>());
+    if (comp_offset < max_comp && img_comp >= 1 && img_comp <= 4)
+        kernels[comp_offset * 4 + img_comp - 1](dst, color, px_count);
+}
+
+inline float vka::detail::texture::srgb_to_linear(float v) noexcept
+{
+    return v <= 0.04045f ? v / 12.92f : std::pow((v + 0.055f) / 1.055f, 2.4f);
+}
+
+inline float vka::detail::texture::linear_to_srgb(float v) noexcept
+{
+    return v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+}
+
+constexpr VkFormat vka::detail::texture::storage_format(VkFormat format) noexcept
+{
+    switch (format)
+    {
+    case VK_FORMAT_R8_SRGB:                 return VK_FORMAT_R8_UNORM;
+    case VK_FORMAT_R8G8_SRGB:               return VK_FORMAT_R8G8_UNORM;
+    case VK_FORMAT_R8G8B8_SRGB:             return VK_FORMAT_R8G8B8_UNORM;
+    case VK_FORMAT_B8G8R8_SRGB:             return VK_FORMAT_B8G8R8_UNORM;
+    case VK_FORMAT_R8G8B8A8_SRGB:           return VK_FORMAT_R8G8B8A8_UNORM;
+    case VK_FORMAT_B8G8R8A8_SRGB:           return VK_FORMAT_B8G8R8A8_UNORM;
+    case VK_FORMAT_A8B8G8R8_SRGB_PACK32:    return VK_FORMAT_A8B8G8R8_UNORM_PACK32;
+    default:                                return format;
+    }
+}
+
+inline void vka::detail::texture::kaiser_weights(float* weights) noexcept
+{
+    // The destination pixel is centered between the source pixels -1 and 0, which are the pixels 2x and 2x+1.
+    const auto bessel_i0 = [](float x) {
+        float sum = 1.0f, term = 1.0f;
+        for (int32_t k = 1; k < 16; k++)
+        {
+            term *= (x * x) / (4.0f * k * k);
+            sum += term;
+        }
+        return sum;
+    };
+    constexpr float pi = 3.14159265358979f;
+    float total = 0.0f;
+    for (int32_t i = 0; i < 2 * KAISER_RADIUS; i++)
+    {
+        const float d = (float)(i - KAISER_RADIUS) + 0.5f;
+        const float x = 0.5f * d * pi;
+        const float sinc = std::abs(x) < 1e-6f ? 1.0f : std::sin(x) / x;
+        const float r = d / (float)KAISER_RADIUS;
+        const float window = bessel_i0(KAISER_ALPHA * std::sqrt(std::max(0.0f, 1.0f - r * r))) / bessel_i0(KAISER_ALPHA);
+        weights[i] = sinc * window;
+        total += weights[i];
+    }
+    for (int32_t i = 0; i < 2 * KAISER_RADIUS; i++)
+        weights[i] /= total;
+}
+
+template<typename T>
+inline float vka::detail::texture::decode_component(T v, uint32_t comp, const MipParams& params) noexcept
+{
+    if constexpr (std::is_floating_point_v<T>)
+        return v;
+    else
+    {
+        const float f = (float)v / (float)std::numeric_limits<T>::max();
+        if (comp < 3 && params.normal_map)
+            return f * 2.0f - 1.0f;
+        if (comp < 3 && params.srgb)
+            return srgb_to_linear(f);
+        return f;
+    }
+}
+
+template<typename T>
+inline T vka::detail::texture::encode_component(float v, uint32_t comp, const MipParams& params) noexcept
+{
+    if constexpr (std::is_floating_point_v<T>)
+        return v;
+    else
+    {
+        if (comp < 3 && params.normal_map)
+            v = v * 0.5f + 0.5f;
+        else if (comp < 3 && params.srgb)
+            v = linear_to_srgb(std::max(v, 0.0f));
+        return (T)(std::clamp(v, 0.0f, 1.0f) * (float)std::numeric_limits<T>::max() + 0.5f);
+    }
+}
+
+template<typename S, uint32_t C>
+void vka::detail::texture::mip_filter_box(float* dst, const S* src, VkExtent2D src_extent, VkExtent2D dst_extent, uint32_t row_begin, uint32_t row_end, const MipParams& params) noexcept
+{
+    // For odd extents the last row or column of the source is dropped, the same as a blit does.
+    for (uint32_t y = row_begin; y < row_end; y++)
+    {
+        const uint32_t y0 = std::min(2 * y, src_extent.height - 1);
+        const uint32_t y1 = std::min(2 * y + 1, src_extent.height - 1);
+        for (uint32_t x = 0; x < dst_extent.width; x++)
+        {
+            const uint32_t x0 = std::min(2 * x, src_extent.width - 1);
+            const uint32_t x1 = std::min(2 * x + 1, src_extent.width - 1);
+            const S* const p[4] = {
+                src + ((uint64_t)y0 * src_extent.width + x0) * C,
+                src + ((uint64_t)y0 * src_extent.width + x1) * C,
+                src + ((uint64_t)y1 * src_extent.width + x0) * C,
+                src + ((uint64_t)y1 * src_extent.width + x1) * C
+            };
+            float* const out = dst + ((uint64_t)y * dst_extent.width + x) * C;
+            for (uint32_t c = 0; c < C; c++)
+            {
+                float sum = 0.0f;
+                for (const S* q : p)
+                    sum += decode_component(q[c], c, params);
+                out[c] = 0.25f * sum;
+            }
+        }
+    }
+}
+
+template<typename S, uint32_t C>
+void vka::detail::texture::mip_filter_rows(float* dst, const S* src, VkExtent2D src_extent, uint32_t dst_width, uint32_t row_begin, uint32_t row_end, const float* weights, const MipParams& params) noexcept
+{
+    // A width of 1 cannot be downsampled any further and is only decoded.
+    const int32_t max_x = (int32_t)src_extent.width - 1;
+    for (uint32_t y = row_begin; y < row_end; y++)
+    {
+        const S* const row = src + (uint64_t)y * src_extent.width * C;
+        float* const out = dst + (uint64_t)y * dst_width * C;
+        for (uint32_t x = 0; x < dst_width; x++)
+        {
+            float sum[C] = {};
+            if (src_extent.width == 1)
+            {
+                for (uint32_t c = 0; c < C; c++)
+                    sum[c] = decode_component(row[c], c, params);
+            }
+            else
+            {
+                for (int32_t i = 0; i < 2 * KAISER_RADIUS; i++)
+                {
+                    const int32_t sx = std::clamp(2 * (int32_t)x + i - KAISER_RADIUS + 1, 0, max_x);
+                    for (uint32_t c = 0; c < C; c++)
+                        sum[c] += weights[i] * decode_component(row[sx * C + c], c, params);
+                }
+            }
+            for (uint32_t c = 0; c < C; c++)
+                out[x * C + c] = sum[c];
+        }
+    }
+}
+
+template<uint32_t C>
+void vka::detail::texture::mip_filter_columns(float* dst, const float* src, uint32_t width, uint32_t src_height, uint32_t row_begin, uint32_t row_end, const float* weights) noexcept
+{
+    const int32_t max_y = (int32_t)src_height - 1;
+    for (uint32_t y = row_begin; y < row_end; y++)
+    {
+        float* const out = dst + (uint64_t)y * width * C;
+        if (src_height == 1)
+        {
+            memcpy(out, src, (size_t)width * C * sizeof(float));
+            continue;
+        }
+        std::fill(out, out + (size_t)width * C, 0.0f);
+        for (int32_t i = 0; i < 2 * KAISER_RADIUS; i++)
+        {
+            const int32_t sy = std::clamp(2 * (int32_t)y + i - KAISER_RADIUS + 1, 0, max_y);
+            const float* const row = src + (uint64_t)sy * width * C;
+            for (uint64_t k = 0; k < (uint64_t)width * C; k++)
+                out[k] += weights[i] * row[k];
+        }
+    }
+}
+
+template<typename T, uint32_t C>
+void vka::detail::texture::mip_encode(T* dst, float* src, uint64_t px_count, const MipParams& params) noexcept
+{
     for (uint64_t i = 0; i < px_count; i++)
     {
-        const uint64_t offset_dst = i * max_comp + comp_offset;
-        for (uint32_t c = 0; c < img_comp && c < rem_comp; c++)
-            dst[offset_dst + c] = color[c];
+        float* const px = src + i * C;
+        if constexpr (C >= 3)
+        {
+            if (params.normal_map)
+            {
+                const float length = std::sqrt(px[0] * px[0] + px[1] * px[1] + px[2] * px[2]);
+                const float scale = length > 1e-6f ? 1.0f / length : 0.0f;
+                px[0] *= scale;
+                px[1] *= scale;
+                px[2] *= scale;
+            }
+        }
+        for (uint32_t c = 0; c < C; c++)
+            dst[i * C + c] = encode_component<T>(px[c], c, params);
     }
-}
\ No newline at end of file
+}
@@ -350,7 +350,8 @@ void VkaExample::create_depth_attachment()
 		.imageQueueFamilyIndices = &this->graphics_queue.family_index,
 		.viewFormat = DEPTH_FORMAT,
 		.viewComponentMapping = component_mapping,
-		.viewAspectMask = VK_IMAGE_ASPECT_DEPTH_BIT
+		.viewAspectMask = VK_IMAGE_ASPECT_DEPTH_BIT,
+		.memoryTransient = true
 	};
 	this->depth_attachment = vka::AttachmentImage(this->device, this->memory_properties, ci);
 }